@@ -39,7 +39,7 @@ BookListeners::removeSubscriber(std::uint64_t seq)
 
 void
 BookListeners::publish(
-    Json::Value const& jvObj,
+    InfoSub::Message const& msg,
     hash_set<std::uint64_t>& havePublished)
 {
     std::lock_guard<std::recursive_mutex> sl(mLock);
@@ -51,10 +51,10 @@ BookListeners::publish(
 
         if (p)
         {
-            // Only publish jvObj if this is the first occurence
+            // Only publish msg if this is the first occurence
             if(havePublished.emplace(p->getSeq()).second)
             {
-                p->send(jvObj, true);
+                p->send(msg, true);
             }
             ++it;
         }
@@ -27,9 +27,11 @@
 #include <ripple/app/ledger/PendingSaves.h>
 #include <ripple/app/ledger/TransactionMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/basics/contract.h>
 #include <ripple/basics/Log.h>
 #include <ripple/basics/StringUtilities.h>
@@ -48,8 +50,10 @@
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <boost/optional.hpp>
+#include <array>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -784,6 +788,109 @@ void Ledger::updateSkipList ()
         rawReplace(sle);
 }
 
+namespace {
+
+/** Writes the AccountTransactions rows for saved ledgers.
+
+    The statements are prepared once for the connection, kept by the
+    DatabaseCon, and bound to the members below. Rows are written by
+    setting the bound values and executing a statement again.
+*/
+class AccountTransactionsWriter
+{
+public:
+    struct Row
+    {
+        std::string txnId;
+        std::string account;
+        std::uint32_t ledgerSeq;
+        std::uint32_t txnSeq;
+    };
+
+    explicit
+    AccountTransactionsWriter (soci::session& session)
+        : deleteTxn_ ((session.prepare <<
+            "DELETE FROM AccountTransactions WHERE TransID = :txnId;",
+            soci::use (txnId_)))
+    {
+        for (auto n = maxRows; n != 0; n /= 4)
+            inserts_.emplace_back (session, n, rows_);
+    }
+
+    /** Delete every row for a transaction. */
+    void
+    remove (std::string const& txnId)
+    {
+        txnId_ = txnId;
+        deleteTxn_.execute (true);
+    }
+
+    /** Write rows, using multi-row INSERTs where possible. */
+    void
+    insert (std::vector<Row>& rows)
+    {
+        auto next = rows.begin ();
+        for (auto& insert : inserts_)
+        {
+            while (rows.end () - next >= insert.rows)
+            {
+                std::move (next, next + insert.rows, rows_.begin ());
+                insert.statement.execute (true);
+                next += insert.rows;
+            }
+        }
+    }
+
+private:
+    // The most rows written by a single INSERT.  Four values a row keeps
+    // this well below SQLite's default limit of 999 bound parameters.
+    static std::ptrdiff_t constexpr maxRows = 64;
+
+    struct Insert
+    {
+        std::ptrdiff_t const rows;
+        soci::statement statement;
+
+        Insert (soci::session& session, std::ptrdiff_t n,
+                std::array<Row, maxRows>& rows)
+            : rows (n)
+            , statement (session)
+        {
+            std::string sql (
+                "INSERT INTO AccountTransactions "
+                "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+            for (std::ptrdiff_t i = 0; i < n; ++i)
+            {
+                auto const s = std::to_string (i);
+                if (i != 0)
+                    sql += ", ";
+                sql += "(:txnId" + s + ", :account" + s +
+                    ", :ledgerSeq" + s + ", :txnSeq" + s + ")";
+
+                statement.exchange (soci::use (rows[i].txnId));
+                statement.exchange (soci::use (rows[i].account));
+                statement.exchange (soci::use (rows[i].ledgerSeq));
+                statement.exchange (soci::use (rows[i].txnSeq));
+            }
+            sql += ";";
+
+            statement.alloc ();
+            statement.prepare (sql);
+            statement.define_and_bind ();
+        }
+    };
+
+    std::string txnId_;
+    soci::statement deleteTxn_;
+
+    std::array<Row, maxRows> rows_;
+
+    // Writing 64, 16, 4 and 1 rows.
+    std::vector<Insert> inserts_;
+};
+
+} // namespace
+
 static bool saveValidatedLedger (
     Application& app,
     std::shared_ptr<Ledger const> const& ledger,
@@ -808,8 +915,6 @@ static bool saveValidatedLedger (
         "DELETE FROM Transactions WHERE LedgerSeq = %u;");
     static boost::format deleteTrans2 (
         "DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans (
-        "DELETE FROM AccountTransactions WHERE TransID = '%s';");
 
     if (! ledger->info().accountHash.isNonZero ())
     {
@@ -863,6 +968,9 @@ static bool saveValidatedLedger (
         *db << boost::str (deleteLedger % seq);
     }
 
+    auto const index = app.getAccountTxIndex ();
+    std::vector<AccountTxIndex::Entry> indexEntries;
+
     {
         auto db = app.getTxnDB ().checkoutDb ();
 
@@ -871,7 +979,13 @@ static bool saveValidatedLedger (
         *db << boost::str (deleteTrans1 % seq);
         *db << boost::str (deleteTrans2 % seq);
 
-        std::string const ledgerSeq (std::to_string (seq));
+        auto& writer =
+            app.getTxnDB ().getCached<AccountTransactionsWriter> ();
+
+        // Each account is converted to Base58 once per ledger, however
+        // many of its transactions are indexed.
+        hash_map<AccountID, std::string> accounts;
+        std::vector<AccountTransactionsWriter::Row> rows;
 
         for (auto const& vt : aLedger->getMap ())
         {
@@ -881,46 +995,28 @@ static bool saveValidatedLedger (
                 transactionID, seq);
 
             std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
+            std::uint32_t const txnSeq = vt.second->getTxnSeq ();
 
-            *db << boost::str (deleteAcctTrans % transactionID);
+            writer.remove (txnId);
 
             auto const& accts = vt.second->getAffected ();
 
             if (!accts.empty ())
             {
-                std::string sql (
-                    "INSERT INTO AccountTransactions "
-                    "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
-
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
-
-                bool first = true;
-                for (auto const& account : accts)
+                for (auto const& affected : accts)
                 {
-                    if (!first)
-                        sql += ", ('";
-                    else
+                    auto iter = accounts.find (affected);
+                    if (iter == accounts.end ())
                     {
-                        sql += "('";
-                        first = false;
+                        iter = accounts.emplace (affected,
+                            app.accountIDCache().toBase58 (affected)).first;
                     }
+                    rows.push_back ({txnId, iter->second, seq, txnSeq});
 
-                    sql += txnId;
-                    sql += "','";
-                    sql += app.accountIDCache().toBase58(account);
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
+                    if (index)
+                        indexEntries.push_back (
+                            {affected, txnSeq, transactionID});
                 }
-                sql += ";";
-                JLOG (j.trace()) << "ActTx: " << sql;
-                *db << sql;
             }
             else
             {
@@ -937,9 +1033,46 @@ static bool saveValidatedLedger (
                     seq, vt.second->getEscMeta ()) + ";");
         }
 
+        writer.insert (rows);
+
         tr.commit ();
     }
 
+    if (index)
+    {
+        // The index only refers to transactions, so it is written after
+        // they are committed. A failure costs the index this ledger but
+        // does not fail the save.
+        try
+        {
+            index->insert (seq, indexEntries);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG (j.warn())
+                << "Unable to index ledger " << seq << ": " << e.what ();
+
+            // The index no longer covers this ledger. Move its coverage
+            // past it, so account_tx reads it from the database, and
+            // backfill the ledgers in between.
+            try
+            {
+                for (auto covered = index->coverage ();
+                    covered && *covered <= seq; covered = index->coverage ())
+                {
+                    if (index->updateCoverage (covered, seq + 1))
+                        break;
+                }
+                startAccountTxIndexBackfill (app);
+            }
+            catch (std::exception const& ex)
+            {
+                JLOG (j.error())
+                    << "Unable to update index coverage: " << ex.what ();
+            }
+        }
+    }
+
     {
         static std::string addLedger(
             R"sql(INSERT OR REPLACE INTO Ledgers
@@ -51,6 +51,7 @@ class OpenLedger
 private:
     beast::Journal j_;
     CachedSLEs& cache_;
+    std::mutex mutable accept_mutex_;
     std::mutex mutable modify_mutex_;
     std::mutex mutable current_mutex_;
     std::shared_ptr<OpenView const> current_;
@@ -139,7 +140,11 @@ public:
             depending on the value of `retriesFirst`.
 
             The transactions in the current open view
-            are applied to the new open view.
+            are applied to the new open view. Most of
+            them are applied from a snapshot, while
+            calls to modify can still proceed; only
+            those added since are applied while
+            modify is blocked.
 
             The list of local transactions are applied
             to the new open view.
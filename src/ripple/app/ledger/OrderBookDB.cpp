@@ -24,52 +24,254 @@
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STArray.h>
+#include <algorithm>
 
 namespace ripple {
 
 OrderBookDB::OrderBookDB (Application& app, Stoppable& parent)
     : Stoppable ("OrderBookDB", parent)
     , app_ (app)
+    , mBooks (std::make_shared<Books const> ())
     , mSeq (0)
+    , mUpdating (false)
     , j_ (app.journal ("OrderBookDB"))
 {
 }
 
 void OrderBookDB::invalidate ()
 {
-    std::lock_guard <std::recursive_mutex> sl (mLock);
+    std::lock_guard <std::mutex> sl (mUpdateLock);
     mSeq = 0;
 }
 
+std::shared_ptr<OrderBookDB::Books const>
+OrderBookDB::books () const
+{
+    return std::atomic_load (&mBooks);
+}
+
+void
+OrderBookDB::publish (std::shared_ptr<Books const> books)
+{
+    std::atomic_store (&mBooks, std::move (books));
+}
+
+static
+Book
+bookFromDirectory (STObject const& dir)
+{
+    // Default (zero) fields are left out of the metadata
+    auto const field = [&dir](SField const& f)
+    {
+        return dir.isFieldPresent (f) ? dir.getFieldH160 (f) : uint160 ();
+    };
+
+    Book book;
+    book.in.currency.copyFrom (field (sfTakerPaysCurrency));
+    book.in.account.copyFrom (field (sfTakerPaysIssuer));
+    book.out.account.copyFrom (field (sfTakerGetsIssuer));
+    book.out.currency.copyFrom (field (sfTakerGetsCurrency));
+    return book;
+}
+
+bool
+OrderBookDB::hasBook (Books const& books, Book const& book)
+{
+    auto const it = books.source.find (book.in);
+    if (it == books.source.end ())
+        return false;
+
+    return std::any_of (it->second.begin (), it->second.end (),
+        [&book](OrderBook::pointer const& ob)
+        {
+            return ob->book () == book;
+        });
+}
+
+void
+OrderBookDB::insertBook (Books& books, Book const& book)
+{
+    auto orderBook = std::make_shared<OrderBook> (getBookBase (book), book);
+    books.source[book.in].push_back (orderBook);
+    books.dest[book.out].push_back (orderBook);
+    if (isXRP (book.out))
+        books.xrp.insert (book.in);
+}
+
+void
+OrderBookDB::eraseBook (Books& books, Book const& book)
+{
+    auto const index = getBookBase (book);
+    auto const erase = [&index](IssueToOrderBook& map, Issue const& issue)
+    {
+        auto it = map.find (issue);
+        if (it == map.end ())
+            return;
+
+        auto& list = it->second;
+        list.erase (std::remove_if (list.begin (), list.end (),
+            [&index](OrderBook::pointer const& ob)
+            {
+                return ob->getBookBase () == index;
+            }), list.end ());
+
+        if (list.empty ())
+            map.erase (it);
+    };
+
+    erase (books.source, book.in);
+    erase (books.dest, book.out);
+
+    if (isXRP (book.out))
+    {
+        auto it = books.source.find (book.in);
+        if (it == books.source.end () ||
+            std::none_of (it->second.begin (), it->second.end (),
+                [](OrderBook::pointer const& ob)
+                {
+                    return isXRP (ob->getCurrencyOut ());
+                }))
+        {
+            books.xrp.erase (book.in);
+        }
+    }
+}
+
+// Add the books whose first quality directory this ledger created, and
+// remove the books whose last quality directory it deleted.
+bool
+OrderBookDB::applyDeltas (ReadView const& ledger)
+{
+    // Copied from the current snapshot on the first change
+    std::shared_ptr<Books> next;
+
+    for (auto const& tx : ledger.txs)
+    {
+        if (! tx.second)
+            continue;
+
+        for (auto const& node : tx.second->getFieldArray (sfAffectedNodes))
+        {
+            if (node.getFieldU16 (sfLedgerEntryType) != ltDIR_NODE)
+                continue;
+
+            bool const created = node.getFName () == sfCreatedNode;
+            if (! created && node.getFName () != sfDeletedNode)
+                continue;
+
+            auto const data = dynamic_cast<STObject const*> (
+                node.peekAtPField (created ? sfNewFields : sfFinalFields));
+
+            // Only the root page of a directory in an order book
+            if (! data ||
+                ! data->isFieldPresent (sfExchangeRate) ||
+                ! data->isFieldPresent (sfRootIndex) ||
+                data->getFieldH256 (sfRootIndex) !=
+                    node.getFieldH256 (sfLedgerIndex))
+                continue;
+
+            auto const book = bookFromDirectory (*data);
+            auto const index = getBookBase (book);
+
+            if (created)
+            {
+                if (++mDirCount[index] != 1)
+                    continue;
+            }
+            else
+            {
+                auto it = mDirCount.find (index);
+                if (it == mDirCount.end () || --it->second != 0)
+                    continue;
+                mDirCount.erase (it);
+            }
+
+            if (! next)
+                next = std::make_shared<Books> (*books ());
+
+            if (! created)
+                eraseBook (*next, book);
+            else if (! hasBook (*next, book))
+                insertBook (*next, book);
+        }
+    }
+
+    if (! next)
+        return false;
+
+    publish (std::move (next));
+    return true;
+}
+
 void OrderBookDB::setup(
     std::shared_ptr<ReadView const> const& ledger)
 {
     {
-        std::lock_guard <std::recursive_mutex> sl (mLock);
+        std::lock_guard <std::mutex> sl (mUpdateLock);
         auto seq = ledger->info().seq;
 
-        // Do a full update every 256 ledgers
         if (mSeq != 0)
         {
             if (seq == mSeq)
                 return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
-                return;
-            if ((seq < mSeq) && ((mSeq - seq) < 16))
-                return;
+
+            // Follow the ledger stream from the transaction metadata
+            if ((seq == mSeq + 1) && ! ledger->open ())
+            {
+                mSeq = seq;
+
+                if (app_.config().PATH_SEARCH_MAX == 0)
+                    return;
+
+                if (mUpdating)
+                    mPending.push_back (ledger);
+                else if (applyDeltas (*ledger))
+                    JLOG (j_.debug()) << "Books changed in " << seq;
+
+                // Periodically rescan in full, to drop books which were
+                // added from offers that never made it into a ledger.
+                if (seq < mFullSeq + fullUpdateInterval)
+                    return;
+            }
+            else
+            {
+                // Do a full update after a large jump
+                if ((seq > mSeq) && ((seq - mSeq) < 256))
+                    return;
+                if ((seq < mSeq) && ((mSeq - seq) < 16))
+                    return;
+            }
         }
 
         JLOG (j_.debug())
             << "Advancing from " << mSeq << " to " << seq;
 
         mSeq = seq;
-    }
 
-    if (app_.config().PATH_SEARCH_MAX == 0)
-    {
-        // nothing to do
+        if (app_.config().PATH_SEARCH_MAX == 0)
+            return;
+
+        // Only one full update runs at a time. The running one would
+        // otherwise publish over this one, or replay ledgers onto it.
+        mFullSeq = seq;
+        if (mUpdating)
+        {
+            mRescan = ledger;
+            return;
+        }
+
+        mUpdating = true;
+        mPending.clear ();
     }
-    else if (app_.config().standalone())
+
+    startUpdate (ledger);
+}
+
+void OrderBookDB::startUpdate(
+    std::shared_ptr<ReadView const> const& ledger)
+{
+    if (app_.config().standalone())
         update(ledger);
     else
         app_.getJobQueue().addJob(
@@ -80,10 +282,8 @@ void OrderBookDB::setup(
 void OrderBookDB::update(
     std::shared_ptr<ReadView const> const& ledger)
 {
-    hash_set< uint256 > seen;
-    OrderBookDB::IssueToOrderBook destMap;
-    OrderBookDB::IssueToOrderBook sourceMap;
-    hash_set< Issue > XRPBooks;
+    hash_map< uint256, int > dirCount;
+    auto next = std::make_shared<Books> ();
 
     JLOG (j_.debug()) << "OrderBookDB::update>";
 
@@ -93,6 +293,15 @@ void OrderBookDB::update(
         return;
     }
 
+    auto const abandon = [this]
+    {
+        std::lock_guard <std::mutex> sl (mUpdateLock);
+        mSeq = 0;
+        mUpdating = false;
+        mPending.clear ();
+        mRescan.reset ();
+    };
+
     // walk through the entire ledger looking for orderbook entries
     int books = 0;
 
@@ -104,8 +313,7 @@ void OrderBookDB::update(
             {
                 JLOG (j_.info())
                     << "OrderBookDB::update exiting due to isStopping";
-                std::lock_guard <std::recursive_mutex> sl (mLock);
-                mSeq = 0;
+                abandon ();
                 return;
             }
 
@@ -113,24 +321,11 @@ void OrderBookDB::update(
                 sle->isFieldPresent (sfExchangeRate) &&
                 sle->getFieldH256 (sfRootIndex) == sle->key())
             {
-                Book book;
-                book.in.currency.copyFrom(sle->getFieldH160(
-                    sfTakerPaysCurrency));
-                book.in.account.copyFrom(sle->getFieldH160 (
-                    sfTakerPaysIssuer));
-                book.out.account.copyFrom(sle->getFieldH160(
-                    sfTakerGetsIssuer));
-                book.out.currency.copyFrom (sle->getFieldH160(
-                    sfTakerGetsCurrency));
-
-                uint256 index = getBookBase (book);
-                if (seen.insert (index).second)
+                auto const book = bookFromDirectory (*sle);
+
+                if (++dirCount[getBookBase (book)] == 1)
                 {
-                    auto orderBook = std::make_shared<OrderBook> (index, book);
-                    sourceMap[book.in].push_back (orderBook);
-                    destMap[book.out].push_back (orderBook);
-                    if (isXRP(book.out))
-                        XRPBooks.insert(book.in);
+                    insertBook (*next, book);
                     ++books;
                 }
             }
@@ -140,76 +335,115 @@ void OrderBookDB::update(
     {
         JLOG (j_.info())
             << "OrderBookDB::update encountered a missing node";
-        std::lock_guard <std::recursive_mutex> sl (mLock);
-        mSeq = 0;
+        abandon ();
         return;
     }
 
     JLOG (j_.debug())
         << "OrderBookDB::update< " << books << " books found";
+
+    std::shared_ptr<ReadView const> rescan;
     {
-        std::lock_guard <std::recursive_mutex> sl (mLock);
+        std::lock_guard <std::mutex> sl (mUpdateLock);
 
-        mXRPBooks.swap(XRPBooks);
-        mSourceMap.swap(sourceMap);
-        mDestMap.swap(destMap);
+        mDirCount.swap (dirCount);
+        publish (std::move (next));
+
+        // Catch up with the ledgers published since this one
+        auto seq = ledger->info().seq;
+        for (auto const& pending : mPending)
+        {
+            if (pending->info().seq == seq + 1)
+            {
+                applyDeltas (*pending);
+                ++seq;
+            }
+        }
+
+        // A full update was requested while this one ran. Keep the
+        // ledgers which follow it, so they can be replayed onto it.
+        rescan = std::move (mRescan);
+        mRescan.reset ();
+        if (rescan)
+        {
+            auto const base = rescan->info().seq;
+            mPending.erase (std::remove_if (
+                mPending.begin (), mPending.end (),
+                [base](std::shared_ptr<ReadView const> const& pending)
+                {
+                    return pending->info().seq <= base;
+                }), mPending.end ());
+        }
+        else
+        {
+            mPending.clear ();
+            mUpdating = false;
+        }
     }
     app_.getLedgerMaster().newOrderBookDB();
+
+    if (rescan)
+        startUpdate (rescan);
 }
 
 void OrderBookDB::addOrderBook(Book const& book)
 {
     bool toXRP = isXRP (book.out);
-    std::lock_guard <std::recursive_mutex> sl (mLock);
+    std::lock_guard <std::mutex> sl (mUpdateLock);
+    auto const current = books ();
 
     if (toXRP)
     {
         // We don't want to search through all the to-XRP or from-XRP order
         // books!
-        for (auto ob: mSourceMap[book.in])
+        auto it = current->source.find (book.in);
+        if (it != current->source.end ())
         {
-            if (isXRP (ob->getCurrencyOut ())) // also to XRP
-                return;
+            for (auto const& ob : it->second)
+            {
+                if (isXRP (ob->getCurrencyOut ())) // also to XRP
+                    return;
+            }
         }
     }
     else
     {
-        for (auto ob: mDestMap[book.out])
+        auto it = current->dest.find (book.out);
+        if (it != current->dest.end ())
         {
-            if (ob->getCurrencyIn() == book.in.currency &&
-                ob->getIssuerIn() == book.in.account)
+            for (auto const& ob : it->second)
             {
-                return;
+                if (ob->getCurrencyIn() == book.in.currency &&
+                    ob->getIssuerIn() == book.in.account)
+                {
+                    return;
+                }
             }
         }
     }
-    uint256 index = getBookBase(book);
-    auto orderBook = std::make_shared<OrderBook> (index, book);
 
-    mSourceMap[book.in].push_back (orderBook);
-    mDestMap[book.out].push_back (orderBook);
-    if (toXRP)
-        mXRPBooks.insert(book.in);
+    auto next = std::make_shared<Books> (*current);
+    insertBook (*next, book);
+    publish (std::move (next));
 }
 
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List OrderBookDB::getBooksByTakerPays (Issue const& issue)
 {
-    std::lock_guard <std::recursive_mutex> sl (mLock);
-    auto it = mSourceMap.find (issue);
-    return it == mSourceMap.end () ? OrderBook::List() : it->second;
+    auto const current = books ();
+    auto it = current->source.find (issue);
+    return it == current->source.end () ? OrderBook::List() : it->second;
 }
 
 int OrderBookDB::getBookSize(Issue const& issue) {
-    std::lock_guard <std::recursive_mutex> sl (mLock);
-    auto it = mSourceMap.find (issue);
-    return it == mSourceMap.end () ? 0 : it->second.size();
+    auto const current = books ();
+    auto it = current->source.find (issue);
+    return it == current->source.end () ? 0 : it->second.size();
 }
 
 bool OrderBookDB::isBookToXRP(Issue const& issue)
 {
-    std::lock_guard <std::recursive_mutex> sl (mLock);
-    return mXRPBooks.count(issue) > 0;
+    return books ()->xrp.count(issue) > 0;
 }
 
 BookListeners::pointer OrderBookDB::makeBookListeners (Book const& book)
@@ -244,7 +478,7 @@ BookListeners::pointer OrderBookDB::getBookListeners (Book const& book)
 // We need to determine which streams a given meta effects.
 void OrderBookDB::processTxn (
     std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj)
+        const AcceptedLedgerTx& alTx, InfoSub::Message const& msg)
 {
     std::lock_guard <std::recursive_mutex> sl (mLock);
     if (alTx.getResult () == tesSUCCESS)
@@ -292,7 +526,7 @@ void OrderBookDB::processTxn (
                             auto listeners = getBookListeners(b);
                             if (listeners)
                             {
-                                listeners->publish(jvObj, havePublished);
+                                listeners->publish(msg, havePublished);
                             }
                         }
                     }
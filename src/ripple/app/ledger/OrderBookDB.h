@@ -24,7 +24,9 @@
 #include <ripple/app/ledger/BookListeners.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/OrderBook.h>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ripple {
 
@@ -32,8 +34,19 @@ class OrderBookDB
     : public Stoppable
 {
 public:
+    /** The number of ledgers between full scans of the ledger. */
+    static std::uint32_t constexpr fullUpdateInterval = 256;
+
     OrderBookDB (Application& app, Stoppable& parent);
 
+    /** Bring the order books up to date with a newly published ledger.
+
+        If the ledger directly follows the last one seen, only the books
+        that its transactions created or emptied are added or removed.
+        Otherwise, and every fullUpdateInterval ledgers, the whole ledger
+        is scanned, in the background unless we are standalone. A scan
+        requested while another is running starts once it finishes.
+    */
     void setup (std::shared_ptr<ReadView const> const& ledger);
     void update (std::shared_ptr<ReadView const> const& ledger);
     void invalidate ();
@@ -56,23 +69,60 @@ public:
     // see if this txn effects any orderbook
     void processTxn (
         std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj);
+        const AcceptedLedgerTx& alTx, InfoSub::Message const& msg);
 
     using IssueToOrderBook = hash_map <Issue, OrderBook::List>;
 
 private:
-    void rawAddBook(Book const&);
+    // An immutable snapshot of the known order books. Readers load the
+    // current one without blocking; changes publish a modified copy.
+    struct Books
+    {
+        // by ci/ii
+        IssueToOrderBook source;
+
+        // by co/io
+        IssueToOrderBook dest;
+
+        // does an order book to XRP exist
+        hash_set <Issue> xrp;
+    };
+
+    std::shared_ptr<Books const> books () const;
+
+    // Scan the ledger in full, with mUpdating set
+    void startUpdate (std::shared_ptr<ReadView const> const& ledger);
+
+    // Called with mUpdateLock held
+    void publish (std::shared_ptr<Books const> books);
+    bool applyDeltas (ReadView const& ledger);
+
+    static bool hasBook (Books const& books, Book const& book);
+    static void insertBook (Books& books, Book const& book);
+    static void eraseBook (Books& books, Book const& book);
 
     Application& app_;
 
-    // by ci/ii
-    IssueToOrderBook mSourceMap;
+    // Only use through books() and publish()
+    std::shared_ptr<Books const> mBooks;
 
-    // by co/io
-    IssueToOrderBook mDestMap;
+    // Serializes changes to the books
+    std::mutex mUpdateLock;
 
-    // does an order book to XRP exist
-    hash_set <Issue> mXRPBooks;
+    // Number of quality directories in each book, by book base
+    hash_map <uint256, int> mDirCount;
+
+    std::uint32_t mSeq;
+
+    // The ledger last scanned in full
+    std::uint32_t mFullSeq = 0;
+
+    // Ledgers published while a full update was running
+    bool mUpdating;
+    std::vector <std::shared_ptr<ReadView const>> mPending;
+
+    // A full update requested while another was running
+    std::shared_ptr<ReadView const> mRescan;
 
     std::recursive_mutex mLock;
 
@@ -80,8 +130,6 @@ private:
 
     BookToListenersMap mListeners;
 
-    std::uint32_t mSeq;
-
     beast::Journal j_;
 };
 
@@ -24,7 +24,16 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/app/tx/applySteps.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Feature.h>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -70,9 +79,9 @@ buildLedgerImpl(
         // nodes to the node store to preserve the new LCL
 
         int const asf = buildLCL->stateMap().flushDirty(
-            hotACCOUNT_NODE, buildLCL->info().seq);
+            hotACCOUNT_NODE, buildLCL->info().seq, app.getJobQueue());
         int const tmf = buildLCL->txMap().flushDirty(
-            hotTRANSACTION_NODE, buildLCL->info().seq);
+            hotTRANSACTION_NODE, buildLCL->info().seq, app.getJobQueue());
         JLOG(j.debug()) << "Flushed " << asf << " accounts and " << tmf
                         << " transaction nodes";
     }
@@ -85,6 +94,89 @@ buildLedgerImpl(
     return buildLCL;
 }
 
+namespace detail {
+
+/** Run `preflight` on a set of transactions using the job queue.
+
+    `preflight` only depends on the transaction, the rules and the flags,
+    so its results are the same whichever thread computes them. Running
+    it ahead of time lets the signature and static checks of the whole
+    set proceed in parallel, while the transactions are still applied to
+    the ledger one at a time, in canonical order. The calling thread
+    takes part in the work, so this completes even if no job queue
+    thread is free.
+
+    @return The preflight results, in the same order as `txs`
+*/
+std::vector<boost::optional<PreflightResult>>
+preflightTransactions(
+    Application& app,
+    OpenView const& view,
+    std::vector<STTx const*> const& txs,
+    ApplyFlags flags,
+    beast::Journal j)
+{
+    // Below this, the cost of scheduling helpers outweighs the gain
+    std::size_t constexpr minPerHelper = 16;
+
+    std::vector<boost::optional<PreflightResult>> results(txs.size());
+
+    // Helpers may start after all the work is done and the caller has
+    // returned, so only the shared state may be touched until an item
+    // has been claimed.
+    struct State
+    {
+        explicit State(std::size_t total) : total(total)
+        {
+        }
+
+        std::size_t const total;
+        std::atomic<std::size_t> next{0};
+        std::size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto const state = std::make_shared<State>(txs.size());
+    auto const rules = view.rules();
+    auto const parentCloseTime = view.info().parentCloseTime;
+
+    auto const work =
+        [&app, &txs, &results, &rules, flags, j, parentCloseTime, state] {
+            STAmountSO saved(parentCloseTime);
+            std::size_t count = 0;
+            for (auto i = state->next++; i < state->total; i = state->next++)
+            {
+                results[i].emplace(preflight(app, rules, *txs[i], flags, j));
+                ++count;
+            }
+            if (count != 0)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done += count;
+                if (state->done == state->total)
+                    state->cv.notify_all();
+            }
+        };
+
+    auto const helpers = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()) - 1,
+        txs.size() / minPerHelper);
+
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        app.getJobQueue().addJob(
+            jtACCEPT, "preflightTransactions", [work](Job&) { work(); });
+    }
+
+    work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->done == state->total; });
+    return results;
+}
+
+}  // namespace detail
+
 /** Apply a set of consensus transactions to a ledger.
 
   @param app Handle to application
@@ -132,14 +224,26 @@ applyTransactions(
                         << (certainRetry ? " retriable" : " final");
         int changes = 0;
 
+        // Check the whole pass up front. The transactions are then
+        // applied in order, and the pass only ever erases the
+        // transaction it is visiting, so the results stay in step.
+        std::vector<STTx const*> txs;
+        txs.reserve(retriableTxs.size());
+        for (auto const& tx : retriableTxs)
+            txs.push_back(tx.second.get());
+        auto const preflights = detail::preflightTransactions(
+            app, view, txs, certainRetry ? tapRETRY : tapNONE, j);
+
         auto it = retriableTxs.begin();
+        std::size_t index = 0;
 
         while (it != retriableTxs.end())
         {
+            auto const& pfresult = preflights[index++];
+            assert(&pfresult->tx == it->second.get());
             try
             {
-                switch (applyTransaction(
-                    app, view, *it->second, certainRetry, tapNONE, j))
+                switch (applyTransaction(app, view, *pfresult, j))
                 {
                     case ApplyResult::Success:
                         it = retriableTxs.erase(it);
@@ -253,6 +253,18 @@ void addJson (Json::Value& json, LedgerFill const& fill)
         fillJsonQueue(json, fill);
 }
 
+void addJson (Json::Object& json, LedgerFill const& fill)
+{
+    {
+        // The ledger must be finished before the queue can be written
+        auto&& object = Json::addObject (json, jss::ledger);
+        fillJson (object, fill);
+    }
+
+    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
+        fillJsonQueue(json, fill);
+}
+
 Json::Value getJson (LedgerFill const& fill)
 {
     Json::Value json;
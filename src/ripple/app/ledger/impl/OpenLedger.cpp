@@ -22,6 +22,7 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/tx/apply.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/ledger/CachedView.h>
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/Overlay.h>
@@ -84,8 +85,15 @@ OpenLedger::accept(Application& app, Rules const& rules,
                 std::string const& suffix,
                     modify_type const& f)
 {
+    using namespace std::chrono;
+    auto const start = steady_clock::now();
+
     JLOG(j_.trace()) <<
         "accept ledger " << ledger->seq() << " " << suffix;
+    // Only one accept at a time, since most of
+    // the work is done without holding modify_mutex_.
+    std::lock_guard<
+        std::mutex> lock0(accept_mutex_);
     auto next = create(rules, ledger);
     std::map<uint256, bool> shouldRecover;
     if (retriesFirst)
@@ -102,17 +110,17 @@ OpenLedger::accept(Application& app, Rules const& rules,
         apply (app, *next, *ledger, empty{},
             retries, flags, shouldRecover, j_);
     }
-    // Block calls to modify, otherwise
-    // new tx going into the open ledger
-    // would get lost.
-    std::lock_guard<
-        std::mutex> lock1(modify_mutex_);
-    // Apply tx from the current open view
-    if (! current_->txs.empty())
+    // Apply the tx of an open view, skipping
+    // any that are also in `skip`.
+    auto const applyOpen = [&](
+        OpenView const& view, OpenView const* skip)
     {
-        for (auto const& tx : current_->txs)
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (auto const& tx : view.txs)
         {
             auto const txID = tx.first->getTransactionID();
+            if (skip && skip->txExists(txID))
+                continue;
             auto iter = shouldRecover.lower_bound(txID);
             if (iter != shouldRecover.end()
                 && iter->first == txID)
@@ -121,18 +129,25 @@ OpenLedger::accept(Application& app, Rules const& rules,
             else
                 shouldRecover.emplace_hint(iter, txID,
                     app.getHashRouter().shouldRecover(txID));
+            txs.push_back(tx.first);
         }
-        apply (app, *next, *ledger,
-            boost::adaptors::transform(
-                current_->txs,
-            [](std::pair<std::shared_ptr<
-                STTx const>, std::shared_ptr<
-                    STObject const>> const& p)
-            {
-                return p.first;
-            }),
+        if (! txs.empty())
+            apply (app, *next, *ledger, txs,
                 retries, flags, shouldRecover, j_);
-    }
+    };
+    // Apply tx from a snapshot of the current open
+    // view, without blocking calls to modify.
+    auto const snapshot = current();
+    applyOpen(*snapshot, nullptr);
+    // Block calls to modify, otherwise
+    // new tx going into the open ledger
+    // would get lost.
+    std::unique_lock<
+        std::mutex> lock1(modify_mutex_);
+    auto const locked = steady_clock::now();
+    // Apply tx added to the open view since the snapshot
+    if (current_ != snapshot)
+        applyOpen(*current_, snapshot.get());
     // Call the modifier
     if (f)
         f(*next, j_);
@@ -141,6 +156,15 @@ OpenLedger::accept(Application& app, Rules const& rules,
         app.getTxQ().apply(app, *next,
             item.second, flags, j_);
 
+    // Switch to the new open view
+    {
+        std::lock_guard<
+            std::mutex> lock2(current_mutex_);
+        current_ = next;
+    }
+    lock1.unlock();
+    auto const finished = steady_clock::now();
+
     // If we didn't relay this transaction recently, relay it to all peers
     for (auto const& txpair : next->txs)
     {
@@ -163,10 +187,9 @@ OpenLedger::accept(Application& app, Rules const& rules,
         }
     }
 
-    // Switch to the new open view
-    std::lock_guard<
-        std::mutex> lock2(current_mutex_);
-    current_ = std::move(next);
+    app.getPerfLog().openLedgerAccept(
+        duration_cast<microseconds>(finished - start),
+        duration_cast<microseconds>(finished - locked));
 }
 
 //------------------------------------------------------------------------------
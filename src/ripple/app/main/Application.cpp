@@ -34,6 +34,8 @@
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/main/NodeIdentity.h>
 #include <ripple/app/main/NodeStoreScheduler.h>
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
 #include <ripple/app/misc/AmendmentTable.h>
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
@@ -366,6 +368,7 @@ public:
     std::unique_ptr <DatabaseCon> mTxnDB;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
+    std::unique_ptr <AccountTxIndex> accountTxIndex_;
     std::unique_ptr <Overlay> m_overlay;
     std::vector <std::unique_ptr<Stoppable>> websocketServers_;
 
@@ -812,6 +815,10 @@ public:
         assert (mLedgerDB.get() != nullptr);
         return *mLedgerDB;
     }
+    AccountTxIndex* getAccountTxIndex () override
+    {
+        return accountTxIndex_.get();
+    }
     DatabaseCon& getWalletDB () override
     {
         assert (mWalletDB.get() != nullptr);
@@ -1207,6 +1214,22 @@ bool ApplicationImp::setup()
     mTxnDB->setupCheckpointing (m_jobQueue.get(), logs());
     mLedgerDB->setupCheckpointing (m_jobQueue.get(), logs());
 
+    if (config_->exists ("account_tx_index"))
+    {
+        try
+        {
+            accountTxIndex_ = make_AccountTxIndex (
+                config_->section ("account_tx_index"),
+                logs_->journal ("AccountTxIndex"));
+            initAccountTxIndexCoverage (getTxnDB (), *accountTxIndex_);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(m_journal.fatal()) << e.what ();
+            return false;
+        }
+    }
+
     if (!updateTables ())
         return false;
 
@@ -1476,6 +1499,9 @@ ApplicationImp::doStart(bool withTimers)
     startTimers_ = withTimers;
     prepare ();
     start ();
+
+    if (accountTxIndex_)
+        startAccountTxIndexBackfill (*this);
 }
 
 void
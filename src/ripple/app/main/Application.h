@@ -38,6 +38,7 @@ namespace NodeStore { class Database; class DatabaseShard; }
 namespace perf { class PerfLog; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
+class AccountTxIndex;
 class AmendmentTable;
 class CachedSLEs;
 class CollectorManager;
@@ -173,6 +174,9 @@ public:
     virtual DatabaseCon&            getTxnDB () = 0;
     virtual DatabaseCon&            getLedgerDB () = 0;
 
+    /** Retrieve the account transaction index, if one is configured */
+    virtual AccountTxIndex*         getAccountTxIndex () = 0;
+
     virtual
     std::chrono::milliseconds
     getIOLatency () = 0;
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+#define RIPPLE_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/AccountID.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** An ordered index of the transactions which affected each account.
+
+    Entries are ordered by account, then ledger sequence, then the
+    transaction's sequence within its ledger. An account's history can be
+    walked in either direction from any point without scanning the
+    AccountTransactions table in the transaction database.
+
+    The index is filled in as validated ledgers are saved. It only maps
+    to transaction IDs; the transactions themselves are still read from
+    the transaction database.
+
+    Ledgers saved before the index was enabled are not in it. The index
+    records the first ledger from which it is complete, and ledgers
+    before that are read from the AccountTransactions table until they
+    have been backfilled.
+*/
+class AccountTxIndex
+{
+public:
+    /** A transaction which affected an account. */
+    struct Entry
+    {
+        AccountID account;
+        std::uint32_t txnSeq;
+        uint256 txID;
+    };
+
+    /** A position in an account's history: (ledger sequence, txnSeq). */
+    using Cursor = std::pair<std::uint32_t, std::uint32_t>;
+
+    /** Called for each transaction visited.
+        Returns `false` to stop the walk.
+    */
+    using Visitor = std::function<bool (
+        std::uint32_t ledgerSeq, std::uint32_t txnSeq, uint256 const& txID)>;
+
+    virtual ~AccountTxIndex () = default;
+
+    /** Replace all of the entries for a ledger. */
+    virtual
+    void
+    insert (std::uint32_t ledgerSeq, std::vector<Entry> const& entries) = 0;
+
+    /** Remove the entries of all ledgers before the given one. */
+    virtual
+    void
+    clearPrior (std::uint32_t ledgerSeq) = 0;
+
+    /** Return the first ledger from which the index is complete.
+
+        Every ledger at or after this one which is in the transaction
+        database has its entries in the index. Returns `boost::none` if
+        the coverage was never recorded.
+    */
+    virtual
+    boost::optional<std::uint32_t>
+    coverage () = 0;
+
+    /** Record the first ledger from which the index is complete.
+
+        The change is only made if the coverage is still `expected`, so
+        concurrent updates can not undo each other.
+
+        @return `true` if the coverage was changed.
+    */
+    virtual
+    bool
+    updateCoverage (boost::optional<std::uint32_t> const& expected,
+        std::uint32_t ledgerSeq) = 0;
+
+    /** Walk an account's transactions in order.
+
+        @param account The account whose history is walked.
+        @param minLedger The first ledger to visit, inclusive.
+        @param maxLedger The last ledger to visit, inclusive.
+        @param start If set, the position to resume from, inclusive.
+        @param forward `true` to visit oldest first, else newest first.
+        @param visit Called with each transaction, in order.
+    */
+    virtual
+    void
+    forEach (AccountID const& account,
+        std::uint32_t minLedger, std::uint32_t maxLedger,
+        boost::optional<Cursor> const& start, bool forward,
+        Visitor const& visit) = 0;
+};
+
+/** Create an AccountTxIndex from the [account_tx_index] section.
+
+    The `type` key selects the backend: `memory` or, where available,
+    `rocksdb`, which also requires a `path`.
+*/
+std::unique_ptr<AccountTxIndex>
+make_AccountTxIndex (Section const& section, beast::Journal journal);
+
+} // ripple
+
+#endif
@@ -22,48 +22,147 @@
 namespace ripple {
 
 auto
-HashRouter::emplace (uint256 const& key)
+HashRouter::find (std::vector<Slot>& slots, std::size_t hash,
+    uint256 const& key) -> Slot&
+{
+    auto const mask = slots.size () - 1;
+
+    for (auto i = (hash >> partitionBits) & mask;; i = (i + 1) & mask)
+    {
+        auto& slot = slots[i];
+        if (! slot.entry || (slot.hash == hash && slot.key == key))
+            return slot;
+    }
+}
+
+void
+HashRouter::rebuild (Partition& p, std::size_t capacity,
+    Stopwatch::time_point expired)
+{
+    std::vector<Slot> slots (capacity);
+    std::size_t size = 0;
+    auto oldest = Stopwatch::time_point::max ();
+
+    for (auto& slot : p.slots)
+    {
+        if (! slot.entry || slot.touched <= expired)
+            continue;
+
+        auto& s = find (slots, slot.hash, slot.key);
+        s.hash = slot.hash;
+        s.key = slot.key;
+        s.touched = slot.touched;
+        s.entry = std::move (slot.entry);
+        oldest = std::min (oldest, slot.touched);
+        ++size;
+    }
+
+    p.slots = std::move (slots);
+    p.size = size;
+    p.oldest = oldest;
+}
+
+void
+HashRouter::sweep (Partition& p, Stopwatch::time_point expired)
+{
+    if (p.size == 0 || p.oldest > expired)
+        return;
+
+    std::size_t live = 0;
+    for (auto const& slot : p.slots)
+    {
+        if (slot.entry && slot.touched > expired)
+            ++live;
+    }
+
+    // Shrink the table if most of it was expired
+    auto capacity = p.slots.size ();
+    while (capacity > minCapacity && live * 8 < capacity)
+        capacity /= 2;
+
+    rebuild (p, capacity, expired);
+}
+
+auto
+HashRouter::emplace (Partition& p, std::size_t hash, uint256 const& key)
     -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find (key);
+    auto const now = clock_.now ();
+
+    // Apply any expiration triggered by insertions into other partitions
+    Stopwatch::time_point const last {
+        Stopwatch::duration {lastInsert_.load ()}};
+    if (p.swept < last)
+    {
+        sweep (p, last - holdTime_);
+        p.swept = last;
+    }
 
-    if (iter != suppressionMap_.end ())
+    auto& slot = find (p.slots, hash, key);
+
+    if (slot.entry)
     {
-        suppressionMap_.touch(iter);
+        slot.touched = now;
         return std::make_pair(
-            std::ref(iter->second), false);
+            std::ref(*slot.entry), false);
     }
 
     // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    auto expected = lastInsert_.load ();
+    while (expected < now.time_since_epoch ().count () &&
+        ! lastInsert_.compare_exchange_weak (
+            expected, now.time_since_epoch ().count ()))
+    {
+    }
+
+    if (p.swept < now)
+    {
+        sweep (p, now - holdTime_);
+        p.swept = now;
+    }
+
+    // Keep the load factor below 3/4
+    if ((p.size + 1) * 4 > p.slots.size () * 3)
+        rebuild (p, p.slots.size () * 2, Stopwatch::time_point::min ());
+
+    auto& s = find (p.slots, hash, key);
+    s.hash = hash;
+    s.key = key;
+    s.touched = now;
+    s.entry.emplace ();
+    p.oldest = (++p.size == 1) ? now : std::min (p.oldest, now);
 
-    return std::make_pair(std::ref(
-        suppressionMap_.emplace (
-            key, Entry ()).first->second),
-                true);
+    return std::make_pair(
+        std::ref(*s.entry), true);
 }
 
 void HashRouter::addSuppression (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    emplace (key);
+    emplace (p, hash, key);
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace (p, hash, key);
     result.first.addPeer(peer);
     return result.second;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace (p, hash, key);
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -73,29 +172,35 @@ bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int&
 bool HashRouter::shouldProcess (uint256 const& key, PeerShortID peer,
     int& flags, std::chrono::seconds tx_interval)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace (p, hash, key);
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
-    return s.shouldProcess (suppressionMap_.clock().now(), tx_interval);
+    return s.shouldProcess (clock_.now(), tx_interval);
 }
 
 int HashRouter::getFlags (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    return emplace(key).first.getFlags ();
+    return emplace (p, hash, key).first.getFlags ();
 }
 
 bool HashRouter::setFlags (uint256 const& key, int flags)
 {
     assert (flags != 0);
 
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace (p, hash, key).first;
 
     if ((s.getFlags () & flags) == flags)
         return false;
@@ -108,11 +213,13 @@ auto
 HashRouter::shouldRelay (uint256 const& key)
     -> boost::optional<std::set<PeerShortID>>
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace (p, hash, key).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(clock_.now(), holdTime_))
         return boost::none;
 
     return s.releasePeerSet();
@@ -121,9 +228,11 @@ HashRouter::shouldRelay (uint256 const& key)
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock(mutex_);
+    auto const hash = hash_ (key);
+    auto& p = partition (hash);
+    std::lock_guard <std::mutex> lock (p.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace (p, hash, key).first;
 
     return s.shouldRecover(recoverLimit_);
 }
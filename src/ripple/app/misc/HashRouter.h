@@ -24,8 +24,14 @@
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/UnorderedContainers.h>
-#include <ripple/beast/container/aged_unordered_map.h>
+#include <boost/container/small_vector.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
 
 namespace ripple {
 
@@ -49,6 +55,18 @@ namespace ripple {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into independently locked partitions selected by the
+    hash of the key. Each partition is an open-addressing hash table with
+    linear probing, so entries live inline in a single array instead of
+    being allocated one node at a time.
+
+    An entry expires once it has not been accessed for the hold time. As
+    with an aged container, expiration is triggered by inserting a new
+    hash: the insertion records the time, and every partition applies the
+    most recent expiration time the next time it is accessed. A partition
+    is only swept when its oldest entry could have expired, which happens
+    at most once per tick of the clock.
 */
 class HashRouter
 {
@@ -70,8 +88,9 @@ private:
 
         void addPeer (PeerShortID peer)
         {
-            if (peer != 0)
-                peers_.insert (peer);
+            if (peer != 0 &&
+                std::find (peers_.begin(), peers_.end(), peer) == peers_.end())
+                peers_.push_back (peer);
         }
 
         int getFlags (void) const
@@ -87,7 +106,9 @@ private:
         /** Return set of peers we've relayed to and reset tracking */
         std::set<PeerShortID> releasePeerSet()
         {
-            return std::move(peers_);
+            std::set<PeerShortID> result (peers_.begin(), peers_.end());
+            peers_.clear();
+            return result;
         }
 
         /** Determines if this item should be relayed.
@@ -128,7 +149,9 @@ private:
 
     private:
         int flags_ = 0;
-        std::set <PeerShortID> peers_;
+        // Most hashes are only received from a few peers, so keep those
+        // inline and only allocate for larger sets.
+        boost::container::small_vector <PeerShortID, 6> peers_;
         // This could be generalized to a map, if more
         // than one flag needs to expire independently.
         boost::optional<Stopwatch::time_point> relayed_;
@@ -136,6 +159,34 @@ private:
         std::uint32_t recoveries_ = 0;
     };
 
+    /** A slot in a partition's open-addressing table. */
+    struct Slot
+    {
+        std::size_t hash = 0;
+        uint256 key;
+        Stopwatch::time_point touched;
+        // Unset when the slot is free
+        boost::optional<Entry> entry;
+    };
+
+    /** An independently locked part of the routing table. */
+    struct Partition
+    {
+        std::mutex mutex;
+        // The size is always a power of two
+        std::vector<Slot> slots;
+        std::size_t size = 0;
+        // The most recent expiration time applied to this partition
+        Stopwatch::time_point swept = Stopwatch::time_point::min();
+        // No entry in the partition was touched before this time
+        Stopwatch::time_point oldest;
+    };
+
+    // The low bits of the hash select the partition
+    static constexpr std::size_t partitionBits = 4;
+    static constexpr std::size_t partitionCount = 1 << partitionBits;
+    static constexpr std::size_t minCapacity = 64;
+
 public:
     static inline std::chrono::seconds getDefaultHoldTime ()
     {
@@ -151,10 +202,13 @@ public:
 
     HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds,
         std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
+        : clock_ (clock)
         , holdTime_ (entryHoldTimeInSeconds)
         , recoverLimit_ (recoverLimit + 1u)
+        , lastInsert_ (Stopwatch::time_point::min().time_since_epoch().count())
     {
+        for (auto& p : partitions_)
+            p.slots.resize (std::size_t{minCapacity});
     }
 
     HashRouter& operator= (HashRouter const&) = delete;
@@ -203,18 +257,40 @@ public:
     bool shouldRecover(uint256 const& key);
 
 private:
+    Partition& partition (std::size_t hash)
+    {
+        return partitions_[hash & (partitionCount - 1)];
+    }
+
+    // The partition's mutex must be held by the caller.
     // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool> emplace (uint256 const&);
+    std::pair<Entry&, bool> emplace (Partition& p, std::size_t hash,
+        uint256 const& key);
+
+    // Return the slot holding the key, or the free slot where it belongs
+    static Slot& find (std::vector<Slot>& slots, std::size_t hash,
+        uint256 const& key);
 
-    std::mutex mutable mutex_;
+    // Remove entries last touched at or before `expired`
+    void sweep (Partition& p, Stopwatch::time_point expired);
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
-        hardened_hash<strong_hash>> suppressionMap_;
+    // Move the entries touched after `expired` into a table of `capacity`
+    static void rebuild (Partition& p, std::size_t capacity,
+        Stopwatch::time_point expired);
+
+    Stopwatch& clock_;
+
+    hardened_hash<strong_hash> const hash_;
+
+    std::array<Partition, partitionCount> partitions_;
 
     std::chrono::seconds const holdTime_;
 
     std::uint32_t const recoverLimit_;
+
+    // The time of the most recent insertion. Entries touched at or before
+    // this time minus the hold time are expired.
+    std::atomic<Stopwatch::duration::rep> lastInsert_;
 };
 
 } // ripple
@@ -58,6 +58,7 @@
 #include <ripple/basics/make_lock.h>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <set>
 
 namespace ripple {
 
@@ -90,6 +91,22 @@ class NetworkOPsImp final
         {}
     };
 
+    /**
+     * Transaction from the network awaiting a signature check.
+     */
+    struct PendingVerify
+    {
+        std::shared_ptr<STTx const> stx;
+        std::function<void()> handler;
+    };
+
+    // Signatures checked by one verification job. Small, so that a burst
+    // is spread over many jobs and checked in parallel.
+    static constexpr std::size_t verifyBatchSize = 16;
+
+    // The most transactions that may await signature checks
+    static constexpr std::size_t maxVerifyQueue = 1024;
+
     /**
      * Synchronization states for transaction batches.
      */
@@ -267,6 +284,14 @@ public:
      */
     void transactionBatch();
 
+    bool verifyTransaction (std::shared_ptr<STTx const> const& stx,
+        std::function<void()> handler) override;
+
+    /**
+     * Check signatures in batches. Continue until none are queued.
+     */
+    void verifyTransactions();
+
     /**
      * Attempt to apply transactions and post-process based on the results.
      *
@@ -466,6 +491,9 @@ public:
     bool unsubPeerStatus (std::uint64_t uListener) override;
     void pubPeerStatus (std::function<Json::Value(void)> const&) override;
 
+    bool subStateDiffs (InfoSub::ref ispListener) override;
+    bool unsubStateDiffs (std::uint64_t uListener) override;
+
     InfoSub::pointer findRpcSub (std::string const& strUrl) override;
     InfoSub::pointer addRpcSub (
         std::string const& strUrl, InfoSub::ref) override;
@@ -516,6 +544,8 @@ private:
         const STTx& stTxn, TER terResult, bool bValidated,
         std::shared_ptr<ReadView const> const& lpCurrent);
 
+    Json::Value stateDiffJson (ReadView const& ledger);
+
     void pubValidatedTransaction (
         std::shared_ptr<ReadView const> const& alAccepted,
         const AcceptedLedgerTx& alTransaction);
@@ -572,8 +602,9 @@ private:
         sRTTransactions,            // All proposed and accepted transactions.
         sValidations,               // Received validations.
         sPeerStatus,                // Peer status changes.
+        sStateDiffs,                // State entries changed by each ledger.
 
-        sLastEntry = sPeerStatus    // as this name implies, any new entry must
+        sLastEntry = sStateDiffs    // as this name implies, any new entry must
                                     // be ADDED ABOVE this one
     };
     std::array<SubMapType, SubTypes::sLastEntry+1> mStreamMaps;
@@ -595,6 +626,11 @@ private:
     DispatchState mDispatchState = DispatchState::none;
     std::vector <TransactionStatus> mTransactions;
 
+    // Signature checking. One job runs for each batch waiting.
+    std::mutex mVerifyMutex;
+    std::deque <PendingVerify> mVerifyQueue;
+    std::size_t mVerifyJobs = 0;
+
     StateAccounting accounting_ {};
 };
 
@@ -1005,6 +1041,62 @@ void NetworkOPsImp::transactionBatch()
     }
 }
 
+bool NetworkOPsImp::verifyTransaction (
+    std::shared_ptr<STTx const> const& stx, std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> lock (mVerifyMutex);
+
+    if (mVerifyQueue.size() >= maxVerifyQueue)
+        return false;
+
+    mVerifyQueue.push_back ({stx, std::move (handler)});
+
+    // Start another job for each full batch, so a burst is checked
+    // on as many threads as the job queue allows.
+    if (mVerifyQueue.size() > mVerifyJobs * verifyBatchSize)
+    {
+        if (m_job_queue.addJob (
+            jtTRANSACTION, "verifyTransactions",
+            [this] (Job&) { verifyTransactions(); }))
+        {
+            ++mVerifyJobs;
+        }
+    }
+
+    return true;
+}
+
+void NetworkOPsImp::verifyTransactions()
+{
+    std::unique_lock<std::mutex> lock (mVerifyMutex);
+
+    while (! mVerifyQueue.empty())
+    {
+        auto const n = std::min (
+            mVerifyQueue.size(), std::size_t{verifyBatchSize});
+        std::vector<PendingVerify> batch (
+            std::make_move_iterator (mVerifyQueue.begin()),
+            std::make_move_iterator (mVerifyQueue.begin() + n));
+        mVerifyQueue.erase (mVerifyQueue.begin(), mVerifyQueue.begin() + n);
+        lock.unlock();
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve (batch.size());
+        for (auto const& pending : batch)
+            txs.push_back (pending.stx);
+
+        checkSignatures (app_.getHashRouter(), txs,
+            m_ledgerMaster.getValidatedRules());
+
+        for (auto& pending : batch)
+            pending.handler();
+
+        lock.lock();
+    }
+
+    --mVerifyJobs;
+}
+
 void NetworkOPsImp::apply (std::unique_lock<std::mutex>& batchLock)
 {
     std::vector<TransactionStatus> submit_held;
@@ -1569,12 +1661,14 @@ void NetworkOPsImp::pubManifest (Manifest const& mo)
         jvObj [jss::signature]        = strHex (mo.getSignature ());
         jvObj [jss::master_signature] = strHex (mo.getMasterSignature ());
 
+        InfoSub::Message const msg (std::move (jvObj));
+
         for (auto i = mStreamMaps[sManifests].begin ();
             i != mStreamMaps[sManifests].end (); )
         {
             if (auto p = i->second.lock())
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++i;
             }
             else
@@ -1668,6 +1762,8 @@ void NetworkOPsImp::pubServer ()
 
         mLastFeeSummary = f;
 
+        InfoSub::Message const msg (std::move (jvObj));
+
         for (auto i = mStreamMaps[sServer].begin ();
             i != mStreamMaps[sServer].end (); )
         {
@@ -1678,7 +1774,7 @@ void NetworkOPsImp::pubServer ()
             //             sending of JSON data.
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++i;
             }
             else
@@ -1734,12 +1830,14 @@ void NetworkOPsImp::pubValidation (STValidation::ref val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj [jss::reserve_inc] = *reserveInc;
 
+        InfoSub::Message const msg (std::move (jvObj));
+
         for (auto i = mStreamMaps[sValidations].begin ();
             i != mStreamMaps[sValidations].end (); )
         {
             if (auto p = i->second.lock())
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++i;
             }
             else
@@ -1761,6 +1859,8 @@ void NetworkOPsImp::pubPeerStatus (
 
         jvObj [jss::type]                  = "peerStatusChange";
 
+        InfoSub::Message const msg (std::move (jvObj));
+
         for (auto i = mStreamMaps[sPeerStatus].begin ();
             i != mStreamMaps[sPeerStatus].end (); )
         {
@@ -1768,7 +1868,7 @@ void NetworkOPsImp::pubPeerStatus (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++i;
             }
             else
@@ -2030,7 +2130,8 @@ NetworkOPsImp::getTxsAccount (
             ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+    accountTxPage(app_.getTxnDB (), app_.getAccountTxIndex (),
+        app_.accountIDCache(),
         std::bind(saveLedgerAsync, std::ref(app_),
             std::placeholders::_1), bound, account, minLedger,
                 maxLedger, forward, token, limit, bUnlimited,
@@ -2058,7 +2159,8 @@ NetworkOPsImp::getTxsAccountB (
         ret.emplace_back (strHex(rawTxn), strHex (rawMeta), ledgerIndex);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+    accountTxPage(app_.getTxnDB (), app_.getAccountTxIndex (),
+        app_.accountIDCache(),
         std::bind(saveLedgerAsync, std::ref(app_),
             std::placeholders::_1), bound, account, minLedger,
                 maxLedger, forward, token, limit, bUnlimited,
@@ -2377,7 +2479,8 @@ void NetworkOPsImp::pubProposedTransaction (
     std::shared_ptr<ReadView const> const& lpCurrent,
     std::shared_ptr<STTx const> const& stTxn, TER terResult)
 {
-    Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
+    InfoSub::Message const msg (
+        transJson (*stTxn, terResult, false, lpCurrent));
 
     {
         ScopedLockType sl (mSubLock);
@@ -2389,7 +2492,7 @@ void NetworkOPsImp::pubProposedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++it;
             }
             else
@@ -2447,13 +2550,15 @@ void NetworkOPsImp::pubLedger (
                         = app_.getLedgerMaster ().getCompleteLedgers ();
             }
 
+            InfoSub::Message const msg (std::move (jvObj));
+
             auto it = mStreamMaps[sLedger].begin ();
             while (it != mStreamMaps[sLedger].end ())
             {
                 InfoSub::pointer p = it->second.lock ();
                 if (p)
                 {
-                    p->send (jvObj, true);
+                    p->send (msg, true);
                     ++it;
                 }
                 else
@@ -2462,6 +2567,33 @@ void NetworkOPsImp::pubLedger (
         }
     }
 
+    bool wantStateDiff;
+    {
+        ScopedLockType sl (mSubLock);
+        wantStateDiff = !mStreamMaps[sStateDiffs].empty ();
+    }
+
+    if (wantStateDiff)
+    {
+        // Built without the lock, since large ledgers touch many entries
+        InfoSub::Message const msg (stateDiffJson (*lpAccepted));
+
+        ScopedLockType sl (mSubLock);
+
+        auto it = mStreamMaps[sStateDiffs].begin ();
+        while (it != mStreamMaps[sStateDiffs].end ())
+        {
+            InfoSub::pointer p = it->second.lock ();
+            if (p)
+            {
+                p->send (msg, true);
+                ++it;
+            }
+            else
+                it = mStreamMaps[sStateDiffs].erase (it);
+        }
+    }
+
     // Don't lock since pubAcceptedTransaction is locking.
     for (auto const& vt : alpAccepted->getMap ())
     {
@@ -2539,6 +2671,56 @@ Json::Value NetworkOPsImp::transJson(
     return jvObj;
 }
 
+// The state entries a ledger created, modified or deleted, taken from
+// its transactions' metadata, as they are after the ledger.
+Json::Value NetworkOPsImp::stateDiffJson (ReadView const& ledger)
+{
+    std::set<uint256> keys;
+
+    for (auto const& tx : ledger.txs)
+    {
+        if (! tx.second)
+            continue;
+
+        for (auto const& node : tx.second->getFieldArray (sfAffectedNodes))
+            keys.insert (node.getFieldH256 (sfLedgerIndex));
+    }
+
+    // The skip lists are updated without metadata
+    auto const seq = ledger.info().seq;
+    if (seq > 1)
+    {
+        keys.insert (keylet::skip().key);
+        if (((seq - 1) & 0xff) == 0)
+            keys.insert (keylet::skip(seq - 1).key);
+    }
+
+    Json::Value jvObj (Json::objectValue);
+
+    jvObj[jss::type] = "ledgerStateDiff";
+    jvObj[jss::ledger_index] = seq;
+    jvObj[jss::ledger_hash] = to_string (ledger.info().hash);
+
+    Json::Value& state = (jvObj[jss::state] = Json::arrayValue);
+    Json::Value& deleted = (jvObj[jss::deleted] = Json::arrayValue);
+
+    for (auto const& key : keys)
+    {
+        if (auto const sle = ledger.read (keylet::unchecked (key)))
+        {
+            Json::Value& entry = state.append (Json::objectValue);
+            entry[jss::data] = serializeHex (*sle);
+            entry[jss::index] = to_string (key);
+        }
+        else
+        {
+            deleted.append (to_string (key));
+        }
+    }
+
+    return jvObj;
+}
+
 void NetworkOPsImp::pubValidatedTransaction (
     std::shared_ptr<ReadView const> const& alAccepted,
     const AcceptedLedgerTx& alTx)
@@ -2547,6 +2729,9 @@ void NetworkOPsImp::pubValidatedTransaction (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
+    // Shared by the transaction streams and the book listeners
+    InfoSub::Message const msg (std::move (jvObj));
+
     {
         ScopedLockType sl (mSubLock);
 
@@ -2557,7 +2742,7 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++it;
             }
             else
@@ -2572,14 +2757,14 @@ void NetworkOPsImp::pubValidatedTransaction (
 
             if (p)
             {
-                p->send (jvObj, true);
+                p->send (msg, true);
                 ++it;
             }
             else
                 it = mStreamMaps[sRTTransactions].erase (it);
         }
     }
-    app_.getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
+    app_.getOrderBookDB ().processTxn (alAccepted, alTx, msg);
     pubAccountTransaction (alAccepted, alTx, true);
 }
 
@@ -2659,8 +2844,10 @@ void NetworkOPsImp::pubAccountTransaction (
         if (alTx.isApplied ())
             jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
+        InfoSub::Message const msg (std::move (jvObj));
+
         for (InfoSub::ref isrListener : notify)
-            isrListener->send (jvObj, true);
+            isrListener->send (msg, true);
     }
 }
 
@@ -2926,6 +3113,21 @@ bool NetworkOPsImp::unsubPeerStatus (std::uint64_t uSeq)
     return mStreamMaps[sPeerStatus].erase (uSeq);
 }
 
+// <-- bool: true=added, false=already there
+bool NetworkOPsImp::subStateDiffs (InfoSub::ref isrListener)
+{
+    ScopedLockType sl (mSubLock);
+    return mStreamMaps[sStateDiffs].emplace (
+        isrListener->getSeq (), isrListener).second;
+}
+
+// <-- bool: true=erased, false=was not there
+bool NetworkOPsImp::unsubStateDiffs (std::uint64_t uSeq)
+{
+    ScopedLockType sl (mSubLock);
+    return mStreamMaps[sStateDiffs].erase (uSeq);
+}
+
 InfoSub::pointer NetworkOPsImp::findRpcSub (std::string const& strUrl)
 {
     ScopedLockType sl (mSubLock);
@@ -127,6 +127,20 @@ public:
     virtual void processTransaction (std::shared_ptr<Transaction>& transaction,
         bool bUnlimited, bool bLocal, FailHard failType) = 0;
 
+    /**
+     * Check the signature of a transaction received from the network.
+     * Signatures are collected and verified in batches by jobs, and the
+     * results are cached in the HashRouter. The handler is then called
+     * from the job that verified the batch.
+     *
+     * @param stx The transaction
+     * @param handler Called once the signature has been checked.
+     * @return false if too many transactions await checking. The
+     *         handler is not called.
+     */
+    virtual bool verifyTransaction (std::shared_ptr<STTx const> const& stx,
+        std::function<void()> handler) = 0;
+
     //--------------------------------------------------------------------------
     //
     // Owner functions
@@ -19,6 +19,7 @@
 
 
 #include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/app/misc/SHAMapStoreImp.h>
 #include <ripple/beast/core/CurrentThreadName.h>
@@ -780,6 +781,9 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    if (auto index = app_.getAccountTxIndex ())
+        index->clearPrior (lastRotated);
 }
 
 SHAMapStoreImp::Health
@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/unity/rocksdb.h>
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/basics/Log.h>
+#include <ripple/basics/contract.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace ripple {
+
+namespace {
+
+// Return the first and last positions to visit, in index order.
+std::pair<AccountTxIndex::Cursor, AccountTxIndex::Cursor>
+bounds (std::uint32_t minLedger, std::uint32_t maxLedger,
+    boost::optional<AccountTxIndex::Cursor> const& start, bool forward)
+{
+    AccountTxIndex::Cursor first {minLedger, 0};
+    AccountTxIndex::Cursor last {
+        maxLedger, std::numeric_limits<std::uint32_t>::max ()};
+
+    if (start)
+    {
+        if (forward)
+            first = std::max (first, *start);
+        else
+            last = std::min (last, *start);
+    }
+
+    return {first, last};
+}
+
+//------------------------------------------------------------------------------
+
+class MemoryAccountTxIndex : public AccountTxIndex
+{
+private:
+    using Key = std::tuple<AccountID, std::uint32_t, std::uint32_t>;
+
+    std::mutex mutex_;
+    std::map<Key, uint256> entries_;
+
+    // The keys written for each ledger, so they can be replaced
+    std::map<std::uint32_t, std::vector<Key>> ledgers_;
+
+    boost::optional<std::uint32_t> coverage_;
+
+public:
+    void
+    insert (std::uint32_t ledgerSeq,
+        std::vector<Entry> const& entries) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto& keys = ledgers_[ledgerSeq];
+        for (auto const& key : keys)
+            entries_.erase (key);
+        keys.clear ();
+
+        for (auto const& entry : entries)
+        {
+            keys.emplace_back (entry.account, ledgerSeq, entry.txnSeq);
+            entries_[keys.back ()] = entry.txID;
+        }
+    }
+
+    void
+    clearPrior (std::uint32_t ledgerSeq) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto const end = ledgers_.lower_bound (ledgerSeq);
+        for (auto iter = ledgers_.begin (); iter != end; ++iter)
+        {
+            for (auto const& key : iter->second)
+                entries_.erase (key);
+        }
+        ledgers_.erase (ledgers_.begin (), end);
+    }
+
+    boost::optional<std::uint32_t>
+    coverage () override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return coverage_;
+    }
+
+    bool
+    updateCoverage (boost::optional<std::uint32_t> const& expected,
+        std::uint32_t ledgerSeq) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (coverage_ != expected)
+            return false;
+        coverage_ = ledgerSeq;
+        return true;
+    }
+
+    void
+    forEach (AccountID const& account,
+        std::uint32_t minLedger, std::uint32_t maxLedger,
+        boost::optional<Cursor> const& start, bool forward,
+        Visitor const& visit) override
+    {
+        auto const range = bounds (minLedger, maxLedger, start, forward);
+        Key const first {account, range.first.first, range.first.second};
+        Key const last {account, range.second.first, range.second.second};
+
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        if (forward)
+        {
+            for (auto iter = entries_.lower_bound (first);
+                iter != entries_.end () && iter->first <= last; ++iter)
+            {
+                if (! visit (std::get<1> (iter->first),
+                        std::get<2> (iter->first), iter->second))
+                    return;
+            }
+        }
+        else
+        {
+            auto iter = entries_.upper_bound (last);
+            while (iter != entries_.begin ())
+            {
+                --iter;
+                if (iter->first < first)
+                    return;
+                if (! visit (std::get<1> (iter->first),
+                        std::get<2> (iter->first), iter->second))
+                    return;
+            }
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+
+/*  Keys are laid out so that RocksDB's byte order is the index order:
+
+        'a' | AccountID (20) | ledgerSeq (4, big endian) | txnSeq (4, big endian)
+
+    and map to the 32 byte transaction ID. Each ledger also has a record
+
+        'l' | ledgerSeq (4, big endian)
+
+    holding the account keys written for it, so that a ledger can be
+    replaced or removed without scanning the index. The key
+
+        'c'
+
+    holds the first ledger the index covers (4, big endian).
+*/
+class RocksDBAccountTxIndex : public AccountTxIndex
+{
+private:
+    static std::size_t constexpr accountKeySize = 1 + 20 + 4 + 4;
+
+    beast::Journal j_;
+    std::unique_ptr<rocksdb::DB> db_;
+
+    // Serializes the read-modify-write of ledger records and coverage
+    std::mutex mutex_;
+
+    boost::optional<std::uint32_t> coverage_;
+
+    static
+    void
+    putBigEndian (std::string& s, std::uint32_t v)
+    {
+        s += static_cast<char> (v >> 24);
+        s += static_cast<char> (v >> 16);
+        s += static_cast<char> (v >> 8);
+        s += static_cast<char> (v);
+    }
+
+    static
+    std::uint32_t
+    getBigEndian (char const* p)
+    {
+        auto const u = reinterpret_cast<std::uint8_t const*> (p);
+        return (std::uint32_t (u[0]) << 24) | (std::uint32_t (u[1]) << 16) |
+            (std::uint32_t (u[2]) << 8) | std::uint32_t (u[3]);
+    }
+
+    static
+    std::string
+    accountKey (AccountID const& account,
+        std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+    {
+        std::string key;
+        key.reserve (accountKeySize);
+        key += 'a';
+        key.append (reinterpret_cast<char const*> (account.data ()),
+            account.size ());
+        putBigEndian (key, ledgerSeq);
+        putBigEndian (key, txnSeq);
+        return key;
+    }
+
+    static char const* const coverageKey;
+
+    static
+    std::string
+    ledgerKey (std::uint32_t ledgerSeq)
+    {
+        std::string key ("l");
+        putBigEndian (key, ledgerSeq);
+        return key;
+    }
+
+    void
+    write (rocksdb::WriteBatch& batch)
+    {
+        auto const status = db_->Write (rocksdb::WriteOptions (), &batch);
+        if (! status.ok ())
+            Throw<std::runtime_error> (
+                "AccountTxIndex write failed: " + status.ToString ());
+    }
+
+    // Add the deletion of a ledger's entries to a batch
+    static
+    void
+    erase (rocksdb::WriteBatch& batch, rocksdb::Slice const& key,
+        rocksdb::Slice const& record)
+    {
+        for (std::size_t i = 0;
+            i + accountKeySize <= record.size (); i += accountKeySize)
+        {
+            batch.Delete (rocksdb::Slice (record.data () + i, accountKeySize));
+        }
+        batch.Delete (key);
+    }
+
+public:
+    RocksDBAccountTxIndex (std::string const& path, beast::Journal j)
+        : j_ (j)
+    {
+        rocksdb::Options options;
+        options.create_if_missing = true;
+
+        rocksdb::DB* db = nullptr;
+        auto const status = rocksdb::DB::Open (options, path, &db);
+        if (! status.ok () || ! db)
+            Throw<std::runtime_error> (
+                "Unable to open AccountTxIndex at " + path + ": " +
+                    status.ToString ());
+        db_.reset (db);
+
+        std::string value;
+        if (db_->Get (rocksdb::ReadOptions (), coverageKey, &value).ok () &&
+                value.size () == 4)
+            coverage_ = getBigEndian (value.data ());
+    }
+
+    void
+    insert (std::uint32_t ledgerSeq,
+        std::vector<Entry> const& entries) override
+    {
+        auto const lkey = ledgerKey (ledgerSeq);
+        rocksdb::WriteBatch batch;
+
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        std::string old;
+        if (db_->Get (rocksdb::ReadOptions (), lkey, &old).ok ())
+            erase (batch, lkey, old);
+
+        std::string record;
+        record.reserve (entries.size () * accountKeySize);
+        for (auto const& entry : entries)
+        {
+            auto const key = accountKey (
+                entry.account, ledgerSeq, entry.txnSeq);
+            batch.Put (key, rocksdb::Slice (
+                reinterpret_cast<char const*> (entry.txID.data ()),
+                    entry.txID.size ()));
+            record += key;
+        }
+        batch.Put (lkey, record);
+
+        write (batch);
+    }
+
+    void
+    clearPrior (std::uint32_t ledgerSeq) override
+    {
+        auto const end = ledgerKey (ledgerSeq);
+        rocksdb::WriteBatch batch;
+        std::size_t ledgers = 0;
+
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        std::unique_ptr<rocksdb::Iterator> iter (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+        for (iter->Seek (ledgerKey (0));
+            iter->Valid () && iter->key ().compare (end) < 0; iter->Next ())
+        {
+            erase (batch, iter->key (), iter->value ());
+            ++ledgers;
+        }
+
+        if (ledgers != 0)
+        {
+            write (batch);
+            JLOG (j_.debug()) << "Removed " << ledgers << " ledgers";
+        }
+    }
+
+    boost::optional<std::uint32_t>
+    coverage () override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return coverage_;
+    }
+
+    bool
+    updateCoverage (boost::optional<std::uint32_t> const& expected,
+        std::uint32_t ledgerSeq) override
+    {
+        std::string value;
+        putBigEndian (value, ledgerSeq);
+        rocksdb::WriteBatch batch;
+        batch.Put (coverageKey, value);
+
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (coverage_ != expected)
+            return false;
+
+        write (batch);
+        coverage_ = ledgerSeq;
+        return true;
+    }
+
+    void
+    forEach (AccountID const& account,
+        std::uint32_t minLedger, std::uint32_t maxLedger,
+        boost::optional<Cursor> const& start, bool forward,
+        Visitor const& visit) override
+    {
+        auto const range = bounds (minLedger, maxLedger, start, forward);
+        auto const first = accountKey (
+            account, range.first.first, range.first.second);
+        auto const last = accountKey (
+            account, range.second.first, range.second.second);
+
+        auto const onEntry = [&visit] (rocksdb::Iterator const& iter)
+        {
+            auto const key = iter.key ();
+            auto const value = iter.value ();
+            if (key.size () != accountKeySize || value.size () != 32)
+                return true;
+            return visit (getBigEndian (key.data () + 21),
+                getBigEndian (key.data () + 25),
+                uint256::fromVoid (value.data ()));
+        };
+
+        std::unique_ptr<rocksdb::Iterator> iter (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+
+        if (forward)
+        {
+            for (iter->Seek (first);
+                iter->Valid () && iter->key ().compare (last) <= 0;
+                iter->Next ())
+            {
+                if (! onEntry (*iter))
+                    return;
+            }
+        }
+        else
+        {
+            for (iter->SeekForPrev (last);
+                iter->Valid () && iter->key ().compare (first) >= 0;
+                iter->Prev ())
+            {
+                if (! onEntry (*iter))
+                    return;
+            }
+        }
+    }
+};
+
+char const* const RocksDBAccountTxIndex::coverageKey = "c";
+
+#endif
+
+} // namespace
+
+std::unique_ptr<AccountTxIndex>
+make_AccountTxIndex (Section const& section, beast::Journal journal)
+{
+    std::string type;
+    get_if_exists (section, "type", type);
+
+    if (boost::iequals (type, "memory"))
+        return std::make_unique<MemoryAccountTxIndex> ();
+
+#if RIPPLE_ROCKSDB_AVAILABLE
+    if (boost::iequals (type, "rocksdb"))
+    {
+        std::string path;
+        if (! get_if_exists (section, "path", path) || path.empty ())
+            Throw<std::runtime_error> (
+                "Missing path in [account_tx_index]");
+        return std::make_unique<RocksDBAccountTxIndex> (path, journal);
+    }
+#endif
+
+    Throw<std::runtime_error> (
+        "Unknown [account_tx_index] type '" + type + "'");
+    return {};
+}
+
+} // ripple
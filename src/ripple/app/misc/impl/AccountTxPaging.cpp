@@ -20,12 +20,18 @@
 #include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/AccountTxIndex.h>
 #include <ripple/app/misc/Transaction.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/AccountID.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace ripple {
 
@@ -60,9 +66,95 @@ saveLedgerAsync (Application& app, std::uint32_t seq)
         pendSaveValidated(app, l, false, false);
 }
 
+// Walk the account's history in the index, reading each transaction from
+// the database. Mirrors the AccountTransactions query below, including
+// skipping entries whose transaction is not in the database.
+static
+void
+accountTxPageIndexed (
+    DatabaseCon& connection,
+    AccountTxIndex& index,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::uint32_t minLedger,
+    std::uint32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    std::uint32_t numberOfResults,
+    boost::optional<AccountTxIndex::Cursor> const& marker)
+{
+    bool lookingForMarker = static_cast<bool> (marker);
+
+    auto db (connection.checkoutDb());
+
+    Blob rawData;
+    Blob rawMeta;
+
+    std::string txnId;
+    boost::optional<std::string> status;
+    soci::blob txnData (*db);
+    soci::blob txnMeta (*db);
+    soci::indicator dataPresent, metaPresent;
+
+    soci::statement st = (db->prepare <<
+        "SELECT Status,RawTxn,TxnMeta FROM Transactions "
+        "WHERE TransID = :txnId;",
+        soci::use (txnId),
+        soci::into (status),
+        soci::into (txnData, dataPresent),
+        soci::into (txnMeta, metaPresent));
+
+    index.forEach (account, minLedger, maxLedger, marker, forward,
+        [&] (std::uint32_t ledgerSeq, std::uint32_t txnSeq,
+            uint256 const& txID)
+        {
+            txnId = to_string (txID);
+            if (! st.execute (true) || ! status)
+                return true;
+
+            if (lookingForMarker)
+            {
+                // The walk starts at the marker, so it must come first
+                if (AccountTxIndex::Cursor (ledgerSeq, txnSeq) != *marker)
+                    return false;
+                lookingForMarker = false;
+            }
+            else if (numberOfResults == 0)
+            {
+                token = Json::objectValue;
+                token[jss::ledger] = ledgerSeq;
+                token[jss::seq] = txnSeq;
+                return false;
+            }
+
+            if (dataPresent == soci::i_ok)
+                convert (txnData, rawData);
+            else
+                rawData.clear ();
+
+            if (metaPresent == soci::i_ok)
+                convert (txnMeta, rawMeta);
+            else
+                rawMeta.clear ();
+
+            // Work around a bug that could leave the metadata missing
+            if (rawMeta.size() == 0)
+                onUnsavedLedger(ledgerSeq);
+
+            onTransaction(ledgerSeq, *status, rawData, rawMeta);
+            --numberOfResults;
+            return true;
+        });
+}
+
 void
 accountTxPage (
     DatabaseCon& connection,
+    AccountTxIndex* index,
     AccountIDCache const& idCache,
     std::function<void (std::uint32_t)> const& onUnsavedLedger,
     std::function<void (std::uint32_t,
@@ -114,6 +206,28 @@ accountTxPage (
     // we need to clear it in between.
     token = Json::nullValue;
 
+    // Before the index's coverage only the AccountTransactions table is
+    // complete, so the index is only used if it covers the whole walk.
+    std::uint32_t firstLedger = std::max (minLedger, 0);
+    if (forward && lookingForMarker)
+        firstLedger = std::max (firstLedger, findLedger);
+
+    auto const covered = index ?
+        index->coverage () : boost::optional<std::uint32_t> ();
+
+    if (covered && firstLedger >= *covered)
+    {
+        boost::optional<AccountTxIndex::Cursor> marker;
+        if (lookingForMarker)
+            marker.emplace (findLedger, findSeq);
+
+        accountTxPageIndexed (connection, *index, onUnsavedLedger,
+            onTransaction, account, std::max (minLedger, 0),
+            std::max (maxLedger, 0), forward, token, numberOfResults,
+            marker);
+        return;
+    }
+
     static std::string const prefix (
         R"(SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,
           Status,RawTxn,TxnMeta
@@ -279,4 +393,120 @@ accountTxPage (
     return;
 }
 
+void
+initAccountTxIndexCoverage (DatabaseCon& connection, AccountTxIndex& index)
+{
+    if (index.coverage ())
+        return;
+
+    // The ledgers already saved are not in a new index
+    boost::optional<std::uint64_t> newest;
+    {
+        auto db (connection.checkoutDb ());
+        *db << "SELECT MAX(LedgerSeq) FROM AccountTransactions;",
+            soci::into (newest);
+    }
+
+    index.updateCoverage (boost::none,
+        newest ? rangeCheckedCast<std::uint32_t> (*newest + 1) : 0);
+}
+
+bool
+backfillAccountTxIndex (DatabaseCon& connection, AccountTxIndex& index,
+    std::uint32_t maxLedgers)
+{
+    auto const covered = index.coverage ();
+    if (! covered || *covered == 0)
+        return false;
+
+    std::map<std::uint32_t, std::vector<AccountTxIndex::Entry>> ledgers;
+    std::uint32_t first;
+    {
+        auto db (connection.checkoutDb ());
+
+        boost::optional<std::uint64_t> oldest;
+        *db << "SELECT MIN(LedgerSeq) FROM AccountTransactions;",
+            soci::into (oldest);
+
+        if (! oldest || *oldest >= *covered)
+        {
+            // Nothing before the coverage is left to index. If the
+            // coverage changed meanwhile, look again.
+            return ! index.updateCoverage (covered, 0);
+        }
+
+        std::uint32_t const last = *covered - 1;
+        first = std::max (rangeCheckedCast<std::uint32_t> (*oldest),
+            last - std::min (last, maxLedgers - 1));
+
+        boost::optional<std::uint64_t> ledgerSeq;
+        boost::optional<std::uint32_t> txnSeq;
+        boost::optional<std::string> txnId;
+        boost::optional<std::string> account;
+
+        soci::statement st = (db->prepare <<
+            "SELECT LedgerSeq,TxnSeq,TransID,Account "
+            "FROM AccountTransactions "
+            "WHERE LedgerSeq BETWEEN :first AND :last;",
+            soci::use (first),
+            soci::use (last),
+            soci::into (ledgerSeq),
+            soci::into (txnSeq),
+            soci::into (txnId),
+            soci::into (account));
+
+        st.execute ();
+
+        while (st.fetch ())
+        {
+            if (! ledgerSeq || ! txnSeq || ! txnId || ! account)
+                continue;
+
+            auto const id = parseBase58<AccountID> (*account);
+            uint256 txID;
+            if (! id || ! txID.SetHexExact (*txnId))
+                continue;
+
+            ledgers[rangeCheckedCast<std::uint32_t> (*ledgerSeq)].push_back (
+                {*id, *txnSeq, txID});
+        }
+    }
+
+    for (auto const& ledger : ledgers)
+        index.insert (ledger.first, ledger.second);
+
+    // If the coverage changed meanwhile, the next pass starts from there
+    index.updateCoverage (covered, first);
+    return true;
+}
+
+void
+startAccountTxIndexBackfill (Application& app)
+{
+    app.getJobQueue ().addJob (jtTX_INDEX, "AccountTxIndex::backfill",
+        [&app] (Job&)
+        {
+            auto const index = app.getAccountTxIndex ();
+            if (! index)
+                return;
+
+            auto const j = app.journal ("AccountTxIndex");
+            try
+            {
+                if (backfillAccountTxIndex (app.getTxnDB (), *index, 256))
+                {
+                    startAccountTxIndexBackfill (app);
+                }
+                else
+                {
+                    JLOG (j.info()) << "Backfill complete";
+                }
+            }
+            catch (std::exception const& e)
+            {
+                JLOG (j.warn()) << "Backfill failed: " << e.what ();
+            }
+        });
+}
+
 }
@@ -43,9 +43,19 @@ convertBlobsToTxResult (
 void
 saveLedgerAsync (Application& app, std::uint32_t seq);
 
+class AccountTxIndex;
+
+/** Return one page of an account's transactions.
+
+    If an AccountTxIndex is supplied and it covers the ledgers to be
+    walked, the account's history is walked in the index and each
+    transaction is read from the database by its ID. Otherwise the
+    AccountTransactions table is queried.
+*/
 void
 accountTxPage (
     DatabaseCon& database,
+    AccountTxIndex* index,
     AccountIDCache const& idCache,
     std::function<void (std::uint32_t)> const& onUnsavedLedger,
     std::function<void (std::uint32_t,
@@ -61,6 +71,34 @@ accountTxPage (
     bool bAdmin,
     std::uint32_t pageLength);
 
+/** Record the coverage of an index which has never been used.
+
+    The ledgers already in the AccountTransactions table are not in the
+    index, so it covers the ledgers after them.
+*/
+void
+initAccountTxIndexCoverage (DatabaseCon& database, AccountTxIndex& index);
+
+/** Index some of the ledgers before the index's coverage.
+
+    Reads at most `maxLedgers` ledgers, newest first, from the
+    AccountTransactions table, adds them to the index and extends its
+    coverage back over them.
+
+    @return `true` if there may be ledgers left to index.
+*/
+bool
+backfillAccountTxIndex (DatabaseCon& database, AccountTxIndex& index,
+    std::uint32_t maxLedgers);
+
+/** Backfill the application's index in the background.
+
+    Runs as a series of low priority jobs until the index covers every
+    ledger in the transaction database.
+*/
+void
+startAccountTxIndexBackfill (Application& app);
+
 }
 
 #endif
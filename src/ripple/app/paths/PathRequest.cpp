@@ -459,7 +459,8 @@ std::unique_ptr<Pathfinder> const&
 PathRequest::getPathFinder(std::shared_ptr<RippleLineCache> const& cache,
     hash_map<Currency, std::unique_ptr<Pathfinder>>& currency_map,
         Currency const& currency, STAmount const& dst_amount,
-            int const level)
+            int const level,
+                std::function<bool(void)> const& continueCallback)
 {
     auto i = currency_map.find(currency);
     if (i != currency_map.end())
@@ -467,8 +468,8 @@ PathRequest::getPathFinder(std::shared_ptr<RippleLineCache> const& cache,
     auto pathfinder = std::make_unique<Pathfinder>(
         cache, *raSrcAccount, *raDstAccount, currency,
             boost::none, dst_amount, saSendMax, app_);
-    if (pathfinder->findPaths(level))
-        pathfinder->computePathRanks(max_paths_);
+    if (pathfinder->findPaths(level, continueCallback))
+        pathfinder->computePathRanks(max_paths_, continueCallback);
     else
         pathfinder.reset();  // It's a bad request - clear it.
     return currency_map[currency] = std::move(pathfinder);
@@ -476,7 +477,8 @@ PathRequest::getPathFinder(std::shared_ptr<RippleLineCache> const& cache,
 
 bool
 PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
-    int const level, Json::Value& jvArray)
+    int const level, Json::Value& jvArray,
+        std::function<bool(void)> const& continueCallback)
 {
     auto sourceCurrencies = sciSourceCurrencies;
     if (sourceCurrencies.empty ())
@@ -501,13 +503,16 @@ PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
     hash_map<Currency, std::unique_ptr<Pathfinder>> currency_map;
     for (auto const& issue : sourceCurrencies)
     {
+        if (continueCallback && ! continueCallback())
+            break;
+
         JLOG(m_journal.debug())
             << iIdentifier
             << " Trying to find paths: "
             << STAmount(issue, 1).getFullText();
 
         auto& pathfinder = getPathFinder(cache, currency_map,
-            issue.currency, dst_amount, level);
+            issue.currency, dst_amount, level, continueCallback);
         if (! pathfinder)
         {
             assert(false);
@@ -617,7 +622,8 @@ PathRequest::findPaths (std::shared_ptr<RippleLineCache> const& cache,
 }
 
 Json::Value PathRequest::doUpdate(
-    std::shared_ptr<RippleLineCache> const& cache, bool fast)
+    std::shared_ptr<RippleLineCache> const& cache, bool fast,
+    std::function<bool(void)> const& continueCallback)
 {
     using namespace std::chrono;
     JLOG(m_journal.debug()) << iIdentifier
@@ -686,7 +692,7 @@ Json::Value PathRequest::doUpdate(
         << " processing at level " << iLevel;
 
     Json::Value jvArray = Json::arrayValue;
-    if (findPaths(cache, iLevel, jvArray))
+    if (findPaths(cache, iLevel, jvArray, continueCallback))
     {
         bLastSuccess = jvArray.size() != 0;
         newStatus[jss::alternatives] = std::move (jvArray);
@@ -27,6 +27,7 @@
 #include <ripple/net/InfoSub.h>
 #include <ripple/protocol/UintTypes.h>
 #include <boost/optional.hpp>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <set>
@@ -96,7 +97,8 @@ public:
 
     // update jvStatus
     Json::Value doUpdate (
-        std::shared_ptr<RippleLineCache> const&, bool fast);
+        std::shared_ptr<RippleLineCache> const&, bool fast,
+        std::function<bool(void)> const& continueCallback = {});
     InfoSub::pointer getSubscriber ();
     bool hasCompletion ();
 
@@ -109,13 +111,15 @@ private:
     std::unique_ptr<Pathfinder> const&
     getPathFinder(std::shared_ptr<RippleLineCache> const&,
         hash_map<Currency, std::unique_ptr<Pathfinder>>&, Currency const&,
-            STAmount const&, int const);
+            STAmount const&, int const,
+                std::function<bool(void)> const&);
 
     /** Finds and sets a PathSet in the JSON argument.
         Returns false if the source currencies are inavlid.
     */
     bool
-    findPaths (std::shared_ptr<RippleLineCache> const&, int const, Json::Value&);
+    findPaths (std::shared_ptr<RippleLineCache> const&, int const, Json::Value&,
+        std::function<bool(void)> const&);
 
     int parseJson (Json::Value const&);
 
@@ -20,6 +20,7 @@
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/paths/Tuning.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/net/RPCErr.h>
@@ -27,6 +28,8 @@
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/resource/Fees.h>
 #include <algorithm>
+#include <condition_variable>
+#include <thread>
 
 namespace ripple {
 
@@ -48,7 +51,23 @@ PathRequests::getLineCache (
          (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
          (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
     {
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+        // Carry the trust lines that didn't change over from the
+        // previous ledger, if this one directly follows it.
+        if (mLineCache && (lgrSeq == lineSeq + 1) && !ledger->open() &&
+            !mLineCache->getLedger()->open() &&
+            (ledger->info().parentHash ==
+                mLineCache->getLedger()->info().hash))
+        {
+            mLineCache = std::make_shared<RippleLineCache> (
+                ledger, *mLineCache);
+
+            JLOG (mJournal.debug()) << "getLineCache seq=" << lgrSeq <<
+                ", " << mLineCache->inherited() << " accounts inherited";
+        }
+        else
+        {
+            mLineCache = std::make_shared<RippleLineCache> (ledger);
+        }
     }
     return mLineCache;
 }
@@ -81,73 +100,38 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
 
     do
     {
-        for (auto const& wr : requests)
-        {
-            if (shouldCancel())
-                break;
-
-            auto request = wr.lock ();
-            bool remove = true;
-
-            if (request)
-            {
-                if (!request->needsUpdate (newRequests, cache->getLedger()->seq()))
-                    remove = false;
-                else
-                {
-                    if (auto ipSub = request->getSubscriber ())
-                    {
-                        if (!ipSub->getConsumer ().warn ())
-                        {
-                            Json::Value update = request->doUpdate (cache, false);
-                            request->updateComplete ();
-                            update[jss::type] = "path_find";
-                            ipSub->send (update, false);
-                            remove = false;
-                            ++processed;
-                        }
-                    }
-                    else if (request->hasCompletion ())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate (cache, false);
-                        request->updateComplete();
-                        ++processed;
-                    }
-                }
-            }
+        auto const pass = updatePass (
+            requests, cache, newRequests, shouldCancel);
 
-            if (remove)
-            {
-                ScopedLockType sl (mLock);
+        processed += pass.processed;
+        mustBreak = pass.mustBreak;
+        mUpdateLag = pass.lag;
 
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if (
-                    requests_.begin(), requests_.end(),
-                    [&removed,&request](auto const& wl)
-                    {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase (ret, requests_.end());
-            }
+        if (!pass.remove.empty())
+        {
+            ScopedLockType sl (mLock);
 
-            mustBreak = !newRequests &&
-                app_.getLedgerMaster().isNewPathRequest();
+            // Remove any dangling weak pointers or weak
+            // pointers that refer to a removed path request.
+            auto ret = std::remove_if (
+                requests_.begin(), requests_.end(),
+                [&removed,&pass](auto const& wl)
+                {
+                    auto r = wl.lock();
 
-            // We weren't handling new requests and then
-            // there was a new request
-            if (mustBreak)
-                break;
+                    if (r && std::find (pass.remove.begin(),
+                            pass.remove.end(), r) == pass.remove.end())
+                        return false;
+                    ++removed;
+                    return true;
+                });
 
+            requests_.erase (ret, requests_.end());
         }
 
+        if (shouldCancel())
+            break;
+
         if (mustBreak)
         { // a new request came in while we were working
             newRequests = true;
@@ -180,6 +164,158 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
         removed << " removed";
 }
 
+/** Update each request in a snapshot once, using the job queue.
+
+    Requests are claimed in order by the calling thread and by helper
+    jobs, which all share the same RippleLineCache. A request is never
+    updated by two threads at once, since needsUpdate only lets one
+    caller through until updateComplete is called. Each request gets
+    at most PATHFINDER_UPDATE_DEADLINE to search before it replies
+    with the paths found so far.
+
+    Once a new request arrives (when we were not already handling new
+    requests) or the job is cancelled, the requests that have not been
+    claimed yet are skipped.
+*/
+PathRequests::PassResult
+PathRequests::updatePass (
+    std::vector<PathRequest::wptr> const& requests,
+    std::shared_ptr<RippleLineCache> const& cache,
+    bool newRequests,
+    Job::CancelCallback const& shouldCancel)
+{
+    using namespace std::chrono;
+
+    // Helpers may start after the pass is done and the caller has
+    // returned, so only the shared state may be touched until a
+    // request has been claimed.
+    struct State
+    {
+        explicit State (std::size_t total) : total (total)
+        {
+        }
+
+        std::size_t const total;
+        std::atomic<std::size_t> next {0};
+        std::atomic<bool> stop {false};
+        std::size_t done = 0;
+        PassResult result;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto const state = std::make_shared<State> (requests.size());
+    auto const seq = cache->getLedger()->seq();
+
+    auto const work =
+        [this, &requests, &cache, &shouldCancel, newRequests, seq, state]
+    {
+        std::size_t count = 0;
+        int processed = 0;
+        bool mustBreak = false;
+        LedgerIndex lag = 0;
+        std::vector<PathRequest::pointer> remove;
+
+        for (auto i = state->next++; i < state->total; i = state->next++)
+        {
+            ++count;
+
+            if (state->stop || shouldCancel())
+            {
+                state->stop = true;
+                continue;
+            }
+
+            auto request = requests[i].lock ();
+            bool doRemove = true;
+
+            if (request)
+            {
+                auto const deadline =
+                    steady_clock::now() + PATHFINDER_UPDATE_DEADLINE;
+                auto const continueCallback =
+                    [&shouldCancel, deadline]
+                    {
+                        return !shouldCancel() &&
+                            steady_clock::now() < deadline;
+                    };
+
+                if (!request->needsUpdate (newRequests, seq))
+                    doRemove = false;
+                else
+                {
+                    if (auto ipSub = request->getSubscriber ())
+                    {
+                        if (!ipSub->getConsumer ().warn ())
+                        {
+                            Json::Value update = request->doUpdate (
+                                cache, false, continueCallback);
+                            request->updateComplete ();
+                            update[jss::type] = "path_find";
+                            ipSub->send (update, false);
+                            doRemove = false;
+                            ++processed;
+                        }
+                    }
+                    else if (request->hasCompletion ())
+                    {
+                        // One-shot request with completion function
+                        request->doUpdate (cache, false, continueCallback);
+                        request->updateComplete();
+                        ++processed;
+                    }
+
+                    // How many validated ledgers this reply is behind
+                    auto const valid =
+                        app_.getLedgerMaster().getValidLedgerIndex();
+                    if (valid > seq)
+                        lag = std::max (lag, valid - seq);
+                }
+            }
+
+            if (doRemove)
+                remove.push_back (std::move (request));
+
+            // We weren't handling new requests and then
+            // there was a new request
+            if (!newRequests &&
+                app_.getLedgerMaster().isNewPathRequest())
+            {
+                mustBreak = true;
+                state->stop = true;
+            }
+        }
+
+        if (count != 0)
+        {
+            std::lock_guard<std::mutex> lock (state->mutex);
+            state->result.processed += processed;
+            state->result.mustBreak = state->result.mustBreak || mustBreak;
+            state->result.lag = std::max (state->result.lag, lag);
+            for (auto& r : remove)
+                state->result.remove.push_back (std::move (r));
+            state->done += count;
+            if (state->done == state->total)
+                state->cv.notify_all();
+        }
+    };
+
+    auto const helpers = std::min<std::size_t> (
+        std::max (1u, std::thread::hardware_concurrency()) - 1,
+        requests.size() / PATHFINDER_MIN_REQUESTS_PER_WORKER);
+
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        app_.getJobQueue().addJob (
+            jtUPDATE_PF, "PathRequest::update", [work](Job&) { work(); });
+    }
+
+    work();
+
+    std::unique_lock<std::mutex> lock (state->mutex);
+    state->cv.wait (lock, [&] { return state->done == state->total; });
+    return std::move (state->result);
+}
+
 void PathRequests::insertPathRequest (
     PathRequest::pointer const& req)
 {
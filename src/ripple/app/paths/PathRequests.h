@@ -42,6 +42,7 @@ public:
     {
         mFast = collector->make_event ("pathfind_fast");
         mFull = collector->make_event ("pathfind_full");
+        mUpdateLag = collector->make_gauge ("pathfind_update_lag");
     }
 
     /** Update all of the contained PathRequest instances.
@@ -90,6 +91,26 @@ public:
     }
 
 private:
+    struct PassResult
+    {
+        int processed = 0;
+
+        // A new request arrived and the pass stopped early
+        bool mustBreak = false;
+
+        // Validated ledgers the slowest reply was behind
+        LedgerIndex lag = 0;
+
+        // Requests to drop; null entries are dangling requests
+        std::vector<PathRequest::pointer> remove;
+    };
+
+    PassResult updatePass (
+        std::vector<PathRequest::wptr> const& requests,
+        std::shared_ptr<RippleLineCache> const& cache,
+        bool newRequests,
+        Job::CancelCallback const& shouldCancel);
+
     void insertPathRequest (PathRequest::pointer const&);
 
     Application& app_;
@@ -97,6 +118,7 @@ private:
 
     beast::insight::Event            mFast;
     beast::insight::Event            mFull;
+    beast::insight::Gauge            mUpdateLag;
 
     // Track all requests
     std::vector<PathRequest::wptr> requests_;
@@ -170,7 +170,9 @@ Pathfinder::Pathfinder (
     assert (! uSrcIssuer || isXRP(uSrcCurrency) == isXRP(uSrcIssuer.get()));
 }
 
-bool Pathfinder::findPaths (int searchLevel)
+bool Pathfinder::findPaths (
+    int searchLevel,
+    std::function<bool(void)> const& continueCallback)
 {
     if (mDstAmount == beast::zero)
     {
@@ -301,6 +303,9 @@ bool Pathfinder::findPaths (int searchLevel)
     // Now iterate over all paths for that paymentType.
     for (auto const& costedPath : mPathTable[paymentType])
     {
+        if (continueCallback && ! continueCallback ())
+            break;
+
         // Only use paths with at most the current search level.
         if (costedPath.searchLevel <= searchLevel)
         {
@@ -399,7 +404,9 @@ STAmount smallestUsefulAmount (STAmount const& amount, int maxPaths)
 
 } // namespace
 
-void Pathfinder::computePathRanks (int maxPaths)
+void Pathfinder::computePathRanks (
+    int maxPaths,
+    std::function<bool(void)> const& continueCallback)
 {
     mRemainingAmount = convert_all_ ?
         STAmount(mDstAmount.issue(), STAmount::cMaxValue,
@@ -440,7 +447,7 @@ void Pathfinder::computePathRanks (int maxPaths)
         JLOG (j_.debug()) << "Default path causes exception";
     }
 
-    rankPaths (maxPaths, mCompletePaths, mPathRanks);
+    rankPaths (maxPaths, mCompletePaths, mPathRanks, continueCallback);
 }
 
 static bool isDefaultPath (STPath const& path)
@@ -479,7 +486,8 @@ static STPath removeIssuer (STPath const& path)
 void Pathfinder::rankPaths (
     int maxPaths,
     STPathSet const& paths,
-    std::vector <PathRank>& rankedPaths)
+    std::vector <PathRank>& rankedPaths,
+    std::function<bool(void)> const& continueCallback)
 {
     rankedPaths.clear ();
     rankedPaths.reserve (paths.size());
@@ -500,6 +508,9 @@ void Pathfinder::rankPaths (
 
     for (int i = 0; i < paths.size (); ++i)
     {
+        if (continueCallback && ! continueCallback ())
+            break;
+
         auto const& currentPath = paths[i];
         if (! currentPath.empty())
         {
@@ -719,35 +730,25 @@ int Pathfinder::getPathsOut (
     {
         count = app_.getOrderBookDB ().getBookSize (issue);
 
-        for (auto const& item : mRLCache->getRippleLines (account))
-        {
-            RippleState* rspEntry = (RippleState*) item.get ();
+        auto const out = mRLCache->getPathsOut (account, currency);
+        count += bAuthRequired ? out.authorized : out.any;
 
-            if (currency != rspEntry->getLimit ().getCurrency ())
-            {
-            }
-            else if (rspEntry->getBalance () <= beast::zero &&
-                     (!rspEntry->getLimitPeer ()
-                      || -rspEntry->getBalance () >= rspEntry->getLimitPeer ()
-                      ||  (bAuthRequired && !rspEntry->getAuth ())))
-            {
-            }
-            else if (isDstCurrency &&
-                     dstAccount == rspEntry->getAccountIDPeer ())
-            {
-                count += 10000; // count a path to the destination extra
-            }
-            else if (rspEntry->getNoRipplePeer ())
-            {
-                // This probably isn't a useful path out
-            }
-            else if (rspEntry->getFreezePeer ())
-            {
-                // Not a useful path out
-            }
-            else
+        if (isDstCurrency && dstAccount != account)
+        {
+            // count a path to the destination extra
+            auto const sle = mLedger->read (
+                keylet::line (account, dstAccount, currency));
+            auto const line = sle ?
+                RippleState::makeItem (account, sle) : nullptr;
+
+            if (line &&
+                RippleLineCache::canSendOut (*line, bAuthRequired))
             {
-                ++count;
+                count += 10000;
+
+                // Don't count it twice
+                if (!line->getNoRipplePeer () && !line->getFreezePeer ())
+                    --count;
             }
         }
     }
@@ -25,6 +25,7 @@
 #include <ripple/core/LoadEvent.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STPathSet.h>
+#include <functional>
 
 namespace ripple {
 
@@ -53,10 +54,19 @@ public:
 
     static void initPathTable ();
 
-    bool findPaths (int searchLevel);
+    /** Find candidate paths up to the given search level.
+
+        @param continueCallback Invocable that returns whether to keep
+                                searching. Paths found so far are kept.
+    */
+    bool findPaths (
+        int searchLevel,
+        std::function<bool(void)> const& continueCallback = {});
 
     /** Compute the rankings of the paths. */
-    void computePathRanks (int maxPaths);
+    void computePathRanks (
+        int maxPaths,
+        std::function<bool(void)> const& continueCallback = {});
 
     /* Get the best paths, up to maxPaths in number, from mCompletePaths.
 
@@ -168,7 +178,8 @@ private:
     void rankPaths (
         int maxPaths,
         STPathSet const& paths,
-        std::vector <PathRank>& rankedPaths);
+        std::vector <PathRank>& rankedPaths,
+        std::function<bool(void)> const& continueCallback = {});
 
     AccountID mSrcAccount;
     AccountID mDstAccount;
@@ -19,6 +19,9 @@
 
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/STArray.h>
+#include <boost/container/flat_set.hpp>
 
 namespace ripple {
 
@@ -31,21 +34,122 @@ RippleLineCache::RippleLineCache(
     mLedger = std::make_shared<OpenView>(&*ledger, ledger);
 }
 
-std::vector<RippleState::pointer> const&
-RippleLineCache::getRippleLines (AccountID const& accountID)
+RippleLineCache::RippleLineCache(
+    std::shared_ptr <ReadView const> const& ledger,
+    RippleLineCache& parent)
+    : hasher_ (parent.hasher_)
+{
+    assert (! ledger->open());
+    assert (ledger->info().parentHash == parent.getLedger()->info().hash);
+
+    mLedger = std::make_shared<OpenView>(&*ledger, ledger);
+
+    // Every trust line a transaction created, changed or deleted
+    // is in its metadata, along with both of the line's accounts.
+    boost::container::flat_set<AccountID> touched;
+    for (auto const& tx : ledger->txs)
+    {
+        if (! tx.second)
+            continue;
+
+        for (auto const& node : tx.second->getFieldArray (sfAffectedNodes))
+        {
+            if (node.getFieldU16 (sfLedgerEntryType) != ltRIPPLE_STATE)
+                continue;
+
+            auto const data = dynamic_cast<STObject const*> (
+                node.peekAtPField (node.getFName () == sfCreatedNode ?
+                    sfNewFields : sfFinalFields));
+
+            if (data && data->isFieldPresent (sfLowLimit) &&
+                data->isFieldPresent (sfHighLimit))
+            {
+                touched.insert (data->getFieldAmount (sfLowLimit).getIssuer ());
+                touched.insert (data->getFieldAmount (sfHighLimit).getIssuer ());
+            }
+        }
+    }
+
+    std::lock_guard <std::mutex> sl (parent.mLock);
+    lines_.reserve (parent.lines_.size ());
+    for (auto const& entry : parent.lines_)
+    {
+        // Carrying over accounts nothing looked up for a whole ledger
+        // would keep every account ever seen alive in the chain.
+        if (entry.second.used && touched.count (entry.first.account_) == 0)
+            lines_.emplace (entry.first, Entry {entry.second.lines, false});
+    }
+    inherited_ = lines_.size ();
+}
+
+bool
+RippleLineCache::canSendOut (RippleState const& line, bool authRequired)
+{
+    if (line.getBalance () > beast::zero)
+        return true;
+
+    return line.getLimitPeer () &&
+        -line.getBalance () < line.getLimitPeer () &&
+        (! authRequired || line.getAuth ());
+}
+
+RippleLineCache::Lines const&
+RippleLineCache::getLines (AccountID const& accountID)
 {
     AccountKey key (accountID, hasher_ (accountID));
 
+    {
+        std::lock_guard <std::mutex> sl (mLock);
+
+        auto const it = lines_.find (key);
+        if (it != lines_.end ())
+        {
+            it->second.used = true;
+            return *it->second.lines;
+        }
+    }
+
+    // Read the lines without holding the lock, so that path requests
+    // sharing this cache don't wait on each other. If two of them race
+    // for the same account, the first result is kept.
+    auto lines = std::make_shared<Lines> ();
+    lines->items = getRippleStateItems (accountID, *mLedger);
+
+    for (auto const& item : lines->items)
+    {
+        if (item->getNoRipplePeer () || item->getFreezePeer ())
+            continue;
+
+        auto& out = lines->pathsOut[item->getLimit ().getCurrency ()];
+        if (canSendOut (*item, false))
+            ++out.any;
+        if (canSendOut (*item, true))
+            ++out.authorized;
+    }
+
     std::lock_guard <std::mutex> sl (mLock);
+    auto& entry = lines_.emplace (
+        key, Entry {std::move (lines), true}).first->second;
+    entry.used = true;
+    return *entry.lines;
+}
 
-    auto it = lines_.emplace (key,
-        std::vector<RippleState::pointer>());
+std::vector<RippleState::pointer> const&
+RippleLineCache::getRippleLines (AccountID const& accountID)
+{
+    return getLines (accountID).items;
+}
 
-    if (it.second)
-        it.first->second = getRippleStateItems (
-            accountID, *mLedger);
+RippleLineCache::PathsOut
+RippleLineCache::getPathsOut (
+    AccountID const& accountID, Currency const& currency)
+{
+    auto const& pathsOut = getLines (accountID).pathsOut;
 
-    return it.first->second;
+    auto const it = pathsOut.find (currency);
+    if (it == pathsOut.end ())
+        return {};
+    return it->second;
 }
 
 } // ripple
@@ -23,6 +23,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/RippleState.h>
 #include <ripple/basics/hardened_hash.h>
+#include <ripple/protocol/UintTypes.h>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -34,10 +35,39 @@ namespace ripple {
 class RippleLineCache
 {
 public:
+    /** Trust lines of an account, in one currency, that are paths out.
+
+        These are the lines Pathfinder::getPathsOut counts: lines that
+        can take funds from the account, and that the peer allows to
+        ripple and has not frozen.
+    */
+    struct PathsOut
+    {
+        // When the account does not require authorization
+        int any = 0;
+
+        // When the account requires authorization
+        int authorized = 0;
+    };
+
     explicit
     RippleLineCache (
         std::shared_ptr <ReadView const> const& l);
 
+    /** Create a cache for the ledger that follows the ledger of `parent`.
+
+        The lines of accounts with no trust line touched by a transaction
+        in `ledger` are carried over from `parent`, so a new ledger only
+        costs reading the lines that actually changed. Only accounts that
+        were looked up in `parent` are carried over, so accounts nobody
+        asks about any more drop out of the chain after one ledger.
+
+        @param ledger A closed ledger whose parent is parent.getLedger().
+    */
+    RippleLineCache (
+        std::shared_ptr <ReadView const> const& ledger,
+        RippleLineCache& parent);
+
     std::shared_ptr <ReadView const> const&
     getLedger () const
     {
@@ -47,7 +77,36 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines (AccountID const& accountID);
 
+    PathsOut
+    getPathsOut (AccountID const& accountID, Currency const& currency);
+
+    /** Returns `true` if funds can move out of the account on a line.
+
+        @param authRequired Whether the account requires authorization.
+    */
+    static
+    bool
+    canSendOut (RippleState const& line, bool authRequired);
+
+    /** Returns the number of accounts whose lines were carried over from
+        the parent cache when this one was created.
+    */
+    std::size_t
+    inherited () const
+    {
+        return inherited_;
+    }
+
 private:
+    struct Lines
+    {
+        std::vector <RippleState::pointer> items;
+        hash_map <Currency, PathsOut> pathsOut;
+    };
+
+    Lines const&
+    getLines (AccountID const& accountID);
+
     std::mutex mLock;
 
     ripple::hardened_hash<> hasher_;
@@ -91,10 +150,21 @@ private:
         };
     };
 
+    struct Entry
+    {
+        // Shared with the caches of later ledgers
+        std::shared_ptr <Lines const> lines;
+
+        // Whether the account was looked up in this cache
+        bool used;
+    };
+
     hash_map <
         AccountKey,
-        std::vector <RippleState::pointer>,
+        Entry,
         AccountKey::Hash> lines_;
+
+    std::size_t inherited_ = 0;
 };
 
 } // ripple
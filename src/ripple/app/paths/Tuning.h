@@ -20,6 +20,8 @@
 #ifndef RIPPLE_APP_PATHS_TUNING_H_INCLUDED
 #define RIPPLE_APP_PATHS_TUNING_H_INCLUDED
 
+#include <chrono>
+
 namespace ripple {
 
 int const CALC_NODE_DELIVER_MAX_LOOPS = 100;
@@ -31,6 +33,13 @@ int const PATHFINDER_MAX_PATHS = 50;
 int const PATHFINDER_MAX_COMPLETE_PATHS = 1000;
 int const PATHFINDER_MAX_PATHS_FROM_SOURCE = 10;
 
+// How long a single path request may search during a full update before
+// it replies with the paths found so far.
+std::chrono::seconds const PATHFINDER_UPDATE_DEADLINE {5};
+
+// The fewest path requests worth handing to an extra worker thread.
+int const PATHFINDER_MIN_REQUESTS_PER_WORKER = 2;
+
 } // ripple
 
 #endif
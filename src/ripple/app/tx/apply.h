@@ -27,11 +27,13 @@
 #include <ripple/beast/utility/Journal.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
 class Application;
 class HashRouter;
+struct PreflightResult;
 
 /** Describes the pre-processing validity of a transaction.
 
@@ -65,6 +67,19 @@ checkValidity(HashRouter& router,
     STTx const& tx, Rules const& rules,
         Config const& config);
 
+/** Checks the signatures of several transactions at once.
+
+    Signatures are verified as a batch where possible. The results
+    are cached as `checkValidity` would cache them, so a later call
+    to `checkValidity` for any of these transactions only performs
+    the local checks.
+
+    @see checkValidity
+*/
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules);
 
 /** Sets the validity of a given transaction in the cache.
 
@@ -152,6 +167,21 @@ applyTransaction(Application& app, OpenView& view,
     STTx const& tx, bool retryAssured, ApplyFlags flags,
     beast::Journal journal);
 
+/** Transaction application helper for a transaction that
+    has already passed through `preflight`.
+
+    `preflight` does not depend on the ledger, so its result
+    can be computed ahead of time, possibly on another thread.
+    The flags used are those given to `preflight`, including
+    `tapRETRY` if retry is assured.
+
+    @see ApplyResult, preflight
+*/
+ApplyResult
+applyTransaction(Application& app, OpenView& view,
+    PreflightResult const& preflightResult,
+    beast::Journal journal);
+
 } // ripple
 
 #endif
@@ -81,6 +81,32 @@ checkValidity(HashRouter& router,
     return {Validity::Valid, ""};
 }
 
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules)
+{
+    // Only check the signatures we don't already know
+    std::vector<STTx const*> unknown;
+    unknown.reserve(txs.size());
+    for (auto const& tx : txs)
+    {
+        auto const flags = router.getFlags(tx->getTransactionID());
+        if (!(flags & (SF_SIGBAD | SF_SIGGOOD)))
+            unknown.push_back(tx.get());
+    }
+    if (unknown.empty())
+        return;
+
+    auto const results = STTx::checkSignBatch(unknown,
+        rules.enabled(featureMultiSign));
+    for (std::size_t i = 0; i < unknown.size(); ++i)
+    {
+        router.setFlags(unknown[i]->getTransactionID(),
+            results[i].first ? SF_SIGGOOD : SF_SIGBAD);
+    }
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid,
     Validity validity)
@@ -113,6 +139,31 @@ apply (Application& app, OpenView& view,
     return doApply(pcresult, app, view);
 }
 
+static
+ApplyResult
+applyResult (std::pair<TER, bool> const& result, beast::Journal j)
+{
+    if (result.second)
+    {
+        JLOG (j.debug())
+            << "Transaction applied: " << transHuman (result.first);
+        return ApplyResult::Success;
+    }
+
+    if (isTefFailure (result.first) || isTemMalformed (result.first) ||
+        isTelLocal (result.first))
+    {
+        // failure
+        JLOG (j.debug())
+            << "Transaction failure: " << transHuman (result.first);
+        return ApplyResult::Fail;
+    }
+
+    JLOG (j.debug())
+        << "Transaction retry: " << transHuman (result.first);
+    return ApplyResult::Retry;
+}
+
 ApplyResult
 applyTransaction (Application& app, OpenView& view,
     STTx const& txn,
@@ -131,27 +182,30 @@ applyTransaction (Application& app, OpenView& view,
 
     try
     {
-        auto const result = apply(app,
-            view, txn, flags, j);
-        if (result.second)
-        {
-            JLOG (j.debug())
-                << "Transaction applied: " << transHuman (result.first);
-            return ApplyResult::Success;
-        }
+        return applyResult (apply(app,
+            view, txn, flags, j), j);
+    }
+    catch (std::exception const&)
+    {
+        JLOG (j.warn()) << "Throws";
+        return ApplyResult::Fail;
+    }
+}
 
-        if (isTefFailure (result.first) || isTemMalformed (result.first) ||
-            isTelLocal (result.first))
-        {
-            // failure
-            JLOG (j.debug())
-                << "Transaction failure: " << transHuman (result.first);
-            return ApplyResult::Fail;
-        }
+ApplyResult
+applyTransaction (Application& app, OpenView& view,
+    PreflightResult const& preflightResult,
+        beast::Journal j)
+{
+    JLOG (j.debug()) << "TXN "
+        << preflightResult.tx.getTransactionID ()
+        << ((preflightResult.flags & tapRETRY) ? "/retry" : "/final");
 
-        JLOG (j.debug())
-            << "Transaction retry: " << transHuman (result.first);
-        return ApplyResult::Retry;
+    try
+    {
+        STAmountSO saved(view.info().parentCloseTime);
+        auto pcresult = preclaim(preflightResult, app, view);
+        return applyResult (doApply(pcresult, app, view), j);
     }
     catch (std::exception const&)
     {
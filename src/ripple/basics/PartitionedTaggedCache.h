@@ -0,0 +1,291 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+#define RIPPLE_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+
+#include <ripple/basics/TaggedCache.h>
+#include <ripple/basics/hardened_hash.h>
+#include <ripple/beast/hash/xxhasher.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** A TaggedCache split into independently locked partitions.
+
+    Each key is assigned to one of a fixed number of partitions using
+    the hash of the key. Every partition is a complete TaggedCache with
+    its own mutex, map and expiration bookkeeping, so threads operating
+    on keys in different partitions never contend. The target size is
+    divided evenly between the partitions and each partition is swept
+    on its own.
+
+    The interface mirrors TaggedCache, except that there is no single
+    mutex to expose through `peekMutex`.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = hardened_hash <>,
+    class KeyEqual = std::equal_to <Key>,
+    class Mutex = std::recursive_mutex
+>
+class PartitionedTaggedCache
+{
+public:
+    using partition_type = TaggedCache <Key, T, Hash, KeyEqual, Mutex>;
+    using key_type = Key;
+    using mapped_type = T;
+    using weak_mapped_ptr = std::weak_ptr <mapped_type>;
+    using mapped_ptr = std::shared_ptr <mapped_type>;
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    /** The number of partitions used when none is specified. */
+    static std::size_t constexpr defaultPartitions = 16;
+
+public:
+    PartitionedTaggedCache (std::string const& name, int size,
+        clock_type::duration expiration, clock_type& clock, beast::Journal journal,
+            beast::insight::Collector::ptr const& collector = beast::insight::NullCollector::New (),
+                std::size_t partitions = defaultPartitions)
+        : m_clock (clock)
+        , m_stats (name,
+            std::bind (&PartitionedTaggedCache::collect_metrics, this),
+                collector)
+        , m_seed (detail::make_seed_pair<> ().first)
+        , m_target_size (size)
+    {
+        assert (partitions != 0);
+        m_partitions.reserve (partitions);
+        for (std::size_t i = 0; i < partitions; ++i)
+            m_partitions.emplace_back (std::make_unique <partition_type> (
+                name, partitionSize (size, partitions), expiration,
+                    clock, journal));
+    }
+
+public:
+    /** Return the clock associated with the cache. */
+    clock_type& clock ()
+    {
+        return m_clock;
+    }
+
+    std::size_t partitions () const
+    {
+        return m_partitions.size ();
+    }
+
+    int getTargetSize () const
+    {
+        return m_target_size;
+    }
+
+    void setTargetSize (int s)
+    {
+        m_target_size = s;
+        for (auto& p : m_partitions)
+            p->setTargetSize (partitionSize (s, m_partitions.size ()));
+    }
+
+    clock_type::duration getTargetAge () const
+    {
+        return m_partitions.front ()->getTargetAge ();
+    }
+
+    void setTargetAge (clock_type::duration s)
+    {
+        for (auto& p : m_partitions)
+            p->setTargetAge (s);
+    }
+
+    int getCacheSize () const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getCacheSize ();
+        return size;
+    }
+
+    int getTrackSize () const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getTrackSize ();
+        return size;
+    }
+
+    float getHitRate ()
+    {
+        auto const counts = getHitsAndMisses ();
+        auto const total = static_cast<float> (counts.first + counts.second);
+        return counts.first * (100.0f / std::max (1.0f, total));
+    }
+
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        std::pair <std::uint64_t, std::uint64_t> counts { 0, 0 };
+        for (auto const& p : m_partitions)
+        {
+            auto const c = p->getHitsAndMisses ();
+            counts.first += c.first;
+            counts.second += c.second;
+        }
+        return counts;
+    }
+
+    void clear ()
+    {
+        for (auto& p : m_partitions)
+            p->clear ();
+    }
+
+    void reset ()
+    {
+        for (auto& p : m_partitions)
+            p->reset ();
+    }
+
+    /** Sweep each partition in turn.
+
+        Only one partition is locked at a time, so lookups in the other
+        partitions proceed while the sweep is running.
+    */
+    void sweep ()
+    {
+        for (auto& p : m_partitions)
+            p->sweep ();
+    }
+
+    bool del (const key_type& key, bool valid)
+    {
+        return partition (key).del (key, valid);
+    }
+
+    /** Replace aliased objects with originals.
+
+        @see TaggedCache::canonicalize
+    */
+    bool canonicalize (const key_type& key, std::shared_ptr<T>& data, bool replace = false)
+    {
+        return partition (key).canonicalize (key, data, replace);
+    }
+
+    std::shared_ptr<T> fetch (const key_type& key)
+    {
+        return partition (key).fetch (key);
+    }
+
+    bool insert (key_type const& key, T const& value)
+    {
+        return partition (key).insert (key, value);
+    }
+
+    bool retrieve (const key_type& key, T& data)
+    {
+        return partition (key).retrieve (key, data);
+    }
+
+    bool refreshIfPresent (const key_type& key)
+    {
+        return partition (key).refreshIfPresent (key);
+    }
+
+    std::vector <key_type> getKeys () const
+    {
+        std::vector <key_type> v;
+        for (auto const& p : m_partitions)
+        {
+            auto keys = p->getKeys ();
+            v.insert (v.end (), keys.begin (), keys.end ());
+        }
+        return v;
+    }
+
+private:
+    static int partitionSize (int size, std::size_t partitions)
+    {
+        // Zero means "no target" and must stay that way
+        if (size <= 0)
+            return size;
+        auto const n = static_cast<int> (partitions);
+        return (size + n - 1) / n;
+    }
+
+    partition_type& partition (key_type const& key)
+    {
+        // The partitions hash with the same per-process seed, so rehash
+        // with our own seed to keep the choice of partition independent
+        // of the bucket chosen within it.
+        auto const h = m_hash (key);
+        beast::xxhasher mix (m_seed);
+        mix (&h, sizeof (h));
+        return *m_partitions[
+            static_cast<std::size_t> (mix) % m_partitions.size ()];
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (getCacheSize ());
+
+        {
+            beast::insight::Gauge::value_type hit_rate (0);
+            auto const counts = getHitsAndMisses ();
+            auto const total (counts.first + counts.second);
+            if (total != 0)
+                hit_rate = (counts.first * 100) / total;
+            m_stats.hit_rate.set (hit_rate);
+        }
+    }
+
+private:
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+    };
+
+    clock_type& m_clock;
+    Stats m_stats;
+
+    // Selects the partition, together with m_seed
+    Hash const m_hash;
+    std::uint64_t const m_seed;
+
+    // Desired number of cache entries across all partitions (0 = ignore)
+    std::atomic <int> m_target_size;
+
+    std::vector <std::unique_ptr <partition_type>> m_partitions;
+};
+
+}
+
+#endif
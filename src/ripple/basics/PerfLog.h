@@ -121,6 +121,16 @@ public:
     virtual void jobFinish(JobType const type,
         microseconds dur, int instance) = 0;
 
+    /**
+     * Log rebuild of the open ledger after a ledger closes
+     *
+     * @param dur Duration of the rebuild in microseconds
+     * @param locked Duration that modifications to the open ledger
+     *               were blocked in microseconds
+     */
+    virtual void openLedgerAccept(microseconds dur,
+        microseconds locked) = 0;
+
     /**
      * Render performance counters in Json
      *
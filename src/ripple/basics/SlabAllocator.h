@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+#define RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+
+#include <boost/align/aligned_alloc.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace ripple {
+
+/** Allocates fixed-size blocks of raw memory carved out of large slabs.
+
+    Intended for very large numbers of small, equally sized objects, where
+    a general purpose allocator would add a header to every block and
+    scatter them across the heap.
+
+    The slabs are split between a number of stripes, each with its own
+    lock. A thread always allocates from the same stripe, so threads
+    mostly take different locks. A freed block goes back to the slab it
+    came from, found by masking its address, since slabs are aligned to
+    their size. A slab whose blocks have all been freed is released,
+    except for one per stripe which is kept to avoid repeatedly
+    releasing and allocating a slab at the boundary.
+
+    Blocks are aligned like memory returned by operator new.
+
+    @note This can be called concurrently.
+*/
+class SlabAllocator
+{
+public:
+    /** The number of independently locked stripes. */
+    static std::size_t constexpr stripes = 16;
+
+    /** Create an allocator.
+
+        @param blockSize The size of each block, in bytes.
+        @param slabSize The size of each slab, in bytes. This must be a
+                        power of two with room for at least one block.
+    */
+    SlabAllocator (std::size_t blockSize, std::size_t slabSize)
+        : blockSize_ (roundUp (std::max (blockSize, sizeof (FreeBlock))))
+        , slabSize_ (slabSize)
+        , blocksPerSlab_ ((slabSize_ - headerSize ()) / blockSize_)
+    {
+        assert ((slabSize_ & (slabSize_ - 1)) == 0);
+        assert (slabSize_ > headerSize ());
+        assert (blocksPerSlab_ != 0);
+    }
+
+    SlabAllocator (SlabAllocator const&) = delete;
+    SlabAllocator& operator= (SlabAllocator const&) = delete;
+
+    ~SlabAllocator ()
+    {
+        for (auto& stripe : stripes_)
+        {
+            while (auto const slab = stripe.slabs)
+            {
+                stripe.slabs = slab->next;
+                boost::alignment::aligned_free (slab);
+            }
+        }
+    }
+
+    /** Return the size of each block, in bytes. */
+    std::size_t
+    blockSize () const
+    {
+        return blockSize_;
+    }
+
+    /** Return the number of blocks carved out of each slab. */
+    std::size_t
+    blocksPerSlab () const
+    {
+        return blocksPerSlab_;
+    }
+
+    /** Return an uninitialized block of blockSize() bytes. */
+    void*
+    allocate ()
+    {
+        auto& stripe = stripes_[threadStripe ()];
+        std::lock_guard <std::mutex> lock (stripe.mutex);
+
+        // Slabs with free blocks are kept at the front of the list
+        auto slab = stripe.slabs;
+        if (! slab || slab->used == blocksPerSlab_)
+            slab = grow (stripe);
+
+        if (slab->used++ == 0)
+        {
+            assert (stripe.empty != 0);
+            --stripe.empty;
+        }
+
+        void* block;
+        if (slab->free)
+        {
+            block = slab->free;
+            slab->free = slab->free->next;
+        }
+        else
+        {
+            // Blocks are only touched when first handed out
+            block = reinterpret_cast<std::uint8_t*> (slab) +
+                headerSize () + slab->carved++ * blockSize_;
+        }
+
+        if (slab->used == blocksPerSlab_)
+            moveToBack (stripe, slab);
+
+        ++used_;
+        return block;
+    }
+
+    /** Return a block obtained from allocate() for reuse. */
+    void
+    deallocate (void* p)
+    {
+        assert (p);
+        auto const slab = reinterpret_cast<Slab*> (
+            reinterpret_cast<std::uintptr_t> (p) & ~(slabSize_ - 1));
+        auto& stripe = *slab->stripe;
+        std::lock_guard <std::mutex> lock (stripe.mutex);
+
+        auto const block = static_cast<FreeBlock*> (p);
+        block->next = slab->free;
+        slab->free = block;
+
+        assert (slab->used != 0);
+        if (slab->used-- == blocksPerSlab_)
+            moveToFront (stripe, slab);
+
+        if (slab->used == 0 && ++stripe.empty > 1)
+        {
+            --stripe.empty;
+            unlink (stripe, slab);
+            boost::alignment::aligned_free (slab);
+            --slabs_;
+        }
+
+        assert (used_ != 0);
+        --used_;
+    }
+
+    /** Return the number of blocks currently handed out. */
+    std::size_t
+    used () const
+    {
+        return used_;
+    }
+
+    /** Return the number of bytes held in slabs. */
+    std::size_t
+    reserved () const
+    {
+        return slabs_ * slabSize_;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Stripe;
+
+    // Stored at the start of each slab, followed by the blocks
+    struct Slab
+    {
+        Stripe* stripe;
+        Slab* prev;
+        Slab* next;
+        FreeBlock* free;
+        std::size_t used;
+        std::size_t carved;
+    };
+
+    struct Stripe
+    {
+        std::mutex mutex;
+        // Every slab of the stripe, those with free blocks first
+        Slab* slabs = nullptr;
+        Slab* last = nullptr;
+        // Slabs with no blocks handed out
+        std::size_t empty = 0;
+    };
+
+    static
+    std::size_t
+    roundUp (std::size_t size)
+    {
+        auto constexpr align = alignof (std::max_align_t);
+        return (size + align - 1) / align * align;
+    }
+
+    static
+    std::size_t
+    headerSize ()
+    {
+        return roundUp (sizeof (Slab));
+    }
+
+    // Threads are spread over the stripes in the order they first allocate
+    static
+    std::size_t
+    threadStripe ()
+    {
+        static std::atomic <std::size_t> next {0};
+        thread_local std::size_t const index = next++ % stripes;
+        return index;
+    }
+
+    // Called with the stripe's lock held
+    Slab*
+    grow (Stripe& stripe)
+    {
+        auto const p = boost::alignment::aligned_alloc (slabSize_, slabSize_);
+        if (! p)
+            throw std::bad_alloc ();
+
+        auto const slab = static_cast<Slab*> (p);
+        slab->stripe = &stripe;
+        slab->prev = nullptr;
+        slab->next = nullptr;
+        slab->free = nullptr;
+        slab->used = 0;
+        slab->carved = 0;
+        pushFront (stripe, slab);
+        ++stripe.empty;
+        ++slabs_;
+        return slab;
+    }
+
+    static
+    void
+    unlink (Stripe& stripe, Slab* slab)
+    {
+        if (slab->prev)
+            slab->prev->next = slab->next;
+        else
+            stripe.slabs = slab->next;
+        if (slab->next)
+            slab->next->prev = slab->prev;
+        else
+            stripe.last = slab->prev;
+        slab->prev = nullptr;
+        slab->next = nullptr;
+    }
+
+    static
+    void
+    pushFront (Stripe& stripe, Slab* slab)
+    {
+        slab->next = stripe.slabs;
+        if (stripe.slabs)
+            stripe.slabs->prev = slab;
+        else
+            stripe.last = slab;
+        stripe.slabs = slab;
+    }
+
+    static
+    void
+    moveToFront (Stripe& stripe, Slab* slab)
+    {
+        unlink (stripe, slab);
+        pushFront (stripe, slab);
+    }
+
+    static
+    void
+    moveToBack (Stripe& stripe, Slab* slab)
+    {
+        unlink (stripe, slab);
+        slab->prev = stripe.last;
+        if (stripe.last)
+            stripe.last->next = slab;
+        else
+            stripe.slabs = slab;
+        stripe.last = slab;
+    }
+
+    std::size_t const blockSize_;
+    std::size_t const slabSize_;
+    std::size_t const blocksPerSlab_;
+
+    std::array <Stripe, stripes> stripes_;
+    std::atomic <std::size_t> used_ {0};
+    std::atomic <std::size_t> slabs_ {0};
+};
+
+} // ripple
+
+#endif
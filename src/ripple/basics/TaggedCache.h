@@ -145,6 +145,13 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    /** Return the raw hit and miss counters. */
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        lock_guard lock (m_mutex);
+        return { m_hits, m_misses };
+    }
+
     void clear ()
     {
         lock_guard lock (m_mutex);
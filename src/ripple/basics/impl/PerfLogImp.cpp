@@ -166,11 +166,27 @@ PerfLogImp::Counters::countersJson() const
         jqobj[jss::total] = totalJqJson;
     }
 
+    Json::Value olobj(Json::objectValue);
+    {
+        auto const sync = [this]() {
+            std::lock_guard<std::mutex> lock(openLedger_.mut);
+            return openLedger_.sync;
+        }();
+        if (sync.accepted)
+        {
+            olobj[jss::accepted] = std::to_string(sync.accepted);
+            olobj[jss::duration_us] = std::to_string(sync.duration.count());
+            olobj[jss::locked_duration_us] = std::to_string(
+                sync.lockedDuration.count());
+        }
+    }
+
     Json::Value counters(Json::objectValue);
     // Be kind to reporting tools and let them expect rpc and jq objects
     // even if empty.
     counters[jss::rpc] = rpcobj;
     counters[jss::job_queue] = jqobj;
+    counters[jss::open_ledger] = olobj;
     return counters;
 }
 
@@ -439,6 +455,15 @@ PerfLogImp::jobFinish(JobType const type, microseconds dur,
         counters_.jobs_[instance] = {jtINVALID, steady_time_point()};
 }
 
+void
+PerfLogImp::openLedgerAccept(microseconds dur, microseconds locked)
+{
+    std::lock_guard<std::mutex> lock(counters_.openLedger_.mut);
+    ++counters_.openLedger_.sync.accepted;
+    counters_.openLedger_.sync.duration += dur;
+    counters_.openLedger_.sync.lockedDuration += locked;
+}
+
 void
 PerfLogImp::resizeJobs(int const resize)
 {
@@ -116,10 +116,33 @@ class PerfLogImp
             {}
         };
 
+        /**
+         * Open ledger rebuild performance counters.
+         */
+        struct OpenLedger
+        {
+            // Keep all items that need to be synchronized in one place
+            // to minimize copy overhead while locked.
+            struct Sync
+            {
+                // Counter for each time the open ledger is rebuilt.
+                std::uint64_t accepted {0};
+
+                // Cumulative duration of all rebuilds, and of the part
+                // of them that blocked modifications to the open ledger.
+                microseconds duration {0};
+                microseconds lockedDuration {0};
+            };
+
+            Sync sync;
+            mutable std::mutex mut;
+        };
+
         // rpc_ and jq_ do not need mutex protection because all
         // keys and values are created before more threads are started.
         std::unordered_map<std::string, Rpc> rpc_;
         std::unordered_map<std::underlying_type_t<JobType>, Jq> jq_;
+        OpenLedger openLedger_;
         std::vector<std::pair<JobType, steady_time_point>> jobs_;
         int workers_ {0};
         mutable std::mutex jobsMutex_;
@@ -187,6 +210,10 @@ public:
         microseconds dur,
         int instance) override;
 
+    void openLedgerAccept(
+        microseconds dur,
+        microseconds locked) override;
+
     Json::Value
     countersJson() const override
     {
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SPINLOCK_H_INCLUDED
+#define RIPPLE_BASICS_SPINLOCK_H_INCLUDED
+
+#include <atomic>
+#include <thread>
+
+namespace ripple {
+
+/** A minimal, single-byte spin lock.
+
+    Intended for protecting a few words of state for a handful of
+    instructions, where a std::mutex would be too large to embed in
+    every object or too costly to acquire. Satisfies the Lockable
+    requirements so it can be used with std::lock_guard.
+
+    Never hold a spinlock across anything that can block.
+*/
+class spinlock
+{
+public:
+    spinlock() = default;
+    spinlock(spinlock const&) = delete;
+    spinlock& operator=(spinlock const&) = delete;
+
+    bool
+    try_lock() noexcept
+    {
+        return !flag_.test_and_set(std::memory_order_acquire);
+    }
+
+    void
+    lock() noexcept
+    {
+        for (int spins = 0; !try_lock(); ++spins)
+        {
+            if (spins >= 64)
+                std::this_thread::yield();
+        }
+    }
+
+    void
+    unlock() noexcept
+    {
+        flag_.clear(std::memory_order_release);
+    }
+
+private:
+    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+};
+
+} // ripple
+
+#endif
@@ -145,6 +145,7 @@ public:
 
     // Peer networking parameters
     bool                        PEER_PRIVATE = false;           // True to ask peers not to relay current IP.
+    bool                        COMPRESSION = false;            // True to compress messages to peers that support it.
     int                         PEERS_MAX = 0;
 
     std::chrono::seconds        WEBSOCKET_PING_FREQ = std::chrono::minutes {5};
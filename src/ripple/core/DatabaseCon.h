@@ -23,8 +23,11 @@
 #include <ripple/core/Config.h>
 #include <ripple/core/SociDB.h>
 #include <boost/filesystem/path.hpp>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <typeindex>
 
 
 namespace soci {
@@ -101,6 +104,23 @@ public:
         return LockedSociSession (&session_, lock_);
     }
 
+    /** Return an object of type T kept for the life of the session.
+
+        The object is constructed from the session the first time it is
+        asked for. This lets statements prepared on the session, and the
+        values bound to them, be reused across checkouts.
+
+        @note The caller must have the session checked out.
+    */
+    template <class T>
+    T& getCached ()
+    {
+        auto& p = cache_[std::type_index (typeid (T))];
+        if (! p)
+            p = std::make_shared<T> (session_);
+        return *std::static_pointer_cast<T> (p);
+    }
+
     void setupCheckpointing (JobQueue*, Logs&);
 
 private:
@@ -108,6 +128,9 @@ private:
 
     soci::session session_;
     std::unique_ptr<Checkpointer> checkpointer_;
+
+    // Declared after the session, so that it is destroyed first.
+    std::map<std::type_index, std::shared_ptr<void>> cache_;
 };
 
 DatabaseCon::Setup
@@ -28,6 +28,7 @@
 #include <ripple/core/impl/Workers.h>
 #include <ripple/json/json_value.h>
 #include <boost/coroutine/all.hpp>
+#include <atomic>
 
 namespace ripple {
 
@@ -216,14 +217,26 @@ private:
     using JobDataMap = std::map <JobType, JobTypeData>;
 
     beast::Journal m_journal;
+
+    // Guards the stop and rendezvous state and nSuspend_. Each job type's
+    // queue and counters are guarded by that type's JobTypeData::mutex,
+    // so adding and running jobs never takes this lock unless the queue
+    // is going idle or stopping.
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    std::set <Job> m_jobSet;
+    std::atomic <std::uint64_t> m_lastJob;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
+    // The number of jobs waiting in the per-type queues
+    std::atomic <std::size_t> m_jobCount {0};
+
+    // One bit per JobType, set while jobs of that type are waiting
+    // and fewer than its limit are running. A bit only changes while
+    // its type's mutex is held.
+    std::atomic <std::uint64_t> m_ready {0};
+
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic <int> m_processCount;
 
     // The number of suspended coroutines
     int nSuspend_ = 0;
@@ -261,40 +274,46 @@ private:
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
+    //  The Job must be at the back of its type's queue.
     //  The Job must not have previously been queued.
     //
     // Post-conditions:
     //  Count of waiting jobs of that type will be incremented.
-    //  If JobQueue exists, and has at least one thread, Job will eventually run.
+    //  Returns true if the caller must signal a task to the workers,
+    //  which it should do after releasing the lock.
     //
     // Invariants:
-    //  The calling thread owns the JobLock
-    void queueJob (Job const& job, std::lock_guard <std::mutex> const& lock);
+    //  The calling thread owns data.mutex
+    bool queueJob (JobTypeData& data, std::lock_guard <std::mutex> const& lock);
 
     // Returns the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A waiting Job whose slots count for its type is greater than zero.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  The calling thread was signalled a task, so some type is runnable.
     //
     // Post-conditions:
-    //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is the oldest Job of the highest priority runnable type.
+    //  job is removed from its type's queue.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
     // Invariants:
-    //  The calling thread owns the JobLock
+    //  Only the chosen type's mutex is taken.
     void getNextJob (Job& job);
 
+    // Recomputes the bit in m_ready for a job type.
+    //
+    // Invariants:
+    //  The calling thread owns data.mutex
+    void updateReady (JobTypeData& data);
+
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
+    //  Job must not be waiting in a queue.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -302,13 +321,13 @@ private:
     //  A new task is signaled if there are more waiting Jobs than the limit, if any.
     //
     // Invariants:
-    //  <none>
+    //  Only the type's mutex is taken.
     void finishJob (JobType type);
 
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must be waiting
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
@@ -21,8 +21,11 @@
 #define RIPPLE_CORE_JOBTYPEDATA_H_INCLUDED
 
 #include <ripple/basics/Log.h>
+#include <ripple/core/Job.h>
 #include <ripple/core/JobTypeInfo.h>
 #include <ripple/beast/insight/Collector.h>
+#include <deque>
+#include <mutex>
 
 namespace ripple
 {
@@ -39,6 +42,9 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
+    /* Guards the queue and the waiting, running and deferred counts */
+    mutable std::mutex mutex;
+
     /* The number of jobs waiting */
     int waiting;
 
@@ -48,6 +54,9 @@ public:
     /* And the number we deferred executing because of job limits */
     int deferred;
 
+    /* The jobs waiting to run, oldest first */
+    std::deque <Job> queue;
+
     /* Notification callbacks */
     beast::insight::Event dequeue;
     beast::insight::Event execute;
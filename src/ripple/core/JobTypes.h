@@ -44,6 +44,7 @@ private:
         using namespace std::chrono_literals;
         int maxLimit = std::numeric_limits <int>::max ();
 
+add(    jtTX_INDEX,      "backfillTxIndex",         1,        false, 0ms,     0ms);
 add(    jtPACK,          "makeFetchPack",           1,        false, 0ms,     0ms);
 add(    jtPUBOLDLEDGER,  "publishAcqLedger",        2,        false, 10000ms, 15000ms);
 add(    jtVALIDATION_ut, "untrustedValidation",     maxLimit, false, 2000ms,  5000ms);
@@ -23,6 +23,9 @@
 
 namespace ripple {
 
+// m_ready holds one bit per job type
+static_assert (jtNS_WRITE < 64, "Too many job types for the ready mask");
+
 JobQueue::JobQueue (beast::insight::Collector::ptr const& collector,
     Stoppable& parent, beast::Journal journal, Logs& logs,
     perf::PerfLog& perfLog)
@@ -65,8 +68,7 @@ JobQueue::~JobQueue ()
 void
 JobQueue::collect ()
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-    job_count = m_jobSet.size ();
+    job_count = m_jobCount.load ();
 }
 
 bool
@@ -86,8 +88,13 @@ JobQueue::addRefCountedJob (JobType type, std::string const& name,
     // do not add jobs to a queue with no threads
     assert (type == jtCLIENT || m_workers.getNumberOfThreads () > 0);
 
+    // Build the job before taking the lock, to keep the
+    // time spent holding it to a minimum.
+    Job job (type, name, ++m_lastJob, data.load (), func, m_cancelCallback);
+
+    bool signal;
     {
-        std::lock_guard <std::mutex> lock (m_mutex);
+        std::lock_guard <std::mutex> lock (data.mutex);
 
         // If this goes off it means that a child didn't follow
         // the Stoppable API rules. A job may only be added if:
@@ -102,39 +109,43 @@ JobQueue::addRefCountedJob (JobType type, std::string const& name,
         //
         assert (! isStopped() && (
             m_processCount>0 ||
-            ! m_jobSet.empty () ||
+            m_jobCount != 0 ||
             ! areChildrenStopped()));
 
-        std::pair <std::set <Job>::iterator, bool> result (
-            m_jobSet.insert (Job (type, name, ++m_lastJob,
-                data.load (), func, m_cancelCallback)));
-        queueJob (*result.first, lock);
+        data.queue.push_back (std::move (job));
+        ++m_jobCount;
+        signal = queueJob (data, lock);
     }
+
+    if (signal)
+        m_workers.addTask ();
     return true;
 }
 
 int
 JobQueue::getJobCount (JobType t) const
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find (t);
 
-    return (c == m_jobData.end ())
-        ? 0
-        : c->second.waiting;
+    if (c == m_jobData.end ())
+        return 0;
+
+    JobTypeData const& data = c->second;
+    std::lock_guard <std::mutex> lock (data.mutex);
+    return data.waiting;
 }
 
 int
 JobQueue::getJobCountTotal (JobType t) const
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find (t);
 
-    return (c == m_jobData.end ())
-        ? 0
-        : (c->second.waiting + c->second.running);
+    if (c == m_jobData.end ())
+        return 0;
+
+    JobTypeData const& data = c->second;
+    std::lock_guard <std::mutex> lock (data.mutex);
+    return data.waiting + data.running;
 }
 
 int
@@ -143,12 +154,14 @@ JobQueue::getJobCountGE (JobType t) const
     // return the number of jobs at this priority level or greater
     int ret = 0;
 
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     for (auto const& x : m_jobData)
     {
         if (x.first >= t)
-            ret += x.second.waiting;
+        {
+            JobTypeData const& data = x.second;
+            std::lock_guard <std::mutex> lock (data.mutex);
+            ret += data.waiting;
+        }
     }
 
     return ret;
@@ -225,8 +238,6 @@ JobQueue::getJson (int c)
 
     Json::Value priorities = Json::arrayValue;
 
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     for (auto& x : m_jobData)
     {
         assert (x.first != jtINVALID);
@@ -238,8 +249,13 @@ JobQueue::getJson (int c)
 
         LoadMonitor::Stats stats (data.stats ());
 
-        int waiting (data.waiting);
-        int running (data.running);
+        int waiting;
+        int running;
+        {
+            std::lock_guard <std::mutex> lock (data.mutex);
+            waiting = data.waiting;
+            running = data.running;
+        }
 
         if ((stats.count != 0) || (waiting != 0) ||
             (stats.latencyPeak != 0ms) || (running != 0))
@@ -280,7 +296,7 @@ JobQueue::rendezvous()
     cv_.wait(lock, [&]
     {
         return m_processCount == 0 &&
-            m_jobSet.empty();
+            m_jobCount == 0;
     });
 }
 
@@ -319,26 +335,25 @@ JobQueue::checkStopped (std::lock_guard <std::mutex> const& lock)
     if (isStopping() &&
         areChildrenStopped() &&
         (m_processCount == 0) &&
-        m_jobSet.empty() &&
+        m_jobCount == 0 &&
         nSuspend_ == 0)
     {
         stopped();
     }
 }
 
-void
-JobQueue::queueJob (Job const& job, std::lock_guard <std::mutex> const& lock)
+bool
+JobQueue::queueJob (JobTypeData& data, std::lock_guard <std::mutex> const& lock)
 {
-    JobType const type (job.getType ());
+    JobType const type (data.type ());
     assert (type != jtINVALID);
-    assert (m_jobSet.find (job) != m_jobSet.end ());
+    assert (! data.queue.empty ());
     perfLog_.jobQueue(type);
 
-    JobTypeData& data (getJobTypeData (type));
-
-    if (data.waiting + data.running < getJobLimit (type))
+    bool signal = false;
+    if (data.waiting + data.running < data.info.limit ())
     {
-        m_workers.addTask ();
+        signal = true;
     }
     else
     {
@@ -347,40 +362,52 @@ JobQueue::queueJob (Job const& job, std::lock_guard <std::mutex> const& lock)
         ++data.deferred;
     }
     ++data.waiting;
+    updateReady (data);
+    return signal;
 }
 
 void
 JobQueue::getNextJob (Job& job)
 {
-    assert (! m_jobSet.empty ());
-
-    std::set <Job>::const_iterator iter;
-    for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+    for (;;)
     {
-        JobTypeData& data (getJobTypeData (iter->getType ()));
+        auto const ready = m_ready.load ();
+        assert (ready != 0);
 
-        assert (data.running <= getJobLimit (data.type ()));
+        // Higher job types have higher priority
+        int t = jtNS_WRITE;
+        while (t > 0 && ! (ready & (std::uint64_t (1) << t)))
+            --t;
 
-        // Run this job if we're running below the limit.
-        if (data.running < getJobLimit (data.type ()))
-        {
-            assert (data.waiting > 0);
-            break;
-        }
-    }
+        JobTypeData& data (getJobTypeData (static_cast<JobType> (t)));
+        std::lock_guard <std::mutex> lock (data.mutex);
 
-    assert (iter != m_jobSet.end ());
+        // Another worker may have taken the last runnable job of
+        // this type after we read the mask; look again.
+        if (data.queue.empty () || data.running >= data.info.limit ())
+            continue;
 
-    JobType const type = iter->getType ();
-    JobTypeData& data (getJobTypeData (type));
+        assert (data.waiting > 0);
 
-    assert (type != jtINVALID);
+        job = std::move (data.queue.front ());
+        data.queue.pop_front ();
+        --m_jobCount;
 
-    job = *iter;
-    m_jobSet.erase (iter);
+        --data.waiting;
+        ++data.running;
+        updateReady (data);
+        return;
+    }
+}
 
-    --data.waiting;
-    ++data.running;
+void
+JobQueue::updateReady (JobTypeData& data)
+{
+    auto const bit = std::uint64_t (1) << data.type ();
+    if (! data.queue.empty () && data.running < data.info.limit ())
+        m_ready.fetch_or (bit);
+    else
+        m_ready.fetch_and (~bit);
 }
 
 void
@@ -390,16 +417,25 @@ JobQueue::finishJob (JobType type)
 
     JobTypeData& data = getJobTypeData (type);
 
-    // Queue a deferred task if possible
-    if (data.deferred > 0)
+    bool signal = false;
     {
-        assert (data.running + data.waiting >= getJobLimit (type));
+        std::lock_guard <std::mutex> lock (data.mutex);
 
-        --data.deferred;
-        m_workers.addTask ();
+        // Queue a deferred task if possible
+        if (data.deferred > 0)
+        {
+            assert (data.running + data.waiting >= getJobLimit (type));
+
+            --data.deferred;
+            signal = true;
+        }
+
+        --data.running;
+        updateReady (data);
     }
 
-    --data.running;
+    if (signal)
+        m_workers.addTask ();
 }
 
 void
@@ -413,11 +449,10 @@ JobQueue::processTask (int instance)
             Job::clock_type::now());
         {
             Job job;
-            {
-                std::lock_guard <std::mutex> lock (m_mutex);
-                getNextJob (job);
-                ++m_processCount;
-            }
+            // Count the job as processing before it leaves its queue,
+            // so that rendezvous never sees both counts at zero.
+            ++m_processCount;
+            getNextJob (job);
             type = job.getType();
             JobTypeData& data(getJobTypeData(type));
             JLOG(m_journal.trace()) << "Doing " << data.name () << " job";
@@ -435,13 +470,19 @@ JobQueue::processTask (int instance)
             getJobTypeData(type).execute.notify(us);
     }
 
+    // Job should be destroyed before calling checkStopped
+    // otherwise destructors with side effects can access
+    // parent objects that are already destroyed.
+    finishJob (type);
+    bool const idle = --m_processCount == 0 && m_jobCount == 0;
+
+    // The global lock is only needed to wake rendezvous or to stop.
+    // A stop that begins after isStopping() reads false sees the
+    // decremented m_processCount in onChildrenStopped.
+    if (idle || isStopping ())
     {
         std::lock_guard <std::mutex> lock (m_mutex);
-        // Job should be destroyed before calling checkStopped
-        // otherwise destructors with side effects can access
-        // parent objects that are already destroyed.
-        finishJob (type);
-        if(--m_processCount == 0 && m_jobSet.empty())
+        if (idle)
             cv_.notify_all();
         checkStopped (lock);
     }
@@ -171,7 +171,7 @@ private:
     std::condition_variable m_cv;                // signaled when all threads paused
     std::mutex              m_mut;
     bool                    m_allPaused;
-    semaphore m_semaphore;                       // each pending task is 1 resource
+    light_semaphore m_semaphore;                 // each pending task is 1 resource
     int m_numberOfThreads;                       // how many we want active now
     std::atomic <int> m_activeCount;             // to know when all are paused
     std::atomic <int> m_pauseCount;              // how many threads need to pause now
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_CORE_SEMAPHORE_H_INCLUDED
 #define RIPPLE_CORE_SEMAPHORE_H_INCLUDED
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 
@@ -78,6 +79,58 @@ public:
 
 using semaphore = basic_semaphore <std::mutex, std::condition_variable>;
 
+/** A semaphore which only takes a lock when a thread must block.
+
+    The count lives in an atomic, so notify() with no thread blocked and
+    wait() with a positive count each cost a single atomic operation.
+    A waiter spins briefly before falling back to blocking on a regular
+    semaphore.
+*/
+class light_semaphore
+{
+private:
+    // When negative, the number of threads blocked in wait()
+    std::atomic <int> m_count;
+    semaphore m_sema;
+
+    static int constexpr spinCount = 1000;
+
+public:
+    explicit light_semaphore (int count = 0)
+        : m_count (count)
+    {
+    }
+
+    /** Increment the count and unblock one waiting thread. */
+    void notify ()
+    {
+        if (m_count.fetch_add (1, std::memory_order_release) < 0)
+            m_sema.notify ();
+    }
+
+    /** Block until notify is called. */
+    void wait ()
+    {
+        for (int i = 0; i < spinCount; ++i)
+        {
+            if (try_wait ())
+                return;
+        }
+        if (m_count.fetch_sub (1, std::memory_order_acquire) <= 0)
+            m_sema.wait ();
+    }
+
+    /** Perform a non-blocking wait.
+        @return `true` If the wait would be satisfied.
+    */
+    bool try_wait ()
+    {
+        int count = m_count.load (std::memory_order_relaxed);
+        return count > 0 && m_count.compare_exchange_strong (
+            count, count - 1, std::memory_order_acquire);
+    }
+};
+
 } // ripple
 
 #endif
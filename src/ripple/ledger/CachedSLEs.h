@@ -98,6 +98,18 @@ public:
     double
     rate() const;
 
+    /** Returns the number of cache hits. */
+    std::size_t
+    hits() const;
+
+    /** Returns the number of cache misses. */
+    std::size_t
+    misses() const;
+
+    /** Returns the number of cached entries. */
+    std::size_t
+    size() const;
+
 private:
     std::size_t hit_ = 0;
     std::size_t miss_ = 0;
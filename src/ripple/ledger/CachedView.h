@@ -23,6 +23,7 @@
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/basics/hardened_hash.h>
+#include <array>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -36,12 +37,38 @@ class CachedViewImpl
     : public DigestAwareReadView
 {
 private:
+    // Views of closed ledgers are shared by every request reading them,
+    // so the caches are split by key into partitions with their own
+    // locks. Not every key is uniformly random: a book base ends in
+    // zeros and the quality directories of a book share all but their
+    // last 8 bytes. So the whole key is hashed to pick a partition.
+    static std::size_t constexpr partitionCount = 16;
+
+    struct Partition
+    {
+        std::mutex mutex;
+        std::unordered_map<key_type,
+            std::shared_ptr<SLE const>,
+                hardened_hash<>> map;
+
+        // The key following each key asked about, regardless of `last`.
+        // Walking order books asks for the same quality directories over
+        // and over, once for every offer crossed against the open ledger.
+        std::unordered_map<key_type,
+            boost::optional<key_type>,
+                hardened_hash<>> succ;
+    };
+
     DigestAwareReadView const& base_;
     CachedSLEs& cache_;
-    std::mutex mutable mutex_;
-    std::unordered_map<key_type,
-        std::shared_ptr<SLE const>,
-            hardened_hash<>> mutable map_;
+    std::array<Partition, partitionCount> mutable partitions_;
+    hardened_hash<> const hasher_;
+
+    Partition&
+    partition (key_type const& key) const
+    {
+        return partitions_[hasher_ (key) % partitionCount];
+    }
 
 public:
     CachedViewImpl() = delete;
@@ -91,10 +118,7 @@ public:
 
     boost::optional<key_type>
     succ (key_type const& key, boost::optional<
-        key_type> const& last = boost::none) const override
-    {
-        return base_.succ(key, last);
-    }
+        key_type> const& last = boost::none) const override;
 
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override
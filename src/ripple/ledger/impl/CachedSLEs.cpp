@@ -58,4 +58,28 @@ CachedSLEs::rate() const
     return double(hit_) / tot;
 }
 
+std::size_t
+CachedSLEs::hits() const
+{
+    std::lock_guard<
+        std::mutex> lock(mutex_);
+    return hit_;
+}
+
+std::size_t
+CachedSLEs::misses() const
+{
+    std::lock_guard<
+        std::mutex> lock(mutex_);
+    return miss_;
+}
+
+std::size_t
+CachedSLEs::size() const
+{
+    std::lock_guard<
+        std::mutex> lock(mutex_);
+    return map_.size();
+}
+
 } // ripple
@@ -33,11 +33,12 @@ CachedViewImpl::exists (Keylet const& k) const
 std::shared_ptr<SLE const>
 CachedViewImpl::read (Keylet const& k) const
 {
+    auto& part = partition(k.key);
     {
         std::lock_guard<
-            std::mutex> lock(mutex_);
-        auto const iter = map_.find(k.key);
-        if (iter != map_.end())
+            std::mutex> lock(part.mutex);
+        auto const iter = part.map.find(k.key);
+        if (iter != part.map.end())
         {
             if (! k.check(*iter->second))
                 return nullptr;
@@ -51,12 +52,12 @@ CachedViewImpl::read (Keylet const& k) const
     auto sle = cache_.fetch(*digest,
         [&]() { return base_.read(k); });
     std::lock_guard<
-        std::mutex> lock(mutex_);
+        std::mutex> lock(part.mutex);
     auto const iter =
-        map_.find(k.key);
-    if (iter == map_.end())
+        part.map.find(k.key);
+    if (iter == part.map.end())
     {
-        map_.emplace(k.key, sle);
+        part.map.emplace(k.key, sle);
         return sle;
     }
     if (! k.check(*iter->second))
@@ -65,5 +66,35 @@ CachedViewImpl::read (Keylet const& k) const
 
 }
 
+auto
+CachedViewImpl::succ (key_type const& key,
+    boost::optional<key_type> const& last) const ->
+        boost::optional<key_type>
+{
+    auto& part = partition(key);
+    boost::optional<key_type> next;
+    bool found = false;
+    {
+        std::lock_guard<
+            std::mutex> lock(part.mutex);
+        auto const iter = part.succ.find(key);
+        if (iter != part.succ.end())
+        {
+            next = iter->second;
+            found = true;
+        }
+    }
+    if (! found)
+    {
+        next = base_.succ(key);
+        std::lock_guard<
+            std::mutex> lock(part.mutex);
+        part.succ.emplace(key, next);
+    }
+    if (next && last && *next >= *last)
+        return boost::none;
+    return next;
+}
+
 } // detail
 } // ripple
@@ -26,7 +26,9 @@
 #include <ripple/resource/Consumer.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/core/Stoppable.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -53,6 +55,42 @@ public:
     using Consumer = Resource::Consumer;
 
 public:
+    /** A message published to many subscribers.
+
+        Subscribers which send text share a single rendering of the
+        message, made on first use, instead of each serializing the
+        JSON value again.
+
+        @note This is not thread safe. A message is published from
+              one thread.
+    */
+    class Message
+    {
+    public:
+        explicit Message (Json::Value jvObj)
+            : jvObj_ (std::move (jvObj))
+        {
+        }
+
+        Message (Message const&) = delete;
+        Message& operator= (Message const&) = delete;
+
+        /** Returns the message as a JSON value. */
+        Json::Value const&
+        json () const
+        {
+            return jvObj_;
+        }
+
+        /** Returns the message as compact JSON text. */
+        std::shared_ptr<std::string const> const&
+        text () const;
+
+    private:
+        Json::Value const jvObj_;
+        std::shared_ptr<std::string const> mutable text_;
+    };
+
     /** Abstracts the source of subscription data.
     */
     class Source : public Stoppable
@@ -109,6 +147,9 @@ public:
         virtual bool unsubPeerStatus (std::uint64_t uListener) = 0;
         virtual void pubPeerStatus (std::function<Json::Value(void)> const&) = 0;
 
+        virtual bool subStateDiffs (ref ispListener) = 0;
+        virtual bool unsubStateDiffs (std::uint64_t uListener) = 0;
+
         // VFALCO TODO Remove
         //             This was added for one particular partner, it
         //             "pushes" subscription data to a particular URL.
@@ -128,6 +169,15 @@ public:
 
     virtual void send (Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message which is also being sent to other subscribers.
+
+        By default, this sends the message's JSON value.
+    */
+    virtual void send (Message const& msg, bool broadcast)
+    {
+        send (msg.json (), broadcast);
+    }
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/net/InfoSub.h>
+#include <ripple/json/json_writer.h>
 #include <atomic>
 
 namespace ripple {
@@ -35,6 +36,24 @@ namespace ripple {
 
 //------------------------------------------------------------------------------
 
+std::shared_ptr<std::string const> const&
+InfoSub::Message::text () const
+{
+    if (! text_)
+    {
+        std::string s;
+        Json::stream (jvObj_,
+            [&s](void const* data, std::size_t n)
+            {
+                s.append (static_cast<char const*> (data), n);
+            });
+        text_ = std::make_shared<std::string const> (std::move (s));
+    }
+    return text_;
+}
+
+//------------------------------------------------------------------------------
+
 InfoSub::Source::Source (char const* name, Stoppable& parent)
     : Stoppable (name, parent)
 {
@@ -64,6 +83,7 @@ InfoSub::~InfoSub ()
     m_source.unsubServer (mSeq);
     m_source.unsubValidations (mSeq);
     m_source.unsubPeerStatus (mSeq);
+    m_source.unsubStateDiffs (mSeq);
 
     // Use the internal unsubscribe so that it won't call
     // back to us and modify its own parameter
@@ -76,10 +76,17 @@ public:
     bool
     canFetchBatch() = 0;
 
-    /** Fetch a batch synchronously. */
+    /** Fetch a batch of objects synchronously.
+        The result holds one entry per key, in the same order as the
+        keys. An entry is null if the object was not found or could not
+        be decoded.
+        @note This will be called concurrently.
+        @param hashes The keys to look up.
+        @return The objects and the worst status encountered.
+    */
     virtual
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) = 0;
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) = 0;
 
     /** Store a single object.
         Depending on the implementation this may happen immediately
@@ -20,8 +20,8 @@
 #ifndef RIPPLE_NODESTORE_DATABASE_H_INCLUDED
 #define RIPPLE_NODESTORE_DATABASE_H_INCLUDED
 
-#include <ripple/basics/TaggedCache.h>
 #include <ripple/basics/KeyCache.h>
+#include <ripple/basics/PartitionedTaggedCache.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/nodestore/Backend.h>
 #include <ripple/nodestore/impl/Tuning.h>
@@ -37,6 +37,12 @@ class Ledger;
 
 namespace NodeStore {
 
+/** Positive cache of NodeObjects, partitioned to reduce lock contention. */
+using PCache = PartitionedTaggedCache<uint256, NodeObject>;
+
+/** Negative cache of keys known to be missing from the backend. */
+using NCache = KeyCache<uint256>;
+
 /** Persistency layer for NodeObject
 
     A Node is a ledger object which is uniquely identified by a key, which is
@@ -110,6 +116,20 @@ public:
     store(NodeObjectType type, Blob&& data,
         uint256 const& hash, std::uint32_t seq) = 0;
 
+    /** Store a group of objects.
+
+        This is equivalent to calling store for each object, but lets the
+        caches be updated in one pass. Each object's hash must be the
+        256-bit hash of its payload.
+
+        @note This can be called concurrently.
+        @param batch The objects to store.
+        @param seq The sequence of the ledger the objects belong to.
+    */
+    virtual
+    void
+    storeBatch(Batch const& batch, std::uint32_t seq) = 0;
+
     /** Fetch an object.
         If the object is known to be not in the database, isn't found in the
         database during the fetch, or failed to load correctly during the fetch,
@@ -235,27 +255,40 @@ protected:
 
     void
     asyncFetch(uint256 const& hash, std::uint32_t seq,
-        std::shared_ptr<TaggedCache<uint256, NodeObject>> const& pCache,
+        std::shared_ptr<PCache> const& pCache,
             std::shared_ptr<KeyCache<uint256>> const& nCache);
 
     std::shared_ptr<NodeObject>
     fetchInternal(uint256 const& hash, Backend& srcBackend);
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatchInternal(std::vector<uint256 const*> const& hashes,
+        Backend& srcBackend);
+
     void
     importInternal(Backend& dstBackend, Database& srcDB);
 
     std::shared_ptr<NodeObject>
     doFetch(uint256 const& hash, std::uint32_t seq,
-        TaggedCache<uint256, NodeObject>& pCache,
+        PCache& pCache,
             KeyCache<uint256>& nCache, bool isAsync);
 
     bool
     copyLedger(Backend& dstBackend, Ledger const& srcLedger,
-        std::shared_ptr<TaggedCache<uint256, NodeObject>> const& pCache,
+        std::shared_ptr<PCache> const& pCache,
             std::shared_ptr<KeyCache<uint256>> const& nCache,
                 std::shared_ptr<Ledger const> const& srcNext);
 
 private:
+    // A queued asynchronous read
+    struct AsyncRead
+    {
+        uint256 hash;
+        std::uint32_t seq;
+        std::shared_ptr<PCache> pCache;
+        std::shared_ptr<KeyCache<uint256>> nCache;
+    };
+
     std::atomic<std::uint32_t> storeCount_ {0};
     std::atomic<std::uint32_t> fetchTotalCount_ {0};
     std::atomic<std::uint32_t> fetchHitCount_ {0};
@@ -268,7 +301,7 @@ private:
 
     // reads to do
     std::map<uint256, std::tuple<std::uint32_t,
-        std::weak_ptr<TaggedCache<uint256, NodeObject>>,
+        std::weak_ptr<PCache>,
             std::weak_ptr<KeyCache<uint256>>>> read_;
 
     // last read
@@ -280,6 +313,9 @@ private:
     // current read generation
     uint64_t readGen_ {0};
 
+    // reads taken from read_ whose fetches have not finished
+    std::size_t readsInFlight_ {0};
+
     // The default is 32570 to match the XRP ledger network's earliest
     // allowed sequence. Alternate networks may set this value.
     std::uint32_t earliestSeq_ {XRP_LEDGER_EARLIEST_SEQ};
@@ -288,6 +324,17 @@ private:
     std::shared_ptr<NodeObject>
     fetchFrom(uint256 const& hash, std::uint32_t seq) = 0;
 
+    /** Fetch a batch of objects from the backing store(s).
+
+        The result holds one entry per hash, in order, and an entry is
+        null if the object was not found. The default implementation
+        calls fetchFrom for each hash.
+    */
+    virtual
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatchFrom(std::vector<uint256 const*> const& hashes,
+        std::uint32_t seq);
+
     /** Visit every object in the database
         This is usually called during import.
 
@@ -299,6 +346,10 @@ private:
     void
     for_each(std::function <void(std::shared_ptr<NodeObject>)> f) = 0;
 
+    void
+    doFetchBatch(std::vector<AsyncRead>::iterator first,
+        std::vector<AsyncRead>::iterator last);
+
     void
     threadEntry();
 };
@@ -44,7 +44,7 @@ public:
     {}
 
     virtual
-    TaggedCache<uint256, NodeObject> const&
+    PCache const&
     getPositiveCache() = 0;
 
     virtual std::mutex& peekMutex() const = 0;
@@ -141,14 +141,27 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        assert(db_);
+        std::vector<std::shared_ptr<NodeObject>> results;
+        results.reserve (hashes.size ());
+
+        std::lock_guard<std::mutex> _(db_->mutex);
+
+        for (auto const h : hashes)
+        {
+            Map::iterator iter = db_->table.find (*h);
+            if (iter == db_->table.end())
+                results.emplace_back ();
+            else
+                results.push_back (iter->second);
+        }
+        return {std::move (results), ok};
     }
 
     void
@@ -24,26 +24,72 @@
 #include <ripple/nodestore/impl/codec.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/ReadPool.h>
+#include <ripple/nodestore/impl/ZstdDictionary.h>
+#include <ripple/nodestore/Task.h>
 #include <nudb/nudb.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdint>
 #include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace ripple {
 namespace NodeStore {
 
+namespace {
+
+// Backends configured with the same io_depth share one pool, so the
+// number of read threads does not grow with the number of shards.
+std::shared_ptr <ReadPool>
+sharedReadPool (std::size_t depth)
+{
+    static std::mutex mutex;
+    static std::map <std::size_t, std::weak_ptr <ReadPool>> pools;
+
+    std::lock_guard <std::mutex> lock (mutex);
+    auto& weak = pools[depth];
+    auto pool = weak.lock ();
+    if (! pool)
+    {
+        pool = std::make_shared <ReadPool> ("nudb read", depth);
+        weak = pool;
+    }
+    return pool;
+}
+
+}
+
 class NuDBBackend
     : public Backend
+    , private Task
 {
 public:
     // This needs to be tuned for the
     // distribution of data sizes.
     static constexpr std::size_t arena_alloc_size = megabytes(16);
     static constexpr std::size_t currentType = 1;
+    static constexpr std::size_t maxIODepth = 256;
+
+    // Size of a trained zstd dictionary, and the number of
+    // objects sampled to train it.
+    static constexpr std::size_t zstdDictionaryBytes = kilobytes(64);
+    static constexpr std::size_t zstdTrainingSamples = 4096;
 
     beast::Journal j_;
     size_t const keyBytes_;
@@ -52,6 +98,30 @@ public:
     std::atomic <bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Spreads batch lookups over extra threads. Acquired on the first
+    // batch fetch, so backends which never batch (such as the probe
+    // used to size [shard_db]) start no threads.
+    std::size_t ioDepth_ = 0;
+    std::once_flag readPoolOnce_;
+    std::shared_ptr <ReadPool> readPool_;
+
+    // zstd dictionary compression. Until a dictionary has been trained
+    // objects are written with lz4 and sampled for training, which runs
+    // as a scheduled task. Once set, the dictionary never changes because
+    // existing objects need it. It is loaded whenever the store has one,
+    // so objects written with it can still be read after switching the
+    // codec back to lz4.
+    bool const useZstd_;
+    int zstdLevel_ = ZstdDictionary::defaultLevel;
+    std::unique_ptr <ZstdDictionary const> dictionary_;
+    std::atomic <ZstdDictionary const*> dict_ {nullptr};
+    std::mutex samplesMutex_;
+    std::condition_variable trainedCond_;
+    std::vector <Blob> samples_;
+    std::atomic <bool> sampling_ {false};
+    bool training_ = false;
+    boost::filesystem::path dictPath_;
+
     NuDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
         : j_(journal)
@@ -59,14 +129,31 @@ public:
         , name_ (get<std::string>(keyValues, "path"))
         , deletePath_(false)
         , scheduler_ (scheduler)
+        , useZstd_ (parseCodec (keyValues))
     {
         if (name_.empty())
             Throw<std::runtime_error> (
                 "nodestore: Missing path in NuDB backend");
+
+        if (get_if_exists (keyValues, "zstd_level", zstdLevel_) &&
+            (zstdLevel_ < 1 || zstdLevel_ > 19))
+        {
+            Throw<std::runtime_error> (
+                "nodestore: zstd_level must be between 1 and 19");
+        }
+
+        if (get_if_exists (keyValues, "io_depth", ioDepth_) &&
+            ioDepth_ > maxIODepth)
+        {
+            Throw<std::runtime_error> (
+                "nodestore: io_depth must not exceed " +
+                    std::to_string (maxIODepth));
+        }
     }
 
     ~NuDBBackend () override
     {
+        waitForTraining();
         close();
     }
 
@@ -92,6 +179,7 @@ public:
         auto const kp = (folder / "nudb.key").string();
         auto const lp = (folder / "nudb.log").string();
         nudb::error_code ec;
+        openDictionary (folder / "nudb.dict", dp);
         if (createIfMissing)
         {
             create_directories(folder);
@@ -114,6 +202,7 @@ public:
     void
     close() override
     {
+        waitForTraining();
         if (db_.is_open())
         {
             nudb::error_code ec;
@@ -133,12 +222,13 @@ public:
         Status status;
         pno->reset();
         nudb::error_code ec;
+        auto const dict = dict_.load();
         db_.fetch (key,
-            [key, pno, &status](void const* data, std::size_t size)
+            [key, pno, &status, dict](void const* data, std::size_t size)
             {
                 nudb::detail::buffer bf;
                 auto const result =
-                    nodeobject_decompress(data, size, bf);
+                    nodeobject_decompress(data, size, bf, dict);
                 DecodedBlob decoded (key, result.first, result.second);
                 if (! decoded.wasOk ())
                 {
@@ -158,14 +248,73 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
+    }
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) override
+    {
+        // NuDB has no multi-key read. Without a read pool the lookups are
+        // issued back to back and share one decompression buffer; with one,
+        // up to io_depth lookups are outstanding on the device at once.
+        std::vector<std::shared_ptr<NodeObject>> results (hashes.size ());
+        std::atomic<Status> status {ok};
+
+        if (ioDepth_ > 1)
+        {
+            std::call_once (readPoolOnce_,
+                [this]{ readPool_ = sharedReadPool (ioDepth_); });
+        }
+
+        if (readPool_)
+        {
+            readPool_->for_each (hashes.size (),
+                [&](std::size_t i)
+                {
+                    nudb::detail::buffer bf;
+                    if (do_fetch (hashes[i]->data (), results[i], bf) ==
+                            dataCorrupt)
+                        status = dataCorrupt;
+                });
+        }
+        else
+        {
+            nudb::detail::buffer bf;
+            for (std::size_t i = 0; i < hashes.size (); ++i)
+            {
+                if (do_fetch (hashes[i]->data (), results[i], bf) ==
+                        dataCorrupt)
+                    status = dataCorrupt;
+            }
+        }
+        return {std::move (results), status.load ()};
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) override
+    Status
+    do_fetch (void const* key, std::shared_ptr<NodeObject>& pno,
+        nudb::detail::buffer& bf)
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        Status status = ok;
+        nudb::error_code ec;
+        auto const dict = dict_.load();
+        db_.fetch (key,
+            [key, &pno, &status, &bf, dict](void const* data, std::size_t size)
+            {
+                auto const result =
+                    nodeobject_decompress(data, size, bf, dict);
+                DecodedBlob decoded (key, result.first, result.second);
+                if (! decoded.wasOk ())
+                {
+                    status = dataCorrupt;
+                    return;
+                }
+                pno = decoded.createObject();
+            }, ec);
+        if(ec == nudb::error::key_not_found)
+            return notFound;
+        if(ec)
+            Throw<nudb::system_error>(ec);
+        return status;
     }
 
     void
@@ -176,10 +325,13 @@ public:
         nudb::error_code ec;
         nudb::detail::buffer bf;
         auto const result = nodeobject_compress(
-            e.getData(), e.getSize(), bf);
+            e.getData(), e.getSize(), bf,
+                useZstd_ ? dict_.load() : nullptr);
         db_.insert (e.getKey(), result.first, result.second, ec);
         if(ec && ec != nudb::error::key_exists)
             Throw<nudb::system_error>(ec);
+        if (sampling_ && isLz4 (result.first))
+            addSample (e.getData(), e.getSize());
     }
 
     void
@@ -222,6 +374,7 @@ public:
         db_.close(ec);
         if(ec)
             Throw<nudb::system_error>(ec);
+        auto const dict = dict_.load();
         nudb::visit(dp,
             [&](
                 void const* key, std::size_t key_bytes,
@@ -230,7 +383,7 @@ public:
             {
                 nudb::detail::buffer bf;
                 auto const result =
-                    nodeobject_decompress(data, size, bf);
+                    nodeobject_decompress(data, size, bf, dict);
                 DecodedBlob decoded (key, result.first, result.second);
                 if (! decoded.wasOk ())
                 {
@@ -284,6 +437,220 @@ public:
     {
         return 3;
     }
+
+private:
+    static
+    bool
+    parseCodec (Section const& keyValues)
+    {
+        auto const codec = get<std::string>(keyValues, "codec", "lz4");
+        if (boost::iequals (codec, "zstd"))
+            return true;
+        if (! boost::iequals (codec, "lz4"))
+            Throw<std::runtime_error> (
+                "nodestore: unknown NuDB codec '" + codec + "'");
+        return false;
+    }
+
+    // True if a compressed object used the plain lz4 encoding,
+    // which is what zstd replaces once a dictionary exists.
+    static
+    bool
+    isLz4 (void const* data)
+    {
+        return *static_cast<std::uint8_t const*>(data) == 1;
+    }
+
+    // Load the dictionary if the store has one, otherwise try to train
+    // one from the objects already in the data file.
+    void
+    openDictionary (boost::filesystem::path const& dictPath,
+        std::string const& dp)
+    {
+        if (dict_.load())
+            return;
+
+        if (boost::filesystem::exists (dictPath))
+        {
+            std::ifstream is (dictPath.string(), std::ios::binary);
+            Blob const data {std::istreambuf_iterator<char>(is),
+                std::istreambuf_iterator<char>()};
+            if (! is || data.empty())
+                Throw<std::runtime_error> (
+                    "nodestore: unable to read " + dictPath.string());
+            setDictionary (std::make_unique<ZstdDictionary> (
+                data.data(), data.size(), zstdLevel_));
+            JLOG(j_.info()) <<
+                "loaded zstd dictionary " << dict_.load()->id();
+            return;
+        }
+
+        if (! useZstd_)
+            return;
+
+        {
+            std::lock_guard <std::mutex> lock (samplesMutex_);
+            sampling_ = true;
+            dictPath_ = dictPath;
+        }
+
+        if (! boost::filesystem::exists (dp))
+            return;
+
+        // Sample the oldest objects; stop the visit once we have enough.
+        nudb::error_code ec;
+        bool enough = false;
+        nudb::visit(dp,
+            [&](
+                void const*, std::size_t,
+                void const* data, std::size_t size,
+                nudb::error_code& vec)
+            {
+                if (*static_cast<std::uint8_t const*>(data) == 7)
+                    Throw<std::runtime_error> (
+                        "nodestore: zstd objects found but " +
+                            dictPath.string() + " is missing");
+                if (! isLz4 (data))
+                    return;
+                nudb::detail::buffer bf;
+                auto const result =
+                    nodeobject_decompress(data, size, bf);
+                if (addSample (result.first, result.second))
+                {
+                    enough = true;
+                    vec = boost::system::errc::make_error_code (
+                        boost::system::errc::operation_canceled);
+                }
+            }, nudb::no_progress{}, ec);
+        if (ec && ! enough)
+            Throw<nudb::system_error>(ec);
+    }
+
+    // Remember an uncompressed object for training. Returns true once
+    // sampling is complete and training has been scheduled.
+    bool
+    addSample (void const* data, std::size_t size)
+    {
+        {
+            std::lock_guard <std::mutex> lock (samplesMutex_);
+            if (! sampling_)
+                return true;
+
+            auto const p = static_cast<std::uint8_t const*>(data);
+            samples_.emplace_back (p, p + size);
+            if (samples_.size() < zstdTrainingSamples)
+                return false;
+
+            // Training takes a while, so it runs on its own and writers
+            // carry on with lz4 until the dictionary is ready.
+            sampling_ = false;
+            training_ = true;
+        }
+        scheduler_.scheduleTask (*this);
+        return true;
+    }
+
+    void
+    performScheduledTask () override
+    {
+        std::vector <Blob> samples;
+        {
+            std::lock_guard <std::mutex> lock (samplesMutex_);
+            samples.swap (samples_);
+        }
+
+        try
+        {
+            auto dict = ZstdDictionary::train (
+                samples, zstdDictionaryBytes, zstdLevel_);
+            samples.clear();
+            if (dict)
+            {
+                writeDictionary (*dict);
+                JLOG(j_.info()) <<
+                    "trained zstd dictionary " << dict->id() <<
+                        " (" << dict->data().size() << " bytes)";
+                setDictionary (std::move (dict));
+            }
+            else
+            {
+                JLOG(j_.warn()) <<
+                    "unable to train a zstd dictionary, using lz4";
+            }
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error()) <<
+                "unable to save a zstd dictionary, using lz4: " << e.what();
+        }
+
+        std::lock_guard <std::mutex> lock (samplesMutex_);
+        training_ = false;
+        trainedCond_.notify_all();
+    }
+
+    void
+    waitForTraining ()
+    {
+        std::unique_lock <std::mutex> lock (samplesMutex_);
+        trainedCond_.wait (lock, [this]{ return ! training_; });
+    }
+
+    // Objects written with the dictionary can not be read without it,
+    // so it must be safely on disk before it is used. Write a temporary
+    // file, sync it, then rename it into place and sync the directory.
+    void
+    writeDictionary (ZstdDictionary const& dict)
+    {
+        auto const tmp = dictPath_.string() + ".tmp";
+        boost::system::error_code ignored;
+        boost::filesystem::remove (tmp, ignored);
+
+        nudb::error_code ec;
+        {
+            nudb::native_file f;
+            f.create (nudb::file_mode::write, tmp, ec);
+            if (! ec)
+                f.write (0, dict.data().data(), dict.data().size(), ec);
+            if (! ec)
+                f.sync (ec);
+            f.close();
+        }
+        if (ec)
+        {
+            boost::filesystem::remove (tmp, ignored);
+            Throw<std::runtime_error> (
+                "nodestore: unable to write " + tmp + ": " + ec.message());
+        }
+
+        boost::filesystem::rename (tmp, dictPath_);
+        syncDirectory (dictPath_.parent_path());
+    }
+
+    static
+    void
+    syncDirectory (boost::filesystem::path const& dir)
+    {
+#ifndef _MSC_VER
+        int const fd = ::open (dir.c_str(), O_RDONLY);
+        if (fd == -1)
+            Throw<std::runtime_error> (
+                "nodestore: unable to open " + dir.string());
+        auto const result = ::fsync (fd);
+        ::close (fd);
+        if (result != 0)
+            Throw<std::runtime_error> (
+                "nodestore: unable to sync " + dir.string());
+#endif
+    }
+
+    void
+    setDictionary (std::unique_ptr<ZstdDictionary> dict)
+    {
+        assert (! dictionary_);
+        dictionary_ = std::move (dict);
+        dict_.store (dictionary_.get());
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -60,11 +60,11 @@ public:
         return false;
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        return {std::vector<std::shared_ptr<NodeObject>> (hashes.size ()),
+            ok};
     }
 
     void
@@ -303,14 +303,54 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        assert(m_db);
+
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve (hashes.size ());
+        for (auto const h : hashes)
+            keys.emplace_back (reinterpret_cast<char const*> (h->data ()),
+                m_keyBytes);
+
+        std::vector<std::string> values;
+        auto const statuses = m_db->MultiGet (
+            rocksdb::ReadOptions (), keys, &values);
+
+        std::vector<std::shared_ptr<NodeObject>> results (hashes.size ());
+        Status status (ok);
+
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            auto const& getStatus = statuses[i];
+
+            if (getStatus.ok ())
+            {
+                DecodedBlob decoded (hashes[i]->data (),
+                    values[i].data (), values[i].size ());
+
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject ();
+                else
+                    status = dataCorrupt;
+            }
+            else if (getStatus.IsCorruption ())
+            {
+                status = dataCorrupt;
+            }
+            else if (! getStatus.IsNotFound ())
+            {
+                status = Status (customCode + getStatus.code());
+
+                JLOG(m_journal.error()) << getStatus.ToString ();
+            }
+        }
+
+        return {std::move (results), status};
     }
 
     void
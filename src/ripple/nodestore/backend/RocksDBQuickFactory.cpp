@@ -277,11 +277,18 @@ public:
         storeBatch(Batch{object});
     }
 
-    std::vector<std::shared_ptr<NodeObject>>
-    fetchBatch (std::size_t n, void const* const* keys) override
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+    fetchBatch (std::vector<uint256 const*> const& hashes) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        std::vector<std::shared_ptr<NodeObject>> results (hashes.size ());
+        Status status = ok;
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            auto const s = fetch (hashes[i]->data (), &results[i]);
+            if (s != ok && s != notFound)
+                status = s;
+        }
+        return {std::move (results), status};
     }
 
     void
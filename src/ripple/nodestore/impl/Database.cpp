@@ -23,6 +23,8 @@
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/protocol/HashPrefix.h>
 
+#include <algorithm>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -72,10 +74,15 @@ Database::waitReads()
     // But, if not, it will definitely be done during generation
     // N+1 since the request was in the table before that pass
     // even started. So when you reach generation N+2,
-    // you know the request is done.
+    // you know the request has been taken by a read thread.
+    // The threads take requests in batches, so also wait
+    // for the batches they are still fetching.
     std::uint64_t const wakeGen = readGen_ + 2;
-    while (! readShut_ && ! read_.empty() && (readGen_ < wakeGen))
+    while (! readShut_ &&
+        ((! read_.empty() && (readGen_ < wakeGen)) || readsInFlight_ != 0))
+    {
         readGenCondVar_.wait(l);
+    }
 }
 
 void
@@ -106,7 +113,7 @@ Database::stopThreads()
 
 void
 Database::asyncFetch(uint256 const& hash, std::uint32_t seq,
-    std::shared_ptr<TaggedCache<uint256, NodeObject>> const& pCache,
+    std::shared_ptr<PCache> const& pCache,
         std::shared_ptr<KeyCache<uint256>> const& nCache)
 {
     // Post a read
@@ -153,6 +160,58 @@ Database::fetchInternal(uint256 const& hash, Backend& srcBackend)
     return nObj;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatchInternal(std::vector<uint256 const*> const& hashes,
+    Backend& srcBackend)
+{
+    if (! srcBackend.canFetchBatch())
+    {
+        std::vector<std::shared_ptr<NodeObject>> results;
+        results.reserve(hashes.size());
+        for (auto const h : hashes)
+            results.push_back(fetchInternal(*h, srcBackend));
+        return results;
+    }
+
+    std::pair<std::vector<std::shared_ptr<NodeObject>>, Status> result;
+    try
+    {
+        result = srcBackend.fetchBatch(hashes);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) <<
+            "Exception, " << e.what();
+        Rethrow();
+    }
+
+    for (auto const& nObj : result.first)
+    {
+        if (nObj)
+        {
+            ++fetchHitCount_;
+            fetchSz_ += nObj->getData().size();
+        }
+    }
+
+    switch(result.second)
+    {
+    case ok:
+    case notFound:
+        break;
+    case dataCorrupt:
+        // VFALCO TODO Deal with encountering corrupt data!
+        JLOG(j_.fatal()) <<
+            "Corrupt NodeObject in batch of " << hashes.size();
+        break;
+    default:
+        JLOG(j_.warn()) <<
+            "Unknown status=" << result.second;
+        break;
+    }
+    return std::move(result.first);
+}
+
 void
 Database::importInternal(Backend& dstBackend, Database& srcDB)
 {
@@ -183,7 +242,7 @@ Database::importInternal(Backend& dstBackend, Database& srcDB)
 // Perform a fetch and report the time it took
 std::shared_ptr<NodeObject>
 Database::doFetch(uint256 const& hash, std::uint32_t seq,
-    TaggedCache<uint256, NodeObject>& pCache,
+    PCache& pCache,
         KeyCache<uint256>& nCache, bool isAsync)
 {
     FetchReport report;
@@ -228,7 +287,7 @@ Database::doFetch(uint256 const& hash, std::uint32_t seq,
 
 bool
 Database::copyLedger(Backend& dstBackend, Ledger const& srcLedger,
-    std::shared_ptr<TaggedCache<uint256, NodeObject>> const& pCache,
+    std::shared_ptr<PCache> const& pCache,
         std::shared_ptr<KeyCache<uint256>> const& nCache,
             std::shared_ptr<Ledger const> const& srcNext)
 {
@@ -346,17 +405,91 @@ Database::copyLedger(Backend& dstBackend, Ledger const& srcLedger,
     return true;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchBatchFrom(std::vector<uint256 const*> const& hashes,
+    std::uint32_t seq)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+    for (auto const h : hashes)
+        results.push_back(fetchFrom(*h, seq));
+    return results;
+}
+
+// Perform a batch of asynchronous reads sharing the same ledger sequence
+void
+Database::doFetchBatch(std::vector<AsyncRead>::iterator first,
+    std::vector<AsyncRead>::iterator last)
+{
+    using namespace std::chrono;
+    auto const before = steady_clock::now();
+    auto const seq = first->seq;
+
+    // See which objects already exist in the caches
+    std::vector<AsyncRead*> misses;
+    std::vector<uint256 const*> hashes;
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->pCache->fetch(it->hash) ||
+            it->nCache->touch_if_exists(it->hash))
+        {
+            continue;
+        }
+        misses.push_back(&*it);
+        hashes.push_back(&it->hash);
+    }
+
+    // Try the database(s)
+    std::vector<std::shared_ptr<NodeObject>> nObjs;
+    if (! hashes.empty())
+    {
+        nObjs = fetchBatchFrom(hashes, seq);
+        fetchTotalCount_ += hashes.size();
+    }
+
+    auto const elapsed = duration_cast<milliseconds>(
+        steady_clock::now() - before);
+
+    for (std::size_t i = 0; i < misses.size(); ++i)
+    {
+        auto& read = *misses[i];
+        auto& nObj = nObjs[i];
+        if (! nObj)
+        {
+            // Just in case a write occurred
+            nObj = read.pCache->fetch(read.hash);
+            if (! nObj)
+                // We give up
+                read.nCache->insert(read.hash);
+        }
+        else
+        {
+            // Ensure all threads get the same object
+            read.pCache->canonicalize(read.hash, nObj);
+
+            JLOG(j_.trace()) <<
+                "HOS: " << read.hash << " fetch: in db";
+        }
+
+        FetchReport report;
+        report.isAsync = true;
+        report.wentToDisk = true;
+        report.wasFound = static_cast<bool>(nObj);
+        report.elapsed = elapsed;
+        scheduler_.onFetch(report);
+    }
+}
+
 // Entry point for async read threads
 void
 Database::threadEntry()
 {
     beast::setCurrentThreadName("prefetch");
+    std::vector<AsyncRead> reads;
+    reads.reserve(asyncFetchBatchSize);
     while (true)
     {
-        uint256 lastHash;
-        std::uint32_t lastSeq;
-        std::shared_ptr<TaggedCache<uint256, NodeObject>> lastPcache;
-        std::shared_ptr<KeyCache<uint256>> lastNcache;
+        reads.clear();
         {
             std::unique_lock<std::mutex> l(readLock_);
             while (! readShut_ && read_.empty())
@@ -370,24 +503,50 @@ Database::threadEntry()
 
             // Read in key order to make the back end more efficient
             auto it = read_.lower_bound(readLastHash_);
-            if (it == read_.end())
+            while (reads.size() < asyncFetchBatchSize && ! read_.empty())
             {
-                it = read_.begin();
-                // A generation has completed
-                ++readGen_;
-                readGenCondVar_.notify_all();
+                if (it == read_.end())
+                {
+                    it = read_.begin();
+                    // A generation has completed. Waiters are notified
+                    // once the reads taken so far have been fetched.
+                    ++readGen_;
+                }
+                auto pCache = std::get<1>(it->second).lock();
+                auto nCache = std::get<2>(it->second).lock();
+                if (pCache && nCache)
+                {
+                    reads.push_back({it->first, std::get<0>(it->second),
+                        std::move(pCache), std::move(nCache)});
+                }
+                readLastHash_ = it->first;
+                it = read_.erase(it);
             }
-            lastHash = it->first;
-            lastSeq = std::get<0>(it->second);
-            lastPcache = std::get<1>(it->second).lock();
-            lastNcache = std::get<2>(it->second).lock();
-            read_.erase(it);
-            readLastHash_ = lastHash;
+            readsInFlight_ += reads.size();
+        }
+
+        // Perform the reads, batching those for the same ledger sequence
+        std::stable_sort(reads.begin(), reads.end(),
+            [](AsyncRead const& a, AsyncRead const& b)
+            {
+                return a.seq < b.seq;
+            });
+        for (auto first = reads.begin(); first != reads.end();)
+        {
+            auto const last = std::find_if(first, reads.end(),
+                [seq = first->seq](AsyncRead const& r)
+                {
+                    return r.seq != seq;
+                });
+            doFetchBatch(first, last);
+            first = last;
         }
 
-        // Perform the read
-        if (lastPcache && lastPcache)
-            doFetch(lastHash, lastSeq, *lastPcache, *lastNcache, true);
+        {
+            std::lock_guard<std::mutex> l(readLock_);
+            readsInFlight_ -= reads.size();
+            readGenCondVar_.notify_all();
+        }
     }
 }
 
@@ -38,6 +38,21 @@ DatabaseNodeImp::store(NodeObjectType type, Blob&& data,
     storeStats(nObj->getData().size());
 }
 
+void
+DatabaseNodeImp::storeBatch(Batch const& batch, std::uint32_t seq)
+{
+    for (auto nObj : batch)
+    {
+#if RIPPLE_VERIFY_NODEOBJECT_KEYS
+        assert(nObj->getHash() == sha512Hash(makeSlice(nObj->getData())));
+#endif
+        pCache_->canonicalize(nObj->getHash(), nObj, true);
+        backend_->store(nObj);
+        nCache_->erase(nObj->getHash());
+        storeStats(nObj->getData().size());
+    }
+}
+
 bool
 DatabaseNodeImp::asyncFetch(uint256 const& hash,
     std::uint32_t seq, std::shared_ptr<NodeObject>& object)
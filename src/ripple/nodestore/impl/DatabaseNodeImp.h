@@ -42,7 +42,7 @@ public:
         Section const& config,
         beast::Journal j)
         : Database(name, parent, scheduler, readThreads, config, j)
-        , pCache_(std::make_shared<TaggedCache<uint256, NodeObject>>(
+        , pCache_(std::make_shared<PCache>(
             name, cacheTargetSize, cacheTargetAge, stopwatch(), j))
         , nCache_(std::make_shared<KeyCache<uint256>>(
             name, stopwatch(), cacheTargetSize, cacheTargetAge))
@@ -79,6 +79,9 @@ public:
     store(NodeObjectType type, Blob&& data,
         uint256 const& hash, std::uint32_t seq) override;
 
+    void
+    storeBatch(Batch const& batch, std::uint32_t seq) override;
+
     std::shared_ptr<NodeObject>
     fetch(uint256 const& hash, std::uint32_t seq) override
     {
@@ -116,7 +119,7 @@ public:
 
 private:
     // Positive cache
-    std::shared_ptr<TaggedCache<uint256, NodeObject>> pCache_;
+    std::shared_ptr<PCache> pCache_;
 
     // Negative cache
     std::shared_ptr<KeyCache<uint256>> nCache_;
@@ -130,6 +133,13 @@ private:
         return fetchInternal(hash, *backend_);
     }
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatchFrom(std::vector<uint256 const*> const& hashes,
+        std::uint32_t seq) override
+    {
+        return fetchBatchInternal(hashes, *backend_);
+    }
+
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
     {
@@ -34,7 +34,7 @@ DatabaseRotatingImp::DatabaseRotatingImp(
     Section const& config,
     beast::Journal j)
     : DatabaseRotating(name, parent, scheduler, readThreads, config, j)
-    , pCache_(std::make_shared<TaggedCache<uint256, NodeObject>>(
+    , pCache_(std::make_shared<PCache>(
         name, cacheTargetSize, cacheTargetAge, stopwatch(), j))
     , nCache_(std::make_shared<KeyCache<uint256>>(
         name, stopwatch(), cacheTargetSize, cacheTargetAge))
@@ -72,6 +72,21 @@ DatabaseRotatingImp::store(NodeObjectType type, Blob&& data,
     storeStats(nObj->getData().size());
 }
 
+void
+DatabaseRotatingImp::storeBatch(Batch const& batch, std::uint32_t seq)
+{
+    for (auto nObj : batch)
+    {
+#if RIPPLE_VERIFY_NODEOBJECT_KEYS
+        assert(nObj->getHash() == sha512Hash(makeSlice(nObj->getData())));
+#endif
+        pCache_->canonicalize(nObj->getHash(), nObj, true);
+        getWritableBackend()->store(nObj);
+        nCache_->erase(nObj->getHash());
+        storeStats(nObj->getData().size());
+    }
+}
+
 bool
 DatabaseRotatingImp::asyncFetch(uint256 const& hash,
     std::uint32_t seq, std::shared_ptr<NodeObject>& object)
@@ -118,5 +133,39 @@ DatabaseRotatingImp::fetchFrom(uint256 const& hash, std::uint32_t seq)
     return nObj;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchBatchFrom(
+    std::vector<uint256 const*> const& hashes, std::uint32_t seq)
+{
+    Backends b = getBackends();
+    auto nObjs = fetchBatchInternal(hashes, *b.writableBackend);
+
+    // Look for anything missing in the archive backend
+    std::vector<std::size_t> missing;
+    std::vector<uint256 const*> archiveHashes;
+    for (std::size_t i = 0; i < nObjs.size(); ++i)
+    {
+        if (! nObjs[i])
+        {
+            missing.push_back(i);
+            archiveHashes.push_back(hashes[i]);
+        }
+    }
+    if (archiveHashes.empty())
+        return nObjs;
+
+    auto archived = fetchBatchInternal(archiveHashes, *b.archiveBackend);
+    for (std::size_t i = 0; i < archived.size(); ++i)
+    {
+        if (auto& nObj = archived[i])
+        {
+            getWritableBackend()->store(nObj);
+            nCache_->erase(*archiveHashes[i]);
+            nObjs[missing[i]] = std::move(nObj);
+        }
+    }
+    return nObjs;
+}
+
 } // NodeStore
 } // ripple
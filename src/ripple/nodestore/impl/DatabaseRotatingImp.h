@@ -81,6 +81,8 @@ public:
     void store(NodeObjectType type, Blob&& data,
         uint256 const& hash, std::uint32_t seq) override;
 
+    void storeBatch(Batch const& batch, std::uint32_t seq) override;
+
     std::shared_ptr<NodeObject>
     fetch(uint256 const& hash, std::uint32_t seq) override
     {
@@ -116,12 +118,12 @@ public:
     void
     sweep() override;
 
-    TaggedCache<uint256, NodeObject> const&
+    PCache const&
     getPositiveCache() override {return *pCache_;}
 
 private:
     // Positive cache
-    std::shared_ptr<TaggedCache<uint256, NodeObject>> pCache_;
+    std::shared_ptr<PCache> pCache_;
 
     // Negative cache
     std::shared_ptr<KeyCache<uint256>> nCache_;
@@ -144,6 +146,10 @@ private:
     std::shared_ptr<NodeObject> fetchFrom(
         uint256 const& hash, std::uint32_t seq) override;
 
+    std::vector<std::shared_ptr<NodeObject>> fetchBatchFrom(
+        std::vector<uint256 const*> const& hashes,
+            std::uint32_t seq) override;
+
     void
     for_each(std::function <void(std::shared_ptr<NodeObject>)> f) override
     {
@@ -821,6 +821,31 @@ DatabaseShardImp::store(NodeObjectType type,
     storeStats(nObj->getData().size());
 }
 
+void
+DatabaseShardImp::storeBatch(Batch const& batch, std::uint32_t seq)
+{
+    auto const shardIndex {seqToShardIndex(seq)};
+    std::lock_guard<std::mutex> l(m_);
+    assert(init_);
+    if (!incomplete_ || shardIndex != incomplete_->index())
+    {
+        JLOG(j_.warn()) <<
+           "ledger seq " << seq <<
+            " is not being acquired";
+        return;
+    }
+    for (auto nObj : batch)
+    {
+#if RIPPLE_VERIFY_NODEOBJECT_KEYS
+        assert(nObj->getHash() == sha512Hash(makeSlice(nObj->getData())));
+#endif
+        incomplete_->pCache()->canonicalize(nObj->getHash(), nObj, true);
+        incomplete_->getBackend()->store(nObj);
+        incomplete_->nCache()->erase(nObj->getHash());
+        storeStats(nObj->getData().size());
+    }
+}
+
 std::shared_ptr<NodeObject>
 DatabaseShardImp::fetch(uint256 const& hash, std::uint32_t seq)
 {
@@ -134,6 +134,9 @@ public:
     store(NodeObjectType type, Blob&& data,
         uint256 const& hash, std::uint32_t seq) override;
 
+    void
+    storeBatch(Batch const& batch, std::uint32_t seq) override;
+
     std::shared_ptr<NodeObject>
     fetch(uint256 const& hash, std::uint32_t seq) override;
 
@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_READPOOL_H_INCLUDED
+#define RIPPLE_NODESTORE_READPOOL_H_INCLUDED
+
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Keeps several blocking backend reads in flight at once.
+
+    A backend whose lookups block the calling thread on the device can
+    only have as many reads outstanding as there are threads calling it.
+    ReadPool lets one caller spread the lookups of a batch over a small
+    set of dedicated threads, raising the effective queue depth seen by
+    the storage device without adding more Database read threads.
+
+    The calling thread takes part in the work, so a pool of depth N keeps
+    up to N reads outstanding using N - 1 extra threads.
+*/
+class ReadPool
+{
+public:
+    /** Create a pool.
+
+        @param name Prefix for the names of the worker threads.
+        @param depth Maximum number of concurrent reads per batch.
+    */
+    ReadPool (std::string const& name, std::size_t depth)
+    {
+        if (depth > 1)
+        {
+            threads_.reserve (depth - 1);
+            for (std::size_t i = 0; i + 1 < depth; ++i)
+                threads_.emplace_back (&ReadPool::run, this,
+                    name + " #" + std::to_string (i + 1));
+        }
+    }
+
+    ReadPool (ReadPool const&) = delete;
+    ReadPool& operator= (ReadPool const&) = delete;
+
+    ~ReadPool ()
+    {
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all ();
+        for (auto& t : threads_)
+            t.join ();
+    }
+
+    /** Returns the maximum number of reads kept in flight. */
+    std::size_t
+    depth () const
+    {
+        return threads_.size () + 1;
+    }
+
+    /** Call `f(i)` for every `i` in [0, n) and wait for all calls to finish.
+
+        Calls run concurrently and in no particular order. If any call
+        throws, the remaining indexes are abandoned and the first
+        exception is rethrown on the calling thread.
+    */
+    void
+    for_each (std::size_t n, std::function <void(std::size_t)> const& f)
+    {
+        if (n == 0)
+            return;
+
+        if (threads_.empty () || n == 1)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                f (i);
+            return;
+        }
+
+        auto const helpers = std::min (threads_.size (), n - 1);
+        auto const job = std::make_shared <Job> (n, f, helpers + 1);
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            for (std::size_t i = 0; i < helpers; ++i)
+                queue_.push_back (job);
+        }
+        if (helpers == 1)
+            cond_.notify_one ();
+        else
+            cond_.notify_all ();
+
+        job->work ();
+
+        // Helpers that were never scheduled must not hold up the caller
+        {
+            std::lock_guard <std::mutex> lock (mutex_);
+            for (auto it = queue_.begin (); it != queue_.end ();)
+            {
+                if (*it == job)
+                {
+                    it = queue_.erase (it);
+                    job->leave ();
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        job->wait ();
+        if (job->error)
+            std::rethrow_exception (job->error);
+    }
+
+private:
+    struct Job
+    {
+        Job (std::size_t n, std::function <void(std::size_t)> const& f,
+                std::size_t participants)
+            : count (n)
+            , func (f)
+            , active (participants)
+        {
+        }
+
+        // Claim and run indexes until none remain
+        void
+        work ()
+        {
+            for (std::size_t i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    func (i);
+                }
+                catch (...)
+                {
+                    std::lock_guard <std::mutex> lock (mutex);
+                    if (! error)
+                        error = std::current_exception ();
+                    next = count;
+                }
+            }
+            leave ();
+        }
+
+        void
+        leave ()
+        {
+            std::lock_guard <std::mutex> lock (mutex);
+            if (--active == 0)
+                done.notify_all ();
+        }
+
+        void
+        wait ()
+        {
+            std::unique_lock <std::mutex> lock (mutex);
+            done.wait (lock, [this]{ return active == 0; });
+        }
+
+        std::size_t const count;
+        std::function <void(std::size_t)> const& func;
+        std::atomic <std::size_t> next {0};
+
+        std::mutex mutex;
+        std::condition_variable done;
+        // Participants that have not finished, including queued helpers
+        std::size_t active;
+        std::exception_ptr error;
+    };
+
+    void
+    run (std::string name)
+    {
+        beast::setCurrentThreadName (name);
+
+        std::unique_lock <std::mutex> lock (mutex_);
+        for (;;)
+        {
+            cond_.wait (lock, [this]{ return stop_ || ! queue_.empty (); });
+            if (queue_.empty ())
+                return;
+
+            auto job = std::move (queue_.front ());
+            queue_.pop_front ();
+            lock.unlock ();
+            job->work ();
+            job.reset ();
+            lock.lock ();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque <std::shared_ptr <Job>> queue_;
+    bool stop_ = false;
+    std::vector <std::thread> threads_;
+};
+
+}
+}
+
+#endif
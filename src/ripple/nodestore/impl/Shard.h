@@ -23,6 +23,7 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/basics/RangeSet.h>
+#include <ripple/nodestore/Database.h>
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/nodestore/Scheduler.h>
 
@@ -52,8 +53,6 @@ removeAll(boost::filesystem::path const& path, beast::Journal& j)
     return true;
 }
 
-using PCache = TaggedCache<uint256, NodeObject>;
-using NCache = KeyCache<uint256>;
 class DatabaseShard;
 
 /* A range of historical ledgers backed by a node store.
@@ -30,6 +30,9 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Maximum number of queued reads an async read thread takes at once
+    ,asyncFetchBatchSize = 64
 };
 
 // Expiration time for cached nodes
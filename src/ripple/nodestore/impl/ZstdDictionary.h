@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_ZSTDDICTIONARY_H_INCLUDED
+#define RIPPLE_NODESTORE_ZSTDDICTIONARY_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/contract.h>
+#include <nudb/detail/field.hpp>
+#include <ripple/nodestore/impl/varint.h>
+#include <zstd.h>
+#include <zdict.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A zstd dictionary used to compress small NodeObject blobs.
+
+    Leaf nodes are a few hundred bytes and repeat the same field codes,
+    flags and amounts over and over, which a general purpose compressor
+    cannot exploit on a single small input. A dictionary trained from a
+    sample of a store supplies that shared context up front.
+
+    The digested forms of the dictionary are immutable and may be used
+    from any number of threads at once.
+*/
+class ZstdDictionary
+{
+public:
+    /** The default compression level. */
+    static int constexpr defaultLevel = 3;
+
+    ZstdDictionary (void const* data, std::size_t size,
+            int level = defaultLevel)
+        : data_ (static_cast<std::uint8_t const*>(data),
+            static_cast<std::uint8_t const*>(data) + size)
+        , cdict_ (ZSTD_createCDict (data_.data(), data_.size(), level))
+        , ddict_ (ZSTD_createDDict (data_.data(), data_.size()))
+        , id_ (ZDICT_getDictID (data_.data(), data_.size()))
+    {
+        if (! cdict_ || ! ddict_)
+            Throw<std::runtime_error> (
+                "zstd dictionary: unable to load");
+    }
+
+    ZstdDictionary (ZstdDictionary const&) = delete;
+    ZstdDictionary& operator= (ZstdDictionary const&) = delete;
+
+    /** Train a dictionary from sample blobs.
+
+        @return The dictionary, or `nullptr` if the samples were not
+                suitable for training.
+    */
+    static
+    std::unique_ptr<ZstdDictionary>
+    train (std::vector<Blob> const& samples,
+        std::size_t capacity, int level = defaultLevel)
+    {
+        Blob buffer;
+        std::vector<std::size_t> sizes;
+        sizes.reserve (samples.size());
+        for (auto const& s : samples)
+        {
+            buffer.insert (buffer.end(), s.begin(), s.end());
+            sizes.push_back (s.size());
+        }
+
+        Blob dict (capacity);
+        auto const size = ZDICT_trainFromBuffer (dict.data(), dict.size(),
+            buffer.data(), sizes.data(), static_cast<unsigned>(sizes.size()));
+        if (ZDICT_isError (size))
+            return nullptr;
+        return std::make_unique<ZstdDictionary> (dict.data(), size, level);
+    }
+
+    /** The raw dictionary, as it should be persisted. */
+    Blob const&
+    data() const
+    {
+        return data_;
+    }
+
+    /** The identifier zstd records in every frame built with this dictionary. */
+    unsigned
+    id() const
+    {
+        return id_;
+    }
+
+    template <class BufferFactory>
+    std::pair<void const*, std::size_t>
+    compress (void const* in,
+        std::size_t in_size, BufferFactory&& bf) const
+    {
+        using namespace nudb::detail;
+        std::pair<void const*, std::size_t> result;
+        std::array<std::uint8_t, varint_traits<
+            std::size_t>::max> vi;
+        auto const n = write_varint(
+            vi.data(), in_size);
+        auto const out_max =
+            ZSTD_compressBound(in_size);
+        std::uint8_t* out = reinterpret_cast<
+            std::uint8_t*>(bf(n + out_max));
+        result.first = out;
+        std::memcpy(out, vi.data(), n);
+        auto const out_size = ZSTD_compress_usingCDict(
+            context<ZSTD_CCtx>().get(), out + n, out_max,
+                in, in_size, cdict_.get());
+        if (ZSTD_isError(out_size))
+            Throw<std::runtime_error> (
+                std::string("zstd compress: ") +
+                    ZSTD_getErrorName(out_size));
+        result.second = n + out_size;
+        return result;
+    }
+
+    template <class BufferFactory>
+    std::pair<void const*, std::size_t>
+    decompress (void const* in,
+        std::size_t in_size, BufferFactory&& bf) const
+    {
+        using namespace nudb::detail;
+        std::pair<void const*, std::size_t> result;
+        std::uint8_t const* p = reinterpret_cast<
+            std::uint8_t const*>(in);
+        auto const n = read_varint(
+            p, in_size, result.second);
+        if (n == 0)
+            Throw<std::runtime_error> (
+                "zstd decompress: n == 0");
+        void* const out = bf(result.second);
+        result.first = out;
+        auto const out_size = ZSTD_decompress_usingDDict(
+            context<ZSTD_DCtx>().get(), out, result.second,
+                p + n, in_size - n, ddict_.get());
+        if (ZSTD_isError(out_size))
+            Throw<std::runtime_error> (
+                std::string("zstd decompress: ") +
+                    ZSTD_getErrorName(out_size));
+        if (out_size != result.second)
+            Throw<std::runtime_error> (
+                "zstd decompress: size mismatch");
+        return result;
+    }
+
+private:
+    struct deleter
+    {
+        void operator()(ZSTD_CCtx* p) const { ZSTD_freeCCtx (p); }
+        void operator()(ZSTD_DCtx* p) const { ZSTD_freeDCtx (p); }
+        void operator()(ZSTD_CDict* p) const { ZSTD_freeCDict (p); }
+        void operator()(ZSTD_DDict* p) const { ZSTD_freeDDict (p); }
+    };
+
+    template <class T>
+    using handle = std::unique_ptr<T, deleter>;
+
+    static
+    handle<ZSTD_CCtx> make_context (ZSTD_CCtx*)
+    {
+        return handle<ZSTD_CCtx> (ZSTD_createCCtx());
+    }
+
+    static
+    handle<ZSTD_DCtx> make_context (ZSTD_DCtx*)
+    {
+        return handle<ZSTD_DCtx> (ZSTD_createDCtx());
+    }
+
+    // Working contexts are not thread safe and are costly to create,
+    // so each thread keeps one of each for its lifetime.
+    template <class Context>
+    static
+    handle<Context> const&
+    context()
+    {
+        thread_local handle<Context> const ctx =
+            make_context (static_cast<Context*>(nullptr));
+        if (! ctx)
+            Throw<std::runtime_error> (
+                "zstd: unable to create context");
+        return ctx;
+    }
+
+    Blob const data_;
+    handle<ZSTD_CDict> const cdict_;
+    handle<ZSTD_DDict> const ddict_;
+    unsigned const id_;
+};
+
+}
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include <ripple/basics/contract.h>
 #include <nudb/detail/field.hpp>
 #include <ripple/nodestore/impl/varint.h>
+#include <ripple/nodestore/impl/ZstdDictionary.h>
 #include <ripple/nodestore/NodeObject.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <lz4.h>
@@ -101,12 +102,16 @@ lz4_compress (void const* in,
     1 = lz4 compressed
     2 = inner node compressed
     3 = full inner node
+    5 = v2 inner node compressed
+    6 = full v2 inner node
+    7 = zstd compressed with the store's dictionary
 */
 
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_decompress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        ZstdDictionary const* dict = nullptr)
 {
     using namespace nudb::detail;
 
@@ -136,6 +141,15 @@ nodeobject_decompress (void const* in,
             p, in_size, bf);
         break;
     }
+    case 7: // zstd
+    {
+        if (! dict)
+            Throw<std::runtime_error> (
+                "nodeobject codec: missing zstd dictionary");
+        result = dict->decompress(
+            p, in_size, bf);
+        break;
+    }
     case 2: // compressed v1 inner node
     {
         auto const hs =
@@ -311,15 +325,21 @@ zero32()
     return v.data();
 }
 
+/*  Compress a NodeObject blob.
+
+    Inner nodes use the dedicated encodings. Everything else uses lz4,
+    or zstd when a dictionary is supplied.
+*/
 template <class BufferFactory>
 std::pair<void const*, std::size_t>
 nodeobject_compress (void const* in,
-    std::size_t in_size, BufferFactory&& bf)
+    std::size_t in_size, BufferFactory&& bf,
+        ZstdDictionary const* dict = nullptr)
 {
     using std::runtime_error;
     using namespace nudb::detail;
 
-    std::size_t type = 1;
+    std::size_t type = dict ? 7 : 1;
     // Check for inner node v1
     if (in_size == 525)
     {
@@ -492,6 +512,23 @@ nodeobject_compress (void const* in,
         result.second = vn + lzr.second;
         break;
     }
+    case 7: // zstd
+    {
+        std::uint8_t* p;
+        auto const zr = dict->compress(
+                in, in_size, [&p, &vn, &bf]
+            (std::size_t n)
+            {
+                p = reinterpret_cast<
+                    std::uint8_t*>(
+                        bf(vn + n));
+                return p + vn;
+            });
+        std::memcpy(p, vi.data(), vn);
+        result.first = p;
+        result.second = vn + zr.second;
+        break;
+    }
     default:
         Throw<std::logic_error> (
             "nodeobject codec: unknown=" +
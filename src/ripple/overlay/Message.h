@@ -27,7 +27,9 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
 namespace ripple {
 
@@ -43,6 +45,12 @@ namespace ripple {
 // a string prepended by a header specifying the message length.
 // MessageType should be a Message class generated by the protobuf compiler.
 //
+// Peers that both advertise support during the handshake may exchange
+// compressed messages. The header of a compressed message sets the high
+// bit of the first byte and stores the algorithm in the next three bits,
+// leaving 28 bits for the size of the compressed payload. The type
+// follows as usual, then four more bytes hold the uncompressed size.
+//
 
 class Message : public std::enable_shared_from_this <Message>
 {
@@ -54,9 +62,38 @@ public:
     */
     static size_t const kHeaderBytes = 6;
 
+    /** Number of bytes in the header of a compressed message.
+    */
+    static size_t const kCompressedHeaderBytes = 10;
+
+    /** Payloads smaller than this are never compressed.
+    */
+    static size_t const kMinCompressibleBytes = 70;
+
+    /** The largest uncompressed payload we accept from a peer.
+    */
+    static size_t const kMaxUncompressedBytes = 64 * 1024 * 1024;
+
+    /** Compression algorithms, as encoded in a message header. */
+    enum class Compression : std::uint8_t
+    {
+        none = 0,
+        lz4 = 1
+    };
+
     Message (::google::protobuf::Message const& message, int type);
 
-    /** Retrieve the packed message data. */
+    /** Retrieve the packed message data.
+
+        @param compressed `true` if the peer accepts compressed messages.
+        Large messages of compressible types are then returned in
+        compressed form. That form is built on first use and shared by
+        every peer the message is sent to.
+    */
+    std::vector <uint8_t> const&
+    getBuffer (bool compressed);
+
+    /** Retrieve the packed message data, never compressed. */
     std::vector <uint8_t> const&
     getBuffer () const
     {
@@ -86,8 +123,9 @@ public:
         if (std::distance(first, last) <
                 Message::kHeaderBytes)
             return 0;
+        std::uint8_t const b = *first++;
         std::size_t n;
-        n  = std::size_t{*first++} << 24;
+        n  = std::size_t((b & 0x80) ? (b & 0x0F) : b) << 24;
         n += std::size_t{*first++} << 16;
         n += std::size_t{*first++} <<  8;
         n += std::size_t{*first};
@@ -104,6 +142,68 @@ public:
     }
     /** @} */
 
+    /** Determine the compression algorithm of a packed message. */
+    /** @{ */
+    template <class FwdIter>
+    static
+    std::enable_if_t<std::is_same<typename
+        FwdIter::value_type, std::uint8_t>::value, Compression>
+    compression (FwdIter first, FwdIter last)
+    {
+        if (std::distance(first, last) <
+                Message::kHeaderBytes)
+            return Compression::none;
+        std::uint8_t const b = *first;
+        if ((b & 0x80) == 0)
+            return Compression::none;
+        return static_cast<Compression>((b >> 4) & 0x07);
+    }
+
+    template <class BufferSequence>
+    static
+    Compression
+    compression (BufferSequence const& buffers)
+    {
+        return compression(buffers_begin(buffers),
+            buffers_end(buffers));
+    }
+    /** @} */
+
+    /** Determine the uncompressed payload size of a compressed message. */
+    /** @{ */
+    template <class FwdIter>
+    static
+    std::enable_if_t<std::is_same<typename
+        FwdIter::value_type, std::uint8_t>::value, std::size_t>
+    uncompressedSize (FwdIter first, FwdIter last)
+    {
+        if (std::distance(first, last) <
+                Message::kCompressedHeaderBytes)
+            return 0;
+        std::advance(first, Message::kHeaderBytes);
+        std::size_t n;
+        n  = std::size_t{*first++} << 24;
+        n += std::size_t{*first++} << 16;
+        n += std::size_t{*first++} <<  8;
+        n += std::size_t{*first};
+        return n;
+    }
+
+    template <class BufferSequence>
+    static
+    std::size_t
+    uncompressedSize (BufferSequence const& buffers)
+    {
+        return uncompressedSize(buffers_begin(buffers),
+            buffers_end(buffers));
+    }
+    /** @} */
+
+    /** Encodes the size and type of an uncompressed message into
+        the header at the beginning of a buffer.
+    */
+    static void encodeHeader (std::uint8_t* out, std::size_t size, int type);
+
     /** Determine the type of a packed message. */
     /** @{ */
     static int getType (std::vector <uint8_t> const& buf);
@@ -150,11 +250,12 @@ private:
             BufferSequence, Value>::end (buffers);
     }
 
-        // Encodes the size and type into a header at the beginning of buf
-    //
-    void encodeHeader (unsigned size, int type);
+    // Builds the compressed form of the message, if worthwhile
+    void compress ();
 
     std::vector <uint8_t> mBuffer;
+    std::vector <uint8_t> mBufferCompressed;
+    std::once_flag mCompressOnce;
 
     int mCategory;
 };
@@ -19,6 +19,7 @@
 
 #include <ripple/overlay/Message.h>
 #include <ripple/overlay/impl/TrafficCount.h>
+#include <lz4.h>
 #include <cstdint>
 
 namespace ripple {
@@ -31,7 +32,7 @@ Message::Message (::google::protobuf::Message const& message, int type)
 
     mBuffer.resize (kHeaderBytes + messageBytes);
 
-    encodeHeader (messageBytes, type);
+    encodeHeader (mBuffer.data (), messageBytes, type);
 
     if (messageBytes != 0)
     {
@@ -42,6 +43,75 @@ Message::Message (::google::protobuf::Message const& message, int type)
         (message, type, false));
 }
 
+// Only message types that are routinely large are worth compressing
+static
+bool
+isCompressible (int type)
+{
+    switch (type)
+    {
+    case protocol::mtMANIFESTS:
+    case protocol::mtENDPOINTS:
+    case protocol::mtSHARD_INFO:
+    case protocol::mtTRANSACTION:
+    case protocol::mtGET_LEDGER:
+    case protocol::mtLEDGER_DATA:
+    case protocol::mtGET_OBJECTS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::vector <uint8_t> const&
+Message::getBuffer (bool compressed)
+{
+    if (! compressed)
+        return mBuffer;
+
+    std::call_once (mCompressOnce, &Message::compress, this);
+
+    if (mBufferCompressed.empty ())
+        return mBuffer;
+    return mBufferCompressed;
+}
+
+void Message::compress ()
+{
+    auto const messageBytes = mBuffer.size () - kHeaderBytes;
+    auto const type = getType (mBuffer);
+
+    // The compressed size must fit in the 28 bits the header allows
+    if (messageBytes < kMinCompressibleBytes ||
+            messageBytes > 0x0FFFFFFF || ! isCompressible (type))
+        return;
+
+    auto const bound = LZ4_compressBound (
+        static_cast<int> (messageBytes));
+    if (bound <= 0)
+        return;
+
+    std::vector <uint8_t> buffer (kCompressedHeaderBytes + bound);
+    auto const compressedBytes = LZ4_compress_default (
+        reinterpret_cast<char const*>(&mBuffer [kHeaderBytes]),
+        reinterpret_cast<char*>(&buffer [kCompressedHeaderBytes]),
+        static_cast<int> (messageBytes), bound);
+
+    // Don't bother unless the larger header is paid for
+    if (compressedBytes <= 0 || kCompressedHeaderBytes +
+            compressedBytes >= mBuffer.size ())
+        return;
+
+    buffer.resize (kCompressedHeaderBytes + compressedBytes);
+    encodeHeader (buffer.data (), compressedBytes, type);
+    buffer[0] |= 0x80 | (static_cast<std::uint8_t> (Compression::lz4) << 4);
+    buffer[6] = static_cast<std::uint8_t> ((messageBytes >> 24) & 0xFF);
+    buffer[7] = static_cast<std::uint8_t> ((messageBytes >> 16) & 0xFF);
+    buffer[8] = static_cast<std::uint8_t> ((messageBytes >> 8) & 0xFF);
+    buffer[9] = static_cast<std::uint8_t> (messageBytes & 0xFF);
+    mBufferCompressed = std::move (buffer);
+}
+
 bool Message::operator== (Message const& other) const
 {
     return mBuffer == other.mBuffer;
@@ -80,15 +150,14 @@ int Message::getType (std::vector<uint8_t> const& buf)
     return ret;
 }
 
-void Message::encodeHeader (unsigned size, int type)
+void Message::encodeHeader (std::uint8_t* out, std::size_t size, int type)
 {
-    assert (mBuffer.size () >= Message::kHeaderBytes);
-    mBuffer[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
-    mBuffer[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
-    mBuffer[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
-    mBuffer[3] = static_cast<std::uint8_t> (size & 0xFF);
-    mBuffer[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
-    mBuffer[5] = static_cast<std::uint8_t> (type & 0xFF);
+    out[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
+    out[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
+    out[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
+    out[3] = static_cast<std::uint8_t> (size & 0xFF);
+    out[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
+    out[5] = static_cast<std::uint8_t> (type & 0xFF);
 }
 
 }
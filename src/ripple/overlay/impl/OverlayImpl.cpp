@@ -35,6 +35,8 @@
 #include <ripple/server/SimpleWriter.h>
 
 #include <boost/utility/in_place_factory.hpp>
+#include <iomanip>
+#include <sstream>
 
 namespace ripple {
 
@@ -560,6 +562,20 @@ OverlayImpl::onChildrenStopped ()
 void
 OverlayImpl::onWrite (beast::PropertyStream::Map& stream)
 {
+    auto const histogram = [&stream](std::string const& name,
+        TrafficCount::Histogram const& h)
+    {
+        beast::PropertyStream::Map map (name, stream);
+        for (std::size_t i = 0; i < TrafficCount::Histogram::buckets; ++i)
+        {
+            if (auto const n = h[i])
+                map[std::to_string (TrafficCount::Histogram::lowerBound (i))] =
+                    beast::lexicalCast<std::string> (n);
+        }
+    };
+    histogram ("send_queue_depth", m_traffic.getSendQueueDepth());
+    histogram ("bytes_per_write", m_traffic.getBytesPerWrite());
+
     beast::PropertyStream::Set set ("traffic", stream);
     auto stats = m_traffic.getCounts();
     for (auto& i : stats)
@@ -581,6 +597,31 @@ OverlayImpl::onWrite (beast::PropertyStream::Map& stream)
         item["messages_out"] =
             beast::lexicalCast<std::string>
                 (i.second.messagesOut.load());
+
+        // The ratio is uncompressed to compressed size, over the
+        // messages that were compressed
+        auto const ratio = [](std::uint64_t uncompressed,
+            std::uint64_t compressed)
+        {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision (2) <<
+                static_cast<double>(uncompressed) / compressed;
+            return ss.str();
+        };
+        if (auto const n = i.second.compressedBytesIn.load())
+        {
+            item["compressed_bytes_in"] =
+                beast::lexicalCast<std::string> (n);
+            item["compression_ratio_in"] = ratio (
+                i.second.uncompressedBytesIn.load(), n);
+        }
+        if (auto const n = i.second.compressedBytesOut.load())
+        {
+            item["compressed_bytes_out"] =
+                beast::lexicalCast<std::string> (n);
+            item["compression_ratio_out"] = ratio (
+                i.second.uncompressedBytesOut.load(), n);
+        }
     }
 }
 
@@ -707,6 +748,25 @@ OverlayImpl::reportTraffic (
     m_traffic.addCount (cat, isInbound, number);
 }
 
+void
+OverlayImpl::reportWrite (
+    std::size_t queueDepth,
+    std::size_t bytes)
+{
+    m_traffic.addWrite (queueDepth, bytes);
+}
+
+void
+OverlayImpl::reportCompression (
+    TrafficCount::category cat,
+    bool isInbound,
+    int compressedBytes,
+    int uncompressedBytes)
+{
+    m_traffic.addCompressed (cat, isInbound,
+        compressedBytes, uncompressedBytes);
+}
+
 Json::Value
 OverlayImpl::crawlShards(bool pubKey, std::uint32_t hops)
 {
@@ -313,6 +313,18 @@ public:
         bool isInbound,
         int bytes);
 
+    void
+    reportWrite (
+        std::size_t queueDepth,
+        std::size_t bytes);
+
+    void
+    reportCompression (
+        TrafficCount::category cat,
+        bool isInbound,
+        int compressedBytes,
+        int uncompressedBytes);
+
     void
     incJqTransOverflow() override
     {
@@ -76,6 +76,8 @@ PeerImp::PeerImp (Application& app, id_t id, endpoint_type remote_endpoint,
     , publicKey_(publicKey)
     , creationTime_ (clock_type::now())
     , hello_(hello)
+    , compressionEnabled_ (
+        app_.config().COMPRESSION && hello.compression())
     , usage_(consumer)
     , fee_ (Resource::feeLightPeer)
     , slot_ (slot)
@@ -191,9 +193,17 @@ PeerImp::send (Message::pointer const& m)
     if(detaching_)
         return;
 
-    overlay_.reportTraffic (
-        static_cast<TrafficCount::category>(m->getCategory()),
-        false, static_cast<int>(m->getBuffer().size()));
+    auto const category =
+        static_cast<TrafficCount::category>(m->getCategory());
+    auto const& buffer = m->getBuffer(compressionEnabled_);
+    overlay_.reportTraffic (category,
+        false, static_cast<int>(buffer.size()));
+    if (&buffer != &m->getBuffer())
+    {
+        overlay_.reportCompression (category, false,
+            static_cast<int>(buffer.size()),
+                static_cast<int>(m->getBuffer().size()));
+    }
 
     auto sendq_size = send_queue_.size();
 
@@ -211,16 +221,12 @@ PeerImp::send (Message::pointer const& m)
                 " sendq: " << sendq_size;
     }
 
-    send_queue_.push(m);
+    send_queue_.push_back(m);
 
     if(sendq_size != 0)
         return;
 
-    boost::asio::async_write (stream_, boost::asio::buffer(
-        send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-            &PeerImp::onWriteMessage, shared_from_this(),
-                std::placeholders::_1,
-                    std::placeholders::_2)));
+    writeMessages();
 }
 
 void
@@ -302,6 +308,9 @@ PeerImp::json()
     ret[jss::uptime] = static_cast<Json::UInt>(
         std::chrono::duration_cast<std::chrono::seconds>(uptime()).count());
 
+    ret[jss::send_queue_depth] = sendQueueDepth_.getJson();
+    ret[jss::bytes_per_write] = bytesPerWrite_.getJson();
+
     std::uint32_t minSeq, maxSeq;
     ledgerRange(minSeq, maxSeq);
 
@@ -790,7 +799,7 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
     {
         std::size_t bytes_consumed;
         std::tie(bytes_consumed, ec) = invokeProtocolMessage(
-            read_buffer_.data(), *this);
+            read_buffer_.data(), *this, compressionEnabled_);
         if (ec)
             return fail("onReadMessage", ec);
         if (! stream_.next_layer().is_open())
@@ -826,16 +835,14 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
             stream << "onWriteMessage";
     }
 
-    assert(! send_queue_.empty());
-    send_queue_.pop();
+    assert(writeCount_ != 0 && send_queue_.size() >= writeCount_);
+    send_queue_.erase(send_queue_.begin(),
+        send_queue_.begin() + writeCount_);
+    writeCount_ = 0;
     if (! send_queue_.empty())
     {
         // Timeout on writes only
-        return boost::asio::async_write (stream_, boost::asio::buffer(
-            send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-                &PeerImp::onWriteMessage, shared_from_this(),
-                    std::placeholders::_1,
-                        std::placeholders::_2)));
+        return writeMessages();
     }
 
     if (gracefulClose_)
@@ -846,6 +853,54 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
     }
 }
 
+void
+PeerImp::writeMessages()
+{
+    assert(strand_.running_in_this_thread());
+    assert(! send_queue_.empty() && writeCount_ == 0);
+
+    // Take as many queued messages as fit in one write. A message
+    // too large to share a write is sent on its own.
+    auto const& front = send_queue_.front()->getBuffer(compressionEnabled_);
+    std::size_t bytes = front.size();
+    writeCount_ = 1;
+    while (writeCount_ < send_queue_.size() &&
+        writeCount_ < Tuning::maxWriteMessages)
+    {
+        auto const size = send_queue_[writeCount_]->getBuffer(
+            compressionEnabled_).size();
+        if (bytes + size > Tuning::maxWriteBytes)
+            break;
+        bytes += size;
+        ++writeCount_;
+    }
+
+    sendQueueDepth_.add(send_queue_.size());
+    bytesPerWrite_.add(bytes);
+    overlay_.reportWrite(send_queue_.size(), bytes);
+
+    auto handler = strand_.wrap(std::bind(
+        &PeerImp::onWriteMessage, shared_from_this(),
+            std::placeholders::_1,
+                std::placeholders::_2));
+
+    if (writeCount_ == 1)
+        return boost::asio::async_write (stream_,
+            boost::asio::buffer(front), std::move(handler));
+
+    // The SSL stream encrypts one buffer per write, so the messages
+    // are copied together rather than passed as a buffer sequence.
+    coalesced_.clear();
+    coalesced_.reserve(bytes);
+    for (std::size_t i = 0; i < writeCount_; ++i)
+    {
+        auto const& buffer = send_queue_[i]->getBuffer(compressionEnabled_);
+        coalesced_.insert(coalesced_.end(), buffer.begin(), buffer.end());
+    }
+    boost::asio::async_write (stream_,
+        boost::asio::buffer(coalesced_), std::move(handler));
+}
+
 //------------------------------------------------------------------------------
 //
 // ProtocolHandler
@@ -863,13 +918,18 @@ PeerImp::onMessageUnknown (std::uint16_t type)
 PeerImp::error_code
 PeerImp::onMessageBegin (std::uint16_t type,
     std::shared_ptr <::google::protobuf::Message> const& m,
-    std::size_t size)
+    std::size_t size, std::size_t uncompressedSize)
 {
     load_event_ = app_.getJobQueue ().makeLoadEvent (
         jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
-    overlay_.reportTraffic (TrafficCount::categorize (*m, type, true),
-        true, static_cast<int>(size));
+    auto const category = TrafficCount::categorize (*m, type, true);
+    overlay_.reportTraffic (category, true, static_cast<int>(size));
+    if (size != uncompressedSize)
+    {
+        overlay_.reportCompression (category, true,
+            static_cast<int>(size), static_cast<int>(uncompressedSize));
+    }
     return error_code{};
 }
 
@@ -1383,15 +1443,29 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         {
             JLOG(p_journal_.trace()) << "No new transactions until synchronized";
         }
+        else if (checkSignature)
+        {
+            // Signatures are checked in batches first, so that
+            // checkTransaction finds the result cached.
+            if (! app_.getOPs().verifyTransaction (stx,
+                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                flags, stx] () {
+                    if (auto peer = weak.lock())
+                        peer->checkTransaction(flags, true, stx);
+                }))
+            {
+                overlay_.incJqTransOverflow();
+                JLOG(p_journal_.info()) << "Transaction queue is full";
+            }
+        }
         else
         {
             app_.getJobQueue ().addJob (
                 jtTRANSACTION, "recvTransaction->checkTransaction",
                 [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                flags, checkSignature, stx] (Job&) {
+                flags, stx] (Job&) {
                     if (auto peer = weak.lock())
-                        peer->checkTransaction(flags,
-                            checkSignature, stx);
+                        peer->checkTransaction(flags, false, stx);
                 });
         }
     }
@@ -36,7 +36,6 @@
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <deque>
-#include <queue>
 
 namespace ripple {
 
@@ -147,6 +146,8 @@ private:
     std::mutex mutable recentLock_;
     protocol::TMStatusChange last_status_;
     protocol::TMHello hello_;
+    // True if both sides accept compressed messages
+    bool const compressionEnabled_;
     Resource::Consumer usage_;
     Resource::Charge fee_;
     PeerFinder::Slot::ptr slot_;
@@ -155,7 +156,13 @@ private:
     http_response_type response_;
     boost::beast::http::fields const& headers_;
     boost::beast::multi_buffer write_buffer_;
-    std::queue<Message::pointer> send_queue_;
+    std::deque<Message::pointer> send_queue_;
+    // Messages at the front of send_queue_ in the current write
+    std::size_t writeCount_ = 0;
+    // Holds small messages combined into a single write
+    std::vector<std::uint8_t> coalesced_;
+    TrafficCount::Histogram sendQueueDepth_;
+    TrafficCount::Histogram bytesPerWrite_;
     bool gracefulClose_ = false;
     int large_sendq_ = 0;
     int no_ping_ = 0;
@@ -397,6 +404,10 @@ private:
     void
     onWriteMessage (error_code ec, std::size_t bytes_transferred);
 
+    // Starts writing the messages at the front of the send queue
+    void
+    writeMessages ();
+
 public:
     //--------------------------------------------------------------------------
     //
@@ -418,7 +429,7 @@ public:
     error_code
     onMessageBegin (std::uint16_t type,
         std::shared_ptr <::google::protobuf::Message> const& m,
-        std::size_t size);
+        std::size_t size, std::size_t uncompressedSize);
 
     void
     onMessageEnd (std::uint16_t type,
@@ -514,6 +525,8 @@ PeerImp::PeerImp (Application& app, std::unique_ptr<beast::asio::ssl_bundle>&& s
     , publicKey_ (publicKey)
     , creationTime_ (clock_type::now())
     , hello_ (hello)
+    , compressionEnabled_ (
+        app_.config().COMPRESSION && hello.compression())
     , usage_ (usage)
     , fee_ (Resource::feeLightPeer)
     , slot_ (std::move(slot))
@@ -26,6 +26,8 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <lz4.h>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -72,7 +74,7 @@ std::enable_if_t<std::is_base_of<
     ::google::protobuf::Message, T>::value,
         boost::system::error_code>
 invoke (int type, Buffers const& buffers,
-    Handler& handler)
+    Handler& handler, std::size_t wireBytes)
 {
     ZeroCopyInputStream<Buffers> stream(buffers);
     stream.Skip(Message::kHeaderBytes);
@@ -80,7 +82,7 @@ invoke (int type, Buffers const& buffers,
     if (! m->ParseFromZeroCopyStream(&stream))
         return boost::system::errc::make_error_code(
             boost::system::errc::invalid_argument);
-    auto ec = handler.onMessageBegin (type, m,
+    auto ec = handler.onMessageBegin (type, m, wireBytes,
        Message::kHeaderBytes + Message::size (buffers));
     if (! ec)
     {
@@ -90,6 +92,75 @@ invoke (int type, Buffers const& buffers,
     return ec;
 }
 
+/** Decompress an lz4 message of `size` bytes at the start of buffers.
+
+    @return The message with an uncompressed header, or an empty
+            buffer if the message is malformed.
+*/
+template <class Buffers>
+std::vector<std::uint8_t>
+decompress (Buffers const& buffers, std::size_t size)
+{
+    std::vector<std::uint8_t> result;
+    auto const messageBytes = Message::uncompressedSize(buffers);
+    if (messageBytes == 0 ||
+            messageBytes > Message::kMaxUncompressedBytes)
+        return result;
+
+    std::vector<std::uint8_t> in (
+        size - Message::kCompressedHeaderBytes);
+    auto first = boost::asio::buffers_iterator<
+        Buffers, std::uint8_t>::begin(buffers);
+    std::advance(first, Message::kCompressedHeaderBytes);
+    std::copy_n(first, in.size(), in.begin());
+
+    result.resize(Message::kHeaderBytes + messageBytes);
+    auto const n = LZ4_decompress_safe(
+        reinterpret_cast<char const*>(in.data()),
+        reinterpret_cast<char*>(&result[Message::kHeaderBytes]),
+        static_cast<int>(in.size()), static_cast<int>(messageBytes));
+    if (n < 0 || static_cast<std::size_t>(n) != messageBytes)
+    {
+        result.clear();
+        return result;
+    }
+    Message::encodeHeader(result.data(), messageBytes,
+        Message::type(buffers));
+    return result;
+}
+
+template <class Buffers, class Handler>
+boost::system::error_code
+invokeMessage (int type, Buffers const& buffers,
+    Handler& handler, std::size_t size)
+{
+    boost::system::error_code ec;
+    switch (type)
+    {
+    case protocol::mtHELLO:         ec = invoke<protocol::TMHello> (type, buffers, handler, size); break;
+    case protocol::mtMANIFESTS:     ec = invoke<protocol::TMManifests> (type, buffers, handler, size); break;
+    case protocol::mtPING:          ec = invoke<protocol::TMPing> (type, buffers, handler, size); break;
+    case protocol::mtCLUSTER:       ec = invoke<protocol::TMCluster> (type, buffers, handler, size); break;
+    case protocol::mtGET_SHARD_INFO:ec = invoke<protocol::TMGetShardInfo> (type, buffers, handler, size); break;
+    case protocol::mtSHARD_INFO:    ec = invoke<protocol::TMShardInfo> (type, buffers, handler, size); break;
+    case protocol::mtGET_PEERS:     ec = invoke<protocol::TMGetPeers> (type, buffers, handler, size); break;
+    case protocol::mtPEERS:         ec = invoke<protocol::TMPeers> (type, buffers, handler, size); break;
+    case protocol::mtENDPOINTS:     ec = invoke<protocol::TMEndpoints> (type, buffers, handler, size); break;
+    case protocol::mtTRANSACTION:   ec = invoke<protocol::TMTransaction> (type, buffers, handler, size); break;
+    case protocol::mtGET_LEDGER:    ec = invoke<protocol::TMGetLedger> (type, buffers, handler, size); break;
+    case protocol::mtLEDGER_DATA:   ec = invoke<protocol::TMLedgerData> (type, buffers, handler, size); break;
+    case protocol::mtPROPOSE_LEDGER:ec = invoke<protocol::TMProposeSet> (type, buffers, handler, size); break;
+    case protocol::mtSTATUS_CHANGE: ec = invoke<protocol::TMStatusChange> (type, buffers, handler, size); break;
+    case protocol::mtHAVE_SET:      ec = invoke<protocol::TMHaveTransactionSet> (type, buffers, handler, size); break;
+    case protocol::mtVALIDATION:    ec = invoke<protocol::TMValidation> (type, buffers, handler, size); break;
+    case protocol::mtGET_OBJECTS:   ec = invoke<protocol::TMGetObjectByHash> (type, buffers, handler, size); break;
+    default:
+        ec = handler.onMessageUnknown (type);
+        break;
+    }
+    return ec;
+}
+
 }
 
 /** Calls the handler for up to one protocol message in the passed buffers.
@@ -97,11 +168,15 @@ invoke (int type, Buffers const& buffers,
     If there is insufficient data to produce a complete protocol
     message, zero is returned for the number of bytes consumed.
 
+    @param compressionEnabled `true` if compressed messages were
+           negotiated with the peer. Otherwise they are rejected.
+
     @return The number of bytes consumed, or the error code if any.
 */
 template <class Buffers, class Handler>
 std::pair <std::size_t, boost::system::error_code>
-invokeProtocolMessage (Buffers const& buffers, Handler& handler)
+invokeProtocolMessage (Buffers const& buffers, Handler& handler,
+    bool compressionEnabled)
 {
     std::pair<std::size_t,boost::system::error_code> result = { 0, {} };
     boost::system::error_code& ec = result.second;
@@ -109,32 +184,32 @@ invokeProtocolMessage (Buffers const& buffers, Handler& handler)
     auto const type = Message::type(buffers);
     if (type == 0)
         return result;
-    auto const size = Message::kHeaderBytes + Message::size(buffers);
+    auto const compression = Message::compression(buffers);
+    auto const size = Message::size(buffers) +
+        (compression == Message::Compression::none ?
+            Message::kHeaderBytes : Message::kCompressedHeaderBytes);
     if (boost::asio::buffer_size(buffers) < size)
         return result;
 
-    switch (type)
+    if (compression == Message::Compression::none)
     {
-    case protocol::mtHELLO:         ec = detail::invoke<protocol::TMHello> (type, buffers, handler); break;
-    case protocol::mtMANIFESTS:     ec = detail::invoke<protocol::TMManifests> (type, buffers, handler); break;
-    case protocol::mtPING:          ec = detail::invoke<protocol::TMPing> (type, buffers, handler); break;
-    case protocol::mtCLUSTER:       ec = detail::invoke<protocol::TMCluster> (type, buffers, handler); break;
-    case protocol::mtGET_SHARD_INFO:ec = detail::invoke<protocol::TMGetShardInfo> (type, buffers, handler); break;
-    case protocol::mtSHARD_INFO:    ec = detail::invoke<protocol::TMShardInfo>(type, buffers, handler); break;
-    case protocol::mtGET_PEERS:     ec = detail::invoke<protocol::TMGetPeers> (type, buffers, handler); break;
-    case protocol::mtPEERS:         ec = detail::invoke<protocol::TMPeers> (type, buffers, handler); break;
-    case protocol::mtENDPOINTS:     ec = detail::invoke<protocol::TMEndpoints> (type, buffers, handler); break;
-    case protocol::mtTRANSACTION:   ec = detail::invoke<protocol::TMTransaction> (type, buffers, handler); break;
-    case protocol::mtGET_LEDGER:    ec = detail::invoke<protocol::TMGetLedger> (type, buffers, handler); break;
-    case protocol::mtLEDGER_DATA:   ec = detail::invoke<protocol::TMLedgerData> (type, buffers, handler); break;
-    case protocol::mtPROPOSE_LEDGER:ec = detail::invoke<protocol::TMProposeSet> (type, buffers, handler); break;
-    case protocol::mtSTATUS_CHANGE: ec = detail::invoke<protocol::TMStatusChange> (type, buffers, handler); break;
-    case protocol::mtHAVE_SET:      ec = detail::invoke<protocol::TMHaveTransactionSet> (type, buffers, handler); break;
-    case protocol::mtVALIDATION:    ec = detail::invoke<protocol::TMValidation> (type, buffers, handler); break;
-    case protocol::mtGET_OBJECTS:   ec = detail::invoke<protocol::TMGetObjectByHash> (type, buffers, handler); break;
-    default:
-        ec = handler.onMessageUnknown (type);
-        break;
+        ec = detail::invokeMessage (type, buffers, handler, size);
+    }
+    else if (! compressionEnabled ||
+        compression != Message::Compression::lz4)
+    {
+        ec = boost::system::errc::make_error_code(
+            boost::system::errc::protocol_error);
+    }
+    else
+    {
+        auto const message = detail::decompress (buffers, size);
+        if (message.empty())
+            ec = boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        else
+            ec = detail::invokeMessage (type,
+                boost::asio::buffer(message), handler, size);
     }
     if (! ec)
         result.first = size;
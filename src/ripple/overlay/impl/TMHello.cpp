@@ -24,6 +24,7 @@
 #include <ripple/beast/rfc2616.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/protocol/digest.h>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/regex.hpp>
 #include <algorithm>
 
@@ -129,6 +130,9 @@ buildHello (
     // take over the functionality.
     h.set_nodeprivate (true);
 
+    if (app.config().COMPRESSION)
+        h.set_compression (true);
+
     auto const closedLedger = app.getLedgerMaster().getClosedLedger();
 
     assert(! closedLedger->open());
@@ -174,6 +178,9 @@ appendHello (boost::beast::http::fields& h,
 
     if (hello.has_remote_ip())
         h.insert ("Remote-IP", hello.remote_ip_str());
+
+    if (hello.compression())
+        h.insert ("X-Offer-Compression", "lz4");
 }
 
 std::vector<ProtocolVersion>
@@ -329,6 +336,19 @@ parseHello (bool request, boost::beast::http::fields const& h, beast::Journal jo
         }
     }
 
+    {
+        auto const iter = h.find ("X-Offer-Compression");
+        if (iter != h.end())
+        {
+            for (auto const& s : beast::rfc2616::split_commas(
+                    iter->value()))
+            {
+                if (boost::iequals (s, "lz4"))
+                    hello.set_compression (true);
+            }
+        }
+    }
+
     return hello;
 }
 
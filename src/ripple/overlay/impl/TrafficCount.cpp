@@ -21,6 +21,20 @@
 
 namespace ripple {
 
+Json::Value
+TrafficCount::Histogram::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+    for (std::size_t i = 0; i < buckets; ++i)
+    {
+        auto const n = counts_[i].load();
+        if (n != 0)
+            ret[std::to_string (lowerBound (i))] =
+                static_cast<Json::UInt> (n);
+    }
+    return ret;
+}
+
 const char* TrafficCount::getName (category c)
 {
     switch (c)
@@ -20,9 +20,12 @@
 #ifndef RIPPLE_OVERLAY_TRAFFIC_H_INCLUDED
 #define RIPPLE_OVERLAY_TRAFFIC_H_INCLUDED
 
+#include <ripple/json/json_value.h>
 #include <ripple/protocol/messages.h>
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <map>
 
 namespace ripple {
@@ -43,8 +46,17 @@ public:
         count_t messagesIn;
         count_t messagesOut;
 
+        // Compressed messages only: the bytes on the wire, and the
+        // bytes they would have taken uncompressed.
+        count_t compressedBytesIn;
+        count_t compressedBytesOut;
+        count_t uncompressedBytesIn;
+        count_t uncompressedBytesOut;
+
         TrafficStats() : bytesIn(0), bytesOut(0),
-            messagesIn(0), messagesOut(0)
+            messagesIn(0), messagesOut(0),
+            compressedBytesIn(0), compressedBytesOut(0),
+            uncompressedBytesIn(0), uncompressedBytesOut(0)
         { ; }
 
         TrafficStats(const TrafficStats& ts)
@@ -52,6 +64,10 @@ public:
             , bytesOut (ts.bytesOut.load())
             , messagesIn (ts.messagesIn.load())
             , messagesOut (ts.messagesOut.load())
+            , compressedBytesIn (ts.compressedBytesIn.load())
+            , compressedBytesOut (ts.compressedBytesOut.load())
+            , uncompressedBytesIn (ts.uncompressedBytesIn.load())
+            , uncompressedBytesOut (ts.uncompressedBytesOut.load())
         { ; }
 
         operator bool () const
@@ -61,6 +77,45 @@ public:
     };
 
 
+    /** Counts values in buckets bounded by powers of two.
+
+        Bucket 0 holds values below 2 and bucket i holds values from
+        2^i up to 2^(i+1). The last bucket also holds anything larger.
+    */
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t buckets = 20;
+
+        void add (std::uint64_t value)
+        {
+            std::size_t i = 0;
+            while (value > 1 && i + 1 < buckets)
+            {
+                value >>= 1;
+                ++i;
+            }
+            ++counts_[i];
+        }
+
+        /** The smallest value counted in a bucket. */
+        static std::uint64_t lowerBound (std::size_t i)
+        {
+            return (i == 0) ? 0 : (std::uint64_t{1} << i);
+        }
+
+        unsigned long operator[] (std::size_t i) const
+        {
+            return counts_[i].load();
+        }
+
+        /** The non-empty buckets, keyed by their lower bound. */
+        Json::Value getJson () const;
+
+    private:
+        std::array<count_t, buckets> counts_ {};
+    };
+
     enum class category
     {
         CT_base,           // basic peer overhead, must be first
@@ -95,6 +150,22 @@ public:
         }
     }
 
+    /** Record a compressed message, already counted by addCount. */
+    void addCompressed (category cat, bool inbound,
+        int compressed, int uncompressed)
+    {
+        if (inbound)
+        {
+            counts_[cat].compressedBytesIn += compressed;
+            counts_[cat].uncompressedBytesIn += uncompressed;
+        }
+        else
+        {
+            counts_[cat].compressedBytesOut += compressed;
+            counts_[cat].uncompressedBytesOut += uncompressed;
+        }
+    }
+
     TrafficCount()
     {
         for (category i = category::CT_base;
@@ -105,6 +176,25 @@ public:
         }
     }
 
+    /** Record a socket write and the send queue depth when it began. */
+    void addWrite (std::size_t queueDepth, std::size_t bytes)
+    {
+        sendQueueDepth_.add (queueDepth);
+        bytesPerWrite_.add (bytes);
+    }
+
+    Histogram const&
+    getSendQueueDepth () const
+    {
+        return sendQueueDepth_;
+    }
+
+    Histogram const&
+    getBytesPerWrite () const
+    {
+        return bytesPerWrite_;
+    }
+
     std::map <std::string, TrafficStats>
     getCounts () const
     {
@@ -124,6 +214,8 @@ public:
     protected:
 
     std::map <category, TrafficStats> counts_;
+    Histogram sendQueueDepth_;
+    Histogram bytesPerWrite_;
 };
 
 }
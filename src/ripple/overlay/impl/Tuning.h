@@ -74,6 +74,13 @@ enum
 
     /** How often to log send queue size */
     sendQueueLogFreq    =    64,
+
+    /** The most queued messages combined into one socket write */
+    maxWriteMessages    =    64,
+
+    /** The most bytes of queued messages combined into one socket
+        write. Matches the largest TLS record. */
+    maxWriteBytes       = 16384,
 };
 
 } // Tuning
@@ -31,6 +31,7 @@
 #include <cstring>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 namespace ripple {
 
@@ -270,6 +271,24 @@ verify (PublicKey const& publicKey,
     Slice const& sig,
     bool mustBeFullyCanonical = true);
 
+/** A signature to be checked by verifyBatch. */
+struct SignatureCheck
+{
+    PublicKey publicKey;
+    Slice message;
+    Slice signature;
+    bool mustBeFullyCanonical;
+};
+
+/** Verify the signatures on several messages.
+    Each signature is verified individually, so every result is exactly
+    what verify would return. Callers spread large sets over several
+    jobs to check them in parallel.
+    @return One result for each check, in the same order.
+*/
+std::vector<bool>
+verifyBatch (std::vector<SignatureCheck> const& checks);
+
 /** Calculate the 160-bit node ID from a node public key. */
 NodeID
 calcNodeID (PublicKey const&);
@@ -22,6 +22,7 @@
 
 #include <ripple/protocol/SField.h>
 #include <boost/range.hpp>
+#include <cassert>
 #include <memory>
 
 namespace ripple {
@@ -92,8 +93,18 @@ public:
     /** Add an element to the template. */
     void push_back (SOElement const& r);
 
-    /** Retrieve the position of a named field. */
-    int getIndex (SField const&) const;
+    /** Retrieve the position of a named field.
+
+        This is a table lookup on the field's number, so callers on hot
+        paths can use it to find a field without searching.
+    */
+    int getIndex (SField const& f) const
+    {
+        // The mapping table should be large enough for any possible field
+        assert (f.getNum () < mIndex.size ());
+
+        return mIndex[f.getNum ()];
+    }
 
     SOE_Flags
     style(SField const& sf) const
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <stdexcept>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
 namespace ripple {
@@ -416,12 +417,34 @@ public:
         return &v_[offset].get();
     }
 
-    int getFieldIndex (SField const& field) const;
+    /** Return the position of a field, or -1 if it is absent.
+
+        Objects with a template look the field up in the template's
+        index, free objects search their fields.
+    */
+    int getFieldIndex (SField const& field) const
+    {
+        if (mType != nullptr)
+            return mType->getIndex (field);
+
+        return searchFieldIndex (field);
+    }
+
     SField const& getFieldSType (int index) const;
 
     const STBase& peekAtField (SField const& field) const;
     STBase& getField (SField const& field);
-    const STBase* peekAtPField (SField const& field) const;
+
+    const STBase* peekAtPField (SField const& field) const
+    {
+        int const index = getFieldIndex (field);
+
+        if (index == -1)
+            return nullptr;
+
+        return peekAtPIndex (index);
+    }
+
     STBase* getPField (SField const& field, bool createOkay = false);
 
     // these throw if the field type doesn't match, or return default values
@@ -565,6 +588,28 @@ private:
     // This way of comparing STObjects always works, but is slower.
     static bool equivalentSTObject (STObject const& obj1, STObject const& obj2);
 
+    // Linear search for a field in an object without a template.
+    int searchFieldIndex (SField const& field) const;
+
+    // Convert a field to the type the caller expects, or return nullptr.
+    // A field almost always has exactly the expected type, which is much
+    // cheaper to confirm than walking the hierarchy with dynamic_cast.
+    template <typename T>
+    static T const* fieldCast (STBase const* rf)
+    {
+        if (rf && typeid (*rf) == typeid (T))
+            return static_cast<T const*> (rf);
+        return dynamic_cast<T const*> (rf);
+    }
+
+    template <typename T>
+    static T* fieldCast (STBase* rf)
+    {
+        if (rf && typeid (*rf) == typeid (T))
+            return static_cast<T*> (rf);
+        return dynamic_cast<T*> (rf);
+    }
+
     // Implementation for getting (most) fields that return by value.
     //
     // The remove_cv and remove_reference are necessitated by the STBitString
@@ -585,7 +630,7 @@ private:
         if (id == STI_NOTPRESENT)
             return V (); // optional field not present
 
-        const T* cf = dynamic_cast<const T*> (rf);
+        const T* cf = fieldCast<T> (rf);
 
         if (! cf)
             Throw<std::runtime_error> ("Wrong field type");
@@ -611,7 +656,7 @@ private:
         if (id == STI_NOTPRESENT)
             return empty; // optional field not present
 
-        const T* cf = dynamic_cast<const T*> (rf);
+        const T* cf = fieldCast<T> (rf);
 
         if (! cf)
             Throw<std::runtime_error> ("Wrong field type");
@@ -633,7 +678,7 @@ private:
         if (rf->getSType () == STI_NOTPRESENT)
             rf = makeFieldPresent (field);
 
-        T* cf = dynamic_cast<T*> (rf);
+        T* cf = fieldCast<T> (rf);
 
         if (! cf)
             Throw<std::runtime_error> ("Wrong field type");
@@ -653,7 +698,7 @@ private:
         if (rf->getSType () == STI_NOTPRESENT)
             rf = makeFieldPresent (field);
 
-        T* cf = dynamic_cast<T*> (rf);
+        T* cf = fieldCast<T> (rf);
 
         if (! cf)
             Throw<std::runtime_error> ("Wrong field type");
@@ -673,7 +718,7 @@ private:
         if (rf->getSType () == STI_NOTPRESENT)
             rf = makeFieldPresent (field);
 
-        T* cf = dynamic_cast<T*> (rf);
+        T* cf = fieldCast<T> (rf);
 
         if (! cf)
             Throw<std::runtime_error> ("Wrong field type");
@@ -720,7 +765,7 @@ inline
 T const*
 STObject::Proxy<T>::find() const
 {
-    return dynamic_cast<T const*>(
+    return fieldCast<T>(
         st_->peekAtPField(*f_));
 }
 
@@ -737,10 +782,10 @@ STObject::Proxy<T>::assign(U&& u)
     }
     T* t;
     if (style_ == SOE_INVALID)
-        t = dynamic_cast<T*>(
+        t = fieldCast<T>(
             st_->getPField(*f_, true));
     else
-        t = dynamic_cast<T*>(
+        t = fieldCast<T>(
             st_->makeFieldPresent(*f_));
     assert(t);
     *t = std::forward<U>(u);
@@ -896,7 +941,7 @@ STObject::operator[](TypedField<T> const& f) const
         // with no template
         Throw<missing_field_error> (f);
     auto const u =
-        dynamic_cast<T const*>(b);
+        fieldCast<T>(b);
     if (! u)
     {
         assert(mType);
@@ -922,7 +967,7 @@ STObject::operator[](OptionaledField<T> const& of) const
     if (! b)
         return boost::none;
     auto const u =
-        dynamic_cast<T const*>(b);
+        fieldCast<T>(b);
     if (! u)
     {
         assert(mType);
@@ -135,6 +135,16 @@ public:
     std::pair<bool, std::string>
     checkSign(bool allowMultiSign) const;
 
+    /** Check the signatures of several transactions.
+        The results match calling checkSign on each transaction, but
+        single signatures are verified as one batch.
+        @return One result for each transaction, in the same order.
+    */
+    static
+    std::vector<std::pair<bool, std::string>>
+    checkSignBatch(std::vector<STTx const*> const& txs,
+        bool allowMultiSign);
+
     // SQL Functions with metadata.
     static
     std::string const&
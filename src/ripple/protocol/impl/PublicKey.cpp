@@ -301,6 +301,24 @@ verify (PublicKey const& publicKey,
     return false;
 }
 
+std::vector<bool>
+verifyBatch (std::vector<SignatureCheck> const& checks)
+{
+    // Each signature is checked on its own. donna's batch equation is
+    // cofactorless and randomly weighted, so it can accept signatures
+    // with small order components which verify always rejects, and every
+    // node must reach the same result. Confirming what it accepts costs
+    // more than the batch saves.
+    std::vector<bool> result;
+    result.reserve (checks.size());
+    for (auto const& check : checks)
+    {
+        result.push_back (verify (check.publicKey, check.message,
+            check.signature, check.mustBeFullyCanonical));
+    }
+    return result;
+}
+
 NodeID
 calcNodeID (PublicKey const& pk)
 {
@@ -307,11 +307,8 @@ uint256 STObject::getSigningHash (std::uint32_t prefix) const
     return s.getSHA512Half ();
 }
 
-int STObject::getFieldIndex (SField const& field) const
+int STObject::searchFieldIndex (SField const& field) const
 {
-    if (mType != nullptr)
-        return mType->getIndex (field);
-
     int i = 0;
     for (auto const& elem : v_)
     {
@@ -348,16 +345,6 @@ STObject::getFieldSType (int index) const
     return v_[index]->getFName ();
 }
 
-const STBase* STObject::peekAtPField (SField const& field) const
-{
-    int index = getFieldIndex (field);
-
-    if (index == -1)
-        return nullptr;
-
-    return peekAtPIndex (index);
-}
-
 STBase* STObject::getPField (SField const& field, bool createOkay)
 {
     int index = getFieldIndex (field);
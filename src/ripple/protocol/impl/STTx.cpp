@@ -205,6 +205,62 @@ std::pair<bool, std::string> STTx::checkSign(bool allowMultiSign) const
     return ret;
 }
 
+std::vector<std::pair<bool, std::string>>
+STTx::checkSignBatch(std::vector<STTx const*> const& txs,
+    bool allowMultiSign)
+{
+    std::vector<std::pair<bool, std::string>> ret (txs.size());
+
+    // The checks refer to these, so they are sized up front.
+    std::vector<Blob> data (txs.size());
+    std::vector<Blob> signatures (txs.size());
+    std::vector<SignatureCheck> checks;
+    std::vector<std::size_t> index;
+
+    for (std::size_t i = 0; i < txs.size(); ++i)
+    {
+        auto const& tx = *txs[i];
+        try
+        {
+            auto const spk = tx.getFieldVL (sfSigningPubKey);
+            if ((allowMultiSign && spk.empty ()) ||
+                tx.isFieldPresent (sfSigners) ||
+                ! publicKeyType (makeSlice(spk)))
+            {
+                // Not a well formed single signature, so the
+                // usual check produces the right result.
+                ret[i] = tx.checkSign (allowMultiSign);
+                continue;
+            }
+
+            signatures[i] = tx.getFieldVL (sfTxnSignature);
+            data[i] = getSigningData (tx);
+            checks.push_back ({
+                PublicKey (makeSlice(spk)),
+                makeSlice(data[i]),
+                makeSlice(signatures[i]),
+                (tx.getFlags() & tfFullyCanonicalSig) != 0});
+            index.push_back (i);
+        }
+        catch (std::exception const&)
+        {
+            // Assume it was a signature failure.
+            ret[i] = {false, "Invalid signature."};
+        }
+    }
+
+    auto const valid = verifyBatch (checks);
+    for (std::size_t i = 0; i < index.size(); ++i)
+    {
+        if (valid[i])
+            ret[index[i]] = {true, ""};
+        else
+            ret[index[i]] = {false, "Invalid signature."};
+    }
+
+    return ret;
+}
+
 Json::Value STTx::getJson (int) const
 {
     Json::Value ret = STObject::getJson (0);
@@ -24,6 +24,11 @@
 #include <ripple/net/InfoSub.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Status.h>
+#include <functional>
+
+namespace Json {
+class Object;
+}
 
 namespace ripple {
 namespace RPC {
@@ -33,6 +38,26 @@ struct Context;
 /** Execute an RPC command and store the results in a Json::Value. */
 Status doCommand (RPC::Context&, Json::Value&);
 
+/** Writes the result of a checked RPC command to a Json::Object. */
+using ResultWriter = std::function <void (Json::Object&)>;
+
+/** Check an RPC command, ready for its result to be written.
+
+    Handlers which support it check the request here and write their result
+    directly to the object passed to the writer, so that it can be streamed
+    to the client as it is produced. Any other handler is run here, and the
+    writer copies out its result.
+
+    @param writer Set to write the result, if the command succeeded.
+    @param error Set to describe the failure, if the command failed.
+    @return A status which is an error if the command failed.
+*/
+Status prepareCommand (RPC::Context&, ResultWriter& writer,
+    Json::Value& error);
+
+/** Return a copy of a request with potentially sensitive fields masked. */
+Json::Value maskedRequest (Json::Value const& params);
+
 Role roleRequired (std::string const& method );
 
 } // RPC
@@ -17,16 +17,13 @@
 */
 //==============================================================================
 
-#include <ripple/json/json_writer.h>
+
+#include <ripple/rpc/handlers/AccountObjects.h>
 #include <ripple/app/main/Application.h>
-#include <ripple/ledger/ReadView.h>
-#include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/Indexes.h>
 #include <ripple/protocol/JsonFields.h>
-#include <ripple/protocol/LedgerFormats.h>
 #include <ripple/resource/Fees.h>
-#include <ripple/rpc/Context.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/impl/Tuning.h>
 
@@ -34,55 +31,42 @@
 #include <sstream>
 
 namespace ripple {
+namespace RPC {
 
-/** General RPC command that can retrieve objects in the account root.
-    {
-      account: <account>|<account_public_key>
-      ledger_hash: <string> // optional
-      ledger_index: <string | unsigned integer> // optional
-      type: <string> // optional, defaults to all account objects types
-      limit: <integer> // optional
-      marker: <opaque> // optional, resume previous query
-    }
-*/
+AccountObjectsHandler::AccountObjectsHandler (Context& context)
+    : context_ (context)
+{
+}
 
-Json::Value doAccountObjects (RPC::Context& context)
+Status AccountObjectsHandler::check ()
 {
-    auto const& params = context.params;
+    auto const& params = context_.params;
     if (! params.isMember (jss::account))
-        return RPC::missing_field_error (jss::account);
+    {
+        return {rpcINVALID_PARAMS,
+            missing_field_message (std::string (jss::account))};
+    }
 
     std::shared_ptr<ReadView const> ledger;
-    auto result = RPC::lookupLedger (ledger, context);
-    if (ledger == nullptr)
-        return result;
+    if (auto s = lookupLedger (ledger, context_, result_))
+        return s;
 
     AccountID accountID;
     {
         auto const strIdent = params[jss::account].asString ();
-        if (auto jv = RPC::accountFromString (accountID, strIdent))
-        {
-            for (auto it = jv.begin (); it != jv.end (); ++it)
-                result[it.memberName ()] = *it;
-
-            return result;
-        }
+        if (auto jv = accountFromString (accountID, strIdent))
+            return errorStatus (jv);
     }
 
     if (! ledger->exists(keylet::account (accountID)))
-        return rpcError (rpcACT_NOT_FOUND);
+        return rpcACT_NOT_FOUND;
 
-    auto type = RPC::chooseLedgerEntryType(params);
+    auto type = chooseLedgerEntryType(params);
     if (type.first)
-    {
-        result.clear();
-        type.first.inject(result);
-        return result;
-    }
+        return type.first;
 
-    unsigned int limit;
-    if (auto err = readLimitField(limit, RPC::Tuning::accountObjects, context))
-        return *err;
+    if (auto err = readLimitField(limit_, Tuning::accountObjects, context_))
+        return errorStatus (*err);
 
     uint256 dirIndex;
     uint256 entryIndex;
@@ -90,32 +74,37 @@ Json::Value doAccountObjects (RPC::Context& context)
     {
         auto const& marker = params[jss::marker];
         if (! marker.isString ())
-            return RPC::expected_field_error (jss::marker, "string");
+        {
+            return {rpcINVALID_PARAMS,
+                expected_field_message (jss::marker, "string")};
+        }
 
         std::stringstream ss (marker.asString ());
         std::string s;
         if (!std::getline(ss, s, ','))
-            return RPC::invalid_field_error (jss::marker);
+            return {rpcINVALID_PARAMS, invalid_field_message (jss::marker)};
 
         if (! dirIndex.SetHex (s))
-            return RPC::invalid_field_error (jss::marker);
+            return {rpcINVALID_PARAMS, invalid_field_message (jss::marker)};
 
         if (! std::getline (ss, s, ','))
-            return RPC::invalid_field_error (jss::marker);
+            return {rpcINVALID_PARAMS, invalid_field_message (jss::marker)};
 
         if (! entryIndex.SetHex (s))
-            return RPC::invalid_field_error (jss::marker);
+            return {rpcINVALID_PARAMS, invalid_field_message (jss::marker)};
     }
 
-    if (! RPC::getAccountObjects (*ledger, accountID, type.second,
-        dirIndex, entryIndex, limit, result))
+    if (! getAccountObjects (*ledger, accountID, type.second,
+        dirIndex, entryIndex, limit_, objects_, marker_))
     {
-        result[jss::account_objects] = Json::arrayValue;
+        objects_.clear ();
+        marker_.reset ();
     }
 
-    result[jss::account] = context.app.accountIDCache().toBase58 (accountID);
-    context.loadType = Resource::feeMediumBurdenRPC;
-    return result;
+    result_[jss::account] = context_.app.accountIDCache().toBase58 (accountID);
+    context_.loadType = Resource::feeMediumBurdenRPC;
+    return Status::OK;
 }
 
+} // RPC
 } // ripple
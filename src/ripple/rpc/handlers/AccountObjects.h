@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_RPC_HANDLERS_ACCOUNTOBJECTS_H_INCLUDED
+#define RIPPLE_RPC_HANDLERS_ACCOUNTOBJECTS_H_INCLUDED
+
+#include <ripple/json/Object.h>
+#include <ripple/ledger/ReadView.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/Status.h>
+#include <ripple/rpc/impl/Handler.h>
+#include <ripple/rpc/Role.h>
+#include <boost/optional.hpp>
+#include <vector>
+
+namespace ripple {
+namespace RPC {
+
+/** General RPC command that can retrieve objects in the account root.
+    {
+      account: <account>|<account_public_key>
+      ledger_hash: <string> // optional
+      ledger_index: <string | unsigned integer> // optional
+      type: <string> // optional, defaults to all account objects types
+      limit: <integer> // optional
+      marker: <opaque> // optional, resume previous query
+    }
+*/
+
+class AccountObjectsHandler {
+public:
+    explicit AccountObjectsHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static char const* name()
+    {
+        return "account_objects";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NO_CONDITION;
+    }
+
+private:
+    Context& context_;
+    Json::Value result_;
+    std::vector<std::shared_ptr<SLE const>> objects_;
+    boost::optional<std::string> marker_;
+    unsigned int limit_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void AccountObjectsHandler::writeResult (Object& value)
+{
+    Json::copyFrom (value, result_);
+
+    {
+        auto&& objects = Json::setArray (value, jss::account_objects);
+        for (auto const& sle : objects_)
+            objects.append (sle->getJson (0));
+    }
+
+    if (marker_)
+    {
+        value[jss::limit] = limit_;
+        value[jss::marker] = *marker_;
+    }
+}
+
+} // RPC
+} // ripple
+
+#endif
@@ -17,62 +17,66 @@
 */
 //==============================================================================
 
+#include <ripple/rpc/handlers/AccountTx.h>
+#include <ripple/rpc/handlers/Handlers.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
-#include <ripple/app/misc/NetworkOPs.h>
-#include <ripple/app/misc/Transaction.h>
-#include <ripple/json/json_value.h>
 #include <ripple/ledger/ReadView.h>
-#include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/UintTypes.h>
 #include <ripple/resource/Fees.h>
-#include <ripple/rpc/Context.h>
-#include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/rpc/Role.h>
 
 namespace ripple {
+namespace RPC {
 
-// {
-//   account: account,
-//   ledger_index_min: ledger_index  // optional, defaults to earliest
-//   ledger_index_max: ledger_index, // optional, defaults to latest
-//   binary: boolean,                // optional, defaults to false
-//   forward: boolean,               // optional, defaults to false
-//   limit: integer,                 // optional
-//   marker: opaque                  // optional, resume previous query
-// }
-Json::Value doAccountTx (RPC::Context& context)
+AccountTxHandler::AccountTxHandler (Context& context) : context_ (context)
 {
-    auto& params = context.params;
+}
+
+Status AccountTxHandler::check ()
+{
+    auto& params = context_.params;
+
+    // Temporary switching code until the old account_tx is removed
+    if (params.isMember(jss::offset) ||
+        params.isMember(jss::count) ||
+        params.isMember(jss::descending) ||
+        params.isMember(jss::ledger_max) ||
+        params.isMember(jss::ledger_min))
+    {
+        legacy_ = true;
+        result_ = doAccountTxOld (context_);
+        if (contains_error (result_))
+            return errorStatus (result_);
+        return Status::OK;
+    }
 
     int limit = params.isMember (jss::limit) ?
             params[jss::limit].asUInt () : -1;
-    bool bBinary = params.isMember (jss::binary) && params[jss::binary].asBool ();
+    binary_ = params.isMember (jss::binary) && params[jss::binary].asBool ();
     bool bForward = params.isMember (jss::forward) && params[jss::forward].asBool ();
     std::uint32_t   uLedgerMin;
     std::uint32_t   uLedgerMax;
-    std::uint32_t   uValidatedMin;
-    std::uint32_t   uValidatedMax;
-    bool bValidated = context.ledgerMaster.getValidatedRange (
-        uValidatedMin, uValidatedMax);
+    bool bValidated = context_.ledgerMaster.getValidatedRange (
+        validatedMin_, validatedMax_);
 
     if (!bValidated)
     {
         // Don't have a validated ledger range.
-        return rpcError (rpcLGR_IDXS_INVALID);
+        return rpcLGR_IDXS_INVALID;
     }
 
     if (!params.isMember (jss::account))
-        return rpcError (rpcINVALID_PARAMS);
+        return rpcINVALID_PARAMS;
 
     auto const account = parseBase58<AccountID>(
         params[jss::account].asString());
     if (! account)
-        return rpcError (rpcACT_MALFORMED);
+        return rpcACT_MALFORMED;
 
-    context.loadType = Resource::feeMediumBurdenRPC;
+    context_.loadType = Resource::feeMediumBurdenRPC;
 
     if (params.isMember (jss::ledger_index_min) ||
         params.isMember (jss::ledger_index_max))
@@ -82,36 +86,35 @@ Json::Value doAccountTx (RPC::Context& context)
         std::int64_t iLedgerMax  = params.isMember (jss::ledger_index_max)
                 ? params[jss::ledger_index_max].asInt () : -1;
 
-        uLedgerMin  = iLedgerMin == -1 ? uValidatedMin :
-            ((iLedgerMin >= uValidatedMin) ? iLedgerMin : uValidatedMin);
-        uLedgerMax  = iLedgerMax == -1 ? uValidatedMax :
-            ((iLedgerMax <= uValidatedMax) ? iLedgerMax : uValidatedMax);
+        uLedgerMin  = iLedgerMin == -1 ? validatedMin_ :
+            ((iLedgerMin >= validatedMin_) ? iLedgerMin : validatedMin_);
+        uLedgerMax  = iLedgerMax == -1 ? validatedMax_ :
+            ((iLedgerMax <= validatedMax_) ? iLedgerMax : validatedMax_);
 
         if (uLedgerMax < uLedgerMin)
-            return rpcError (rpcLGR_IDXS_INVALID);
+            return rpcLGR_IDXS_INVALID;
     }
     else if(params.isMember (jss::ledger_hash) ||
             params.isMember (jss::ledger_index))
     {
         std::shared_ptr<ReadView const> ledger;
-        auto ret = RPC::lookupLedger (ledger, context);
-
-        if (! ledger)
-            return ret;
+        Json::Value ret;
+        if (auto s = lookupLedger (ledger, context_, ret))
+            return s;
 
         if (! ret[jss::validated].asBool() ||
-            (ledger->info().seq > uValidatedMax) ||
-            (ledger->info().seq < uValidatedMin))
+            (ledger->info().seq > validatedMax_) ||
+            (ledger->info().seq < validatedMin_))
         {
-            return rpcError (rpcLGR_NOT_VALIDATED);
+            return rpcLGR_NOT_VALIDATED;
         }
 
         uLedgerMin = uLedgerMax = ledger->info().seq;
     }
     else
     {
-        uLedgerMin = uValidatedMin;
-        uLedgerMax = uValidatedMax;
+        uLedgerMin = validatedMin_;
+        uLedgerMax = validatedMax_;
     }
 
     Json::Value resumeToken;
@@ -124,78 +127,42 @@ Json::Value doAccountTx (RPC::Context& context)
     try
     {
 #endif
-        Json::Value ret (Json::objectValue);
-
-        ret[jss::account] = context.app.accountIDCache().toBase58(*account);
-        Json::Value& jvTxns = (ret[jss::transactions] = Json::arrayValue);
+        result_[jss::account] =
+            context_.app.accountIDCache().toBase58(*account);
 
-        if (bBinary)
+        // Only fetch the transactions here; they are rendered as the
+        // result is written.
+        if (binary_)
         {
-            auto txns = context.netOps.getTxsAccountB (
+            txnsB_ = context_.netOps.getTxsAccountB (
                 *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                jvObj[jss::tx_blob] = std::get<0> (it);
-                jvObj[jss::meta] = std::get<1> (it);
-
-                std::uint32_t uLedgerIndex = std::get<2> (it);
-
-                jvObj[jss::ledger_index] = uLedgerIndex;
-                jvObj[jss::validated] = bValidated &&
-                    uValidatedMin <= uLedgerIndex &&
-                    uValidatedMax >= uLedgerIndex;
-            }
+                isUnlimited (context_.role));
         }
         else
         {
-            auto txns = context.netOps.getTxsAccount (
+            txns_ = context_.netOps.getTxsAccount (
                 *account, uLedgerMin, uLedgerMax, bForward, resumeToken, limit,
-                isUnlimited (context.role));
-
-            for (auto& it: txns)
-            {
-                Json::Value& jvObj = jvTxns.append (Json::objectValue);
-
-                if (it.first)
-                    jvObj[jss::tx] = it.first->getJson (1);
-
-                if (it.second)
-                {
-                    auto meta = it.second->getJson (1);
-                    addPaymentDeliveredAmount (meta, context, it.first, it.second);
-                    jvObj[jss::meta] = std::move(meta);
-
-                    std::uint32_t uLedgerIndex = it.second->getLgrSeq ();
-
-                    jvObj[jss::validated] = bValidated &&
-                        uValidatedMin <= uLedgerIndex &&
-                        uValidatedMax >= uLedgerIndex;
-                }
-
-            }
+                isUnlimited (context_.role));
         }
 
         //Add information about the original query
-        ret[jss::ledger_index_min] = uLedgerMin;
-        ret[jss::ledger_index_max] = uLedgerMax;
+        result_[jss::ledger_index_min] = uLedgerMin;
+        result_[jss::ledger_index_max] = uLedgerMax;
         if (params.isMember (jss::limit))
-            ret[jss::limit]        = limit;
+            result_[jss::limit]        = limit;
         if (resumeToken)
-            ret[jss::marker] = resumeToken;
+            result_[jss::marker] = resumeToken;
 
-        return ret;
+        return Status::OK;
 #ifndef BEAST_DEBUG
     }
     catch (std::exception const&)
     {
-        return rpcError (rpcINTERNAL);
+        return rpcINTERNAL;
     }
 
 #endif
 }
 
+} // RPC
 } // ripple
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+#define RIPPLE_RPC_HANDLERS_ACCOUNTTX_H_INCLUDED
+
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/misc/Transaction.h>
+#include <ripple/json/Object.h>
+#include <ripple/protocol/JsonFields.h>
+#include <ripple/rpc/Context.h>
+#include <ripple/rpc/Status.h>
+#include <ripple/rpc/impl/Handler.h>
+#include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/rpc/Role.h>
+
+namespace ripple {
+namespace RPC {
+
+// {
+//   account: account,
+//   ledger_index_min: ledger_index  // optional, defaults to earliest
+//   ledger_index_max: ledger_index, // optional, defaults to latest
+//   binary: boolean,                // optional, defaults to false
+//   forward: boolean,               // optional, defaults to false
+//   limit: integer,                 // optional
+//   marker: opaque                  // optional, resume previous query
+// }
+//
+// Requests using the parameters of the original account_tx (offset, count,
+// descending, ledger_min or ledger_max) are answered by doAccountTxOld.
+
+class AccountTxHandler {
+public:
+    explicit AccountTxHandler (Context&);
+
+    Status check ();
+
+    template <class Object>
+    void writeResult (Object&);
+
+    static char const* name()
+    {
+        return "account_tx";
+    }
+
+    static Role role()
+    {
+        return Role::USER;
+    }
+
+    static Condition condition()
+    {
+        return NO_CONDITION;
+    }
+
+private:
+    bool isValidated (std::uint32_t ledgerIndex) const
+    {
+        return validatedMin_ <= ledgerIndex && validatedMax_ >= ledgerIndex;
+    }
+
+    Context& context_;
+    Json::Value result_;
+    bool legacy_ = false;
+    bool binary_ = false;
+    std::uint32_t validatedMin_ = 0;
+    std::uint32_t validatedMax_ = 0;
+    NetworkOPs::AccountTxs txns_;
+    NetworkOPs::MetaTxsList txnsB_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation.
+
+template <class Object>
+void AccountTxHandler::writeResult (Object& value)
+{
+    if (legacy_)
+    {
+        Json::copyFrom (value, result_);
+        return;
+    }
+
+    value[jss::account] = result_[jss::account];
+
+    {
+        auto&& jvTxns = Json::setArray (value, jss::transactions);
+
+        if (binary_)
+        {
+            for (auto const& it: txnsB_)
+            {
+                auto&& jvObj = Json::appendObject (jvTxns);
+
+                jvObj[jss::tx_blob] = std::get<0> (it);
+                jvObj[jss::meta] = std::get<1> (it);
+
+                std::uint32_t uLedgerIndex = std::get<2> (it);
+
+                jvObj[jss::ledger_index] = uLedgerIndex;
+                jvObj[jss::validated] = isValidated (uLedgerIndex);
+            }
+        }
+        else
+        {
+            for (auto const& it: txns_)
+            {
+                auto&& jvObj = Json::appendObject (jvTxns);
+
+                if (it.first)
+                    jvObj[jss::tx] = it.first->getJson (1);
+
+                if (it.second)
+                {
+                    auto meta = it.second->getJson (1);
+                    addPaymentDeliveredAmount (
+                        meta, context_, it.first, it.second);
+                    jvObj[jss::meta] = meta;
+
+                    jvObj[jss::validated] =
+                        isValidated (it.second->getLgrSeq ());
+                }
+            }
+        }
+    }
+
+    // Add information about the original query
+    value[jss::ledger_index_min] = result_[jss::ledger_index_min];
+    value[jss::ledger_index_max] = result_[jss::ledger_index_max];
+    if (result_.isMember (jss::limit))
+        value[jss::limit] = result_[jss::limit];
+    if (result_.isMember (jss::marker))
+        value[jss::marker] = result_[jss::marker];
+}
+
+} // RPC
+} // ripple
+
+#endif
@@ -102,7 +102,13 @@ Json::Value doGetCounts (RPC::Context& context)
 
     ret[jss::historical_perminute] = static_cast<int>(
         context.app.getInboundLedgers().fetchRate());
-    ret[jss::SLE_hit_rate] = context.app.cachedSLEs().rate();
+    {
+        auto const& sles = context.app.cachedSLEs();
+        ret[jss::SLE_hit_rate] = sles.rate();
+        ret[jss::SLE_hits] = static_cast<Json::UInt> (sles.hits());
+        ret[jss::SLE_misses] = static_cast<Json::UInt> (sles.misses());
+        ret[jss::SLE_cache_size] = static_cast<Json::UInt> (sles.size());
+    }
     ret[jss::node_hit_rate] = context.app.getNodeStore ().getCacheHitRate ();
     ret[jss::ledger_hit_rate] = context.app.getLedgerMaster ().getCacheHitRate ();
     ret[jss::AL_hit_rate] = context.app.getAcceptedLedgerCache ().getHitRate ();
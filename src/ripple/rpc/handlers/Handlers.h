@@ -20,6 +20,9 @@
 #ifndef RIPPLE_RPC_HANDLERS_HANDLERS_H_INCLUDED
 #define RIPPLE_RPC_HANDLERS_HANDLERS_H_INCLUDED
 
+#include <ripple/rpc/handlers/AccountObjects.h>
+#include <ripple/rpc/handlers/AccountTx.h>
+#include <ripple/rpc/handlers/LedgerData.h>
 #include <ripple/rpc/handlers/LedgerHandler.h>
 
 namespace ripple {
@@ -28,10 +31,7 @@ Json::Value doAccountCurrencies     (RPC::Context&);
 Json::Value doAccountInfo           (RPC::Context&);
 Json::Value doAccountLines          (RPC::Context&);
 Json::Value doAccountChannels       (RPC::Context&);
-Json::Value doAccountObjects        (RPC::Context&);
 Json::Value doAccountOffers         (RPC::Context&);
-Json::Value doAccountTx             (RPC::Context&);
-Json::Value doAccountTxSwitch       (RPC::Context&);
 Json::Value doAccountTxOld          (RPC::Context&);
 Json::Value doBookOffers            (RPC::Context&);
 Json::Value doBlackList             (RPC::Context&);
@@ -51,7 +51,6 @@ Json::Value doLedgerAccept          (RPC::Context&);
 Json::Value doLedgerCleaner         (RPC::Context&);
 Json::Value doLedgerClosed          (RPC::Context&);
 Json::Value doLedgerCurrent         (RPC::Context&);
-Json::Value doLedgerData            (RPC::Context&);
 Json::Value doLedgerEntry           (RPC::Context&);
 Json::Value doLedgerHeader          (RPC::Context&);
 Json::Value doLedgerRequest         (RPC::Context&);
@@ -152,6 +152,12 @@ Json::Value doSubscribe (RPC::Context& context)
                     return rpcError(rpcNO_PERMISSION);
                 context.netOps.subPeerStatus (ispSub);
             }
+            else if (streamName == "state_diffs")
+            {
+                if (context.role != Role::ADMIN)
+                    return rpcError(rpcNO_PERMISSION);
+                context.netOps.subStateDiffs (ispSub);
+            }
             else
             {
                 return rpcError(rpcSTREAM_MALFORMED);
@@ -55,6 +55,22 @@ Status handle (Context& context, Object& object)
     return status;
 };
 
+template <class HandlerImpl>
+Status prepare (Context& context, ResultWriter& writer)
+{
+    auto handler = std::make_shared<HandlerImpl> (context);
+
+    auto status = handler->check ();
+    if (! status)
+    {
+        writer = [handler] (Json::Object& object)
+        {
+            handler->writeResult (object);
+        };
+    }
+    return status;
+}
+
 Handler const handlerArray[] {
     // Some handlers not specified here are added to the table via addHandler()
     // Request-response methods
@@ -62,9 +78,7 @@ Handler const handlerArray[] {
     {   "account_currencies",   byRef (&doAccountCurrencies),   Role::USER,  NO_CONDITION  },
     {   "account_lines",        byRef (&doAccountLines),        Role::USER,  NO_CONDITION  },
     {   "account_channels",     byRef (&doAccountChannels),     Role::USER,  NO_CONDITION  },
-    {   "account_objects",      byRef (&doAccountObjects),      Role::USER,  NO_CONDITION  },
     {   "account_offers",       byRef (&doAccountOffers),       Role::USER,  NO_CONDITION  },
-    {   "account_tx",           byRef (&doAccountTxSwitch),     Role::USER,  NO_CONDITION  },
     {   "blacklist",            byRef (&doBlackList),           Role::ADMIN,   NO_CONDITION     },
     {   "book_offers",          byRef (&doBookOffers),          Role::USER,  NO_CONDITION  },
     {   "can_delete",           byRef (&doCanDelete),           Role::ADMIN,   NO_CONDITION     },
@@ -83,7 +97,6 @@ Handler const handlerArray[] {
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),       Role::ADMIN,   NEEDS_NETWORK_CONNECTION  },
     {   "ledger_closed",        byRef (&doLedgerClosed),        Role::USER,  NO_CONDITION   },
     {   "ledger_current",       byRef (&doLedgerCurrent),       Role::USER,  NEEDS_CURRENT_LEDGER  },
-    {   "ledger_data",          byRef (&doLedgerData),          Role::USER,  NO_CONDITION  },
     {   "ledger_entry",         byRef (&doLedgerEntry),         Role::USER,  NO_CONDITION  },
     {   "ledger_header",        byRef (&doLedgerHeader),        Role::USER,  NO_CONDITION  },
     {   "ledger_request",       byRef (&doLedgerRequest),       Role::ADMIN,   NO_CONDITION     },
@@ -134,6 +147,9 @@ class HandlerTable {
         }
 
         // This is where the new-style handlers are added.
+        addHandler<AccountObjectsHandler>();
+        addHandler<AccountTxHandler>();
+        addHandler<LedgerDataHandler>();
         addHandler<LedgerHandler>();
         addHandler<VersionHandler>();
     }
@@ -172,6 +188,7 @@ class HandlerTable {
         Handler h;
         h.name_ = HandlerImpl::name();
         h.valueMethod_ = &handle<Json::Value, HandlerImpl>;
+        h.prepareMethod_ = &prepare<HandlerImpl>;
         h.role_ = HandlerImpl::role();
         h.condition_ = HandlerImpl::condition();
 
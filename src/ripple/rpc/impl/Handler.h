@@ -49,6 +49,11 @@ struct Handler
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+
+    // Set for handlers which can write their result directly
+    // to a streaming Json::Object.  The request is checked first and,
+    // on success, the writer is set to produce the result.
+    Method<ResultWriter> prepareMethod_;
 };
 
 Handler const* getHandler (std::string const&);
@@ -236,21 +236,7 @@ void getResult (
         JLOG (context.j.debug()) << "rpcError: " << status.toString();
         result[jss::status] = jss::error;
 
-        auto rq = context.params;
-
-        if (rq.isObject())
-        {
-            if (rq.isMember(jss::passphrase.c_str()))
-                rq[jss::passphrase.c_str()] = "<masked>";
-            if (rq.isMember(jss::secret.c_str()))
-                rq[jss::secret.c_str()] = "<masked>";
-            if (rq.isMember(jss::seed.c_str()))
-                rq[jss::seed.c_str()] = "<masked>";
-            if (rq.isMember(jss::seed_hex.c_str()))
-                rq[jss::seed_hex.c_str()] = "<masked>";
-        }
-
-        result[jss::request] = rq;
+        result[jss::request] = maskedRequest (context.params);
     }
     else
     {
@@ -296,6 +282,71 @@ Status doCommand (
     return rpcUNKNOWN_COMMAND;
 }
 
+Status prepareCommand (
+    RPC::Context& context, ResultWriter& writer, Json::Value& error)
+{
+    Handler const * handler = nullptr;
+    if (auto status = fillHandler (context, handler))
+    {
+        inject_error (status, error);
+        return status;
+    }
+
+    if (auto prepare = handler->prepareMethod_)
+    {
+        return callMethod (context,
+            [&prepare, &writer] (Context& c, Json::Value& e)
+            {
+                auto status = prepare (c, writer);
+                if (status)
+                    status.inject (e);
+                return status;
+            },
+            handler->name_, error);
+    }
+
+    Json::Value value;
+    auto status = callMethod (
+        context, handler->valueMethod_, handler->name_, value);
+    if (! status && value.isMember (jss::error))
+    {
+        status = value.isMember (jss::error_code)
+            ? error_code_i (value[jss::error_code].asInt ())
+            : rpcINTERNAL;
+    }
+
+    if (status)
+    {
+        error = std::move (value);
+        return status;
+    }
+
+    writer = [value = std::move (value)] (Json::Object& object)
+    {
+        Json::copyFrom (object, value);
+    };
+    return status;
+}
+
+Json::Value maskedRequest (Json::Value const& params)
+{
+    auto rq = params;
+
+    if (rq.isObject())
+    {
+        if (rq.isMember(jss::passphrase.c_str()))
+            rq[jss::passphrase.c_str()] = "<masked>";
+        if (rq.isMember(jss::secret.c_str()))
+            rq[jss::secret.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed.c_str()))
+            rq[jss::seed.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed_hex.c_str()))
+            rq[jss::seed_hex.c_str()] = "<masked>";
+    }
+
+    return rq;
+}
+
 Role roleRequired (std::string const& method)
 {
     auto handler = RPC::getHandler(method);
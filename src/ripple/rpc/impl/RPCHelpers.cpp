@@ -82,7 +82,9 @@ accountFromString(
 bool
 getAccountObjects(ReadView const& ledger, AccountID const& account,
     LedgerEntryType const type, uint256 dirIndex, uint256 const& entryIndex,
-    std::uint32_t const limit, Json::Value& jvResult)
+    std::uint32_t const limit,
+    std::vector<std::shared_ptr<SLE const>>& objects,
+    boost::optional<std::string>& marker)
 {
     auto const rootDirIndex = getOwnerDirIndex (account);
     auto found = false;
@@ -98,7 +100,6 @@ getAccountObjects(ReadView const& ledger, AccountID const& account,
         return false;
 
     std::uint32_t i = 0;
-    auto& jvObjects = (jvResult[jss::account_objects] = Json::arrayValue);
     for (;;)
     {
         auto const& entries = dir->getFieldV256 (sfIndexes);
@@ -118,14 +119,13 @@ getAccountObjects(ReadView const& ledger, AccountID const& account,
             auto const sleNode = ledger.read(keylet::child(*iter));
             if (type == ltINVALID || sleNode->getType () == type)
             {
-                jvObjects.append (sleNode->getJson (0));
+                objects.push_back (sleNode);
 
                 if (++i == limit)
                 {
                     if (++iter != entries.end ())
                     {
-                        jvResult[jss::limit] = limit;
-                        jvResult[jss::marker] = to_string (dirIndex) + ',' +
+                        marker = to_string (dirIndex) + ',' +
                             to_string (*iter);
                         return true;
                     }
@@ -149,8 +149,7 @@ getAccountObjects(ReadView const& ledger, AccountID const& account,
             auto const& e = dir->getFieldV256 (sfIndexes);
             if (! e.empty ())
             {
-                jvResult[jss::limit] = limit;
-                jvResult[jss::marker] = to_string (dirIndex) + ',' +
+                marker = to_string (dirIndex) + ',' +
                     to_string (*e.begin ());
             }
 
@@ -159,6 +158,19 @@ getAccountObjects(ReadView const& ledger, AccountID const& account,
     }
 }
 
+Status
+errorStatus (Json::Value const& error)
+{
+    assert (contains_error (error));
+
+    auto const code = error.isMember (jss::error_code)
+        ? error_code_i (error[jss::error_code].asInt ())
+        : rpcINTERNAL;
+    if (error.isMember (jss::error_message))
+        return Status (code, error[jss::error_message].asString ());
+    return Status (code);
+}
+
 namespace {
 
 bool
@@ -22,10 +22,14 @@
 
 #include <ripple/beast/core/SemanticVersion.h>
 #include <ripple/ledger/TxMeta.h>
+#include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/Status.h>
 #include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace Json {
 class Value;
@@ -59,12 +63,16 @@ accountFromString (AccountID& result, std::string const& strIdent,
     @param dirIndex Begin gathering account objects from this directory.
     @param entryIndex Begin gathering objects from this directory node.
     @param limit Maximum number of objects to find.
-    @param jvResult A JSON result that holds the request objects.
+    @param objects Receives the objects found.
+    @param marker Set to the resume point if more objects remain.
+    @return false if the starting directory or entry was not found.
 */
 bool
 getAccountObjects (ReadView const& ledger, AccountID const& account,
     LedgerEntryType const type, uint256 dirIndex, uint256 const& entryIndex,
-    std::uint32_t const limit, Json::Value& jvResult);
+    std::uint32_t const limit,
+    std::vector<std::shared_ptr<SLE const>>& objects,
+    boost::optional<std::string>& marker);
 
 /** Look up a ledger from a request and fill a Json::Result with either
     an error, or data representing a ledger.
@@ -83,6 +91,13 @@ lookupLedger (std::shared_ptr<ReadView const>&, Context&);
 Status
 lookupLedger (std::shared_ptr<ReadView const>&, Context&, Json::Value& result);
 
+/** Return the RPC error held in a Json::Value as a Status.
+
+    The value must contain an error, as made by rpcError or make_error.
+*/
+Status
+errorStatus (Json::Value const& error);
+
 hash_set <AccountID>
 parseAccountIds(Json::Value const& jvArray);
 
@@ -23,6 +23,7 @@
 #include <ripple/beast/rfc2616.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/json/Object.h>
 #include <ripple/rpc/json_body.h>
 #include <ripple/rpc/ServerHandler.h>
 #include <ripple/server/Server.h>
@@ -37,6 +38,7 @@
 #include <ripple/overlay/Overlay.h>
 #include <ripple/resource/ResourceManager.h>
 #include <ripple/resource/Fees.h>
+#include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/server/SimpleWriter.h>
@@ -341,13 +343,8 @@ ServerHandlerImp::onWSMessage(
         [this, session, jv = std::move(jv)]
         (std::shared_ptr<JobQueue::Coro> const& coro)
         {
-            auto const jr =
-                this->processSession(session, coro, jv);
-            auto const s = to_string(jr);
-            auto const n = s.length();
-            boost::beast::multi_buffer sb(n);
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+            boost::beast::multi_buffer sb;
+            this->processSession(session, coro, jv, sb);
             session->send(std::make_shared<
                 StreambufWSMsg<decltype(sb)>>(std::move(sb)));
             session->complete();
@@ -375,11 +372,23 @@ ServerHandlerImp::onStopped (Server&)
 
 //------------------------------------------------------------------------------
 
-Json::Value
+// Returns an Output which appends to a message buffer.
+static
+Json::Output
+bufferOutput (boost::beast::multi_buffer& sb)
+{
+    return [&sb](boost::beast::string_view const& b)
+    {
+        sb.commit(boost::asio::buffer_copy(
+            sb.prepare(b.size()), boost::asio::buffer(b.data(), b.size())));
+    };
+}
+
+void
 ServerHandlerImp::processSession(
     std::shared_ptr<WSSession> const& session,
         std::shared_ptr<JobQueue::Coro> const& coro,
-            Json::Value const& jv)
+            Json::Value const& jv, boost::beast::multi_buffer& sb)
 {
     auto is = std::static_pointer_cast<WSInfoSub> (session->appDefined);
     if (is->getConsumer().disconnect())
@@ -387,9 +396,21 @@ ServerHandlerImp::processSession(
         session->close();
         // FIX: This rpcError is not delivered since the session
         // was just closed.
-        return rpcError(rpcSLOW_DOWN);
+        Json::outputJson(rpcError(rpcSLOW_DOWN), bufferOutput(sb));
+        return;
     }
 
+    // Adds the fields which echo the request.
+    auto const addRequestFields = [&jv](auto& object)
+    {
+        if (jv.isMember(jss::id))
+            object[jss::id] = jv[jss::id];
+        if (jv.isMember(jss::jsonrpc))
+            object[jss::jsonrpc] = jv[jss::jsonrpc];
+        if (jv.isMember(jss::ripplerpc))
+            object[jss::ripplerpc] = jv[jss::ripplerpc];
+    };
+
     // Requests without "command" are invalid.
     Json::Value jr(Json::objectValue);
     Resource::Charge loadType = Resource::feeReferenceRPC;
@@ -405,15 +426,11 @@ ServerHandlerImp::processSession(
             jr[jss::status] = jss::error;
             jr[jss::error] = jss::missingCommand;
             jr[jss::request] = jv;
-            if (jv.isMember (jss::id))
-                jr[jss::id]  = jv[jss::id];
-            if (jv.isMember(jss::jsonrpc))
-                jr[jss::jsonrpc] = jv[jss::jsonrpc];
-            if (jv.isMember(jss::ripplerpc))
-                jr[jss::ripplerpc] = jv[jss::ripplerpc];
+            addRequestFields(jr);
 
             is->getConsumer().charge(Resource::feeInvalidRPC);
-            return jr;
+            Json::outputJson(jr, bufferOutput(sb));
+            return;
         }
 
         auto required = RPC::roleRequired(jv.isMember(jss::command) ?
@@ -445,11 +462,39 @@ ServerHandlerImp::processSession(
                 is,
                 {is->user(), is->forwarded_for()}
                 };
-            RPC::doCommand(context, jr[jss::result]);
+
+            RPC::ResultWriter writeResult;
+            if (! RPC::prepareCommand(context, writeResult, jr[jss::result]))
+            {
+                // Write the result straight into the message buffer.
+                Json::Writer writer(bufferOutput(sb));
+                Json::Object::Root root(writer);
+                {
+                    auto result = Json::addObject(root, jss::result);
+                    writeResult(result);
+                }
+
+                is->getConsumer().charge(loadType);
+                if (is->getConsumer().warn())
+                    root[jss::warning] = jss::load;
+                root[jss::status] = jss::success;
+
+                // For testing resource limits on this connection.
+                if (is->getConsumer().isUnlimited() &&
+                    jv[jss::command].isString() &&
+                    jv[jss::command].asString() == "ping")
+                        root[jss::unlimited] = true;
+
+                addRequestFields(root);
+                root[jss::type] = jss::response;
+                return;
+            }
         }
     }
     catch (std::exception const& ex)
     {
+        // Discard anything written before the failure.
+        sb.consume(sb.size());
         jr[jss::result] = RPC::make_error(rpcINTERNAL);
         JLOG(m_journal.error())
            << "Exception while processing WS: " << ex.what() << "\n"
@@ -464,47 +509,21 @@ ServerHandlerImp::processSession(
     // API, in the future maybe we can make the responses
     // consistent.
     //
-    // Regularize result. This is duplicate code.
+    // Regularize result.
     if (jr[jss::result].isMember(jss::error))
     {
         jr = jr[jss::result];
         jr[jss::status] = jss::error;
-
-        auto rq = jv;
-
-        if (rq.isObject())
-        {
-            if (rq.isMember(jss::passphrase.c_str()))
-                rq[jss::passphrase.c_str()] = "<masked>";
-            if (rq.isMember(jss::secret.c_str()))
-                rq[jss::secret.c_str()] = "<masked>";
-            if (rq.isMember(jss::seed.c_str()))
-                rq[jss::seed.c_str()] = "<masked>";
-            if (rq.isMember(jss::seed_hex.c_str()))
-                rq[jss::seed_hex.c_str()] = "<masked>";
-        }
-
-        jr[jss::request] = rq;
+        jr[jss::request] = RPC::maskedRequest(jv);
     }
     else
     {
         jr[jss::status] = jss::success;
-
-        // For testing resource limits on this connection.
-        if (is->getConsumer().isUnlimited() &&
-            jv[jss::command].isString() &&
-            jv[jss::command].asString() == "ping")
-                jr[jss::unlimited] = true;
     }
 
-    if (jv.isMember(jss::id))
-        jr[jss::id] = jv[jss::id];
-    if (jv.isMember(jss::jsonrpc))
-        jr[jss::jsonrpc] = jv[jss::jsonrpc];
-    if (jv.isMember(jss::ripplerpc))
-        jr[jss::ripplerpc] = jv[jss::ripplerpc];
+    addRequestFields(jr);
     jr[jss::type] = jss::response;
-    return jr;
+    Json::outputJson(jr, bufferOutput(sb));
 }
 
 // Run as a coroutine.
@@ -512,7 +531,7 @@ void
 ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
-    processRequest (
+    auto const keepAlive = processRequest (
         session->port(), buffers_to_string(
             session->request().body().data()),
                 session->remoteAddress().at_port (0),
@@ -534,9 +553,10 @@ ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
             if(iter != session->request().end())
                 return iter->value().to_string();
             return std::string{};
-        }());
+        }(),
+        session->request().version() >= 11);
 
-    if(beast::rfc2616::is_keep_alive(session->request()))
+    if(keepAlive && beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
     else
         session->close (true);
@@ -558,11 +578,11 @@ Json::Int constexpr method_not_found  = -32601;
 Json::Int constexpr server_overloaded = -32604;
 Json::Int constexpr forbidden         = -32605;
 
-void
+bool
 ServerHandlerImp::processRequest (Port const& port,
     std::string const& request, beast::IP::Endpoint const& remoteIPAddress,
         Output&& output, std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user)
+        std::string forwardedFor, std::string user, bool chunked)
 {
     auto rpcJ = app_.journal ("RPC");
 
@@ -576,7 +596,7 @@ ServerHandlerImp::processRequest (Port const& port,
         {
             HTTPReply (400, "Unable to parse request: " +
                        reader.getFormatedErrorMessages(), output, rpcJ);
-            return;
+            return true;
         }
     }
 
@@ -588,7 +608,7 @@ ServerHandlerImp::processRequest (Port const& port,
         if(!jsonOrig.isMember(jss::params) || !jsonOrig[jss::params].isArray())
         {
             HTTPReply (400, "Malformed batch request", output, rpcJ);
-            return;
+            return true;
         }
         size = jsonOrig[jss::params].size();
     }
@@ -637,7 +657,7 @@ ServerHandlerImp::processRequest (Port const& port,
                 if (!batch)
                 {
                     HTTPReply(503, "Server is overloaded", output, rpcJ);
-                    return;
+                    return true;
                 }
                 Json::Value r = jsonRPC;
                 r[jss::error] = make_json_error(server_overloaded, "Server is overloaded");
@@ -652,7 +672,7 @@ ServerHandlerImp::processRequest (Port const& port,
             if (!batch)
             {
                 HTTPReply (403, "Forbidden", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(forbidden, "Forbidden");
@@ -666,7 +686,7 @@ ServerHandlerImp::processRequest (Port const& port,
             if (!batch)
             {
                 HTTPReply (400, "Null method", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "Null method");
@@ -681,7 +701,7 @@ ServerHandlerImp::processRequest (Port const& port,
             if (!batch)
             {
                 HTTPReply (400, "method is not string", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "method is not string");
@@ -696,7 +716,7 @@ ServerHandlerImp::processRequest (Port const& port,
             if (!batch)
             {
                 HTTPReply (400, "method is empty", output, rpcJ);
-                return;
+                return true;
             }
             Json::Value r = jsonRPC;
             r[jss::error] = make_json_error(method_not_found, "method is empty");
@@ -721,7 +741,7 @@ ServerHandlerImp::processRequest (Port const& port,
             {
                 usage.charge(Resource::feeInvalidRPC);
                 HTTPReply (400, "params unparseable", output, rpcJ);
-                return;
+                return true;
             }
             else
             {
@@ -730,7 +750,7 @@ ServerHandlerImp::processRequest (Port const& port,
                 {
                     usage.charge(Resource::feeInvalidRPC);
                     HTTPReply (400, "params unparseable", output, rpcJ);
-                    return;
+                    return true;
                 }
             }
         }
@@ -764,8 +784,82 @@ ServerHandlerImp::processRequest (Port const& port,
         RPC::Context context {m_journal, params, app_, loadType, m_networkOPs,
             app_.getLedgerMaster(), usage, role, coro, InfoSub::pointer(),
             {user, forwardedFor}};
+
         Json::Value result;
-        RPC::doCommand (context, result);
+
+        // Handlers which can write their result as they go have it streamed
+        // straight to the client, rather than building the whole response
+        // in memory first.  A request which fails its checks is reported
+        // as usual below.
+        auto const handler = RPC::getHandler (strMethod);
+        if (chunked && ! batch && ripplerpc < "2.0" &&
+            handler && handler->prepareMethod_)
+        {
+            RPC::ResultWriter writeResult;
+            if (! RPC::prepareCommand (context, writeResult, result))
+            {
+                usage.charge (loadType);
+
+                HTTPChunkedReply chunkedReply (200, output);
+                try
+                {
+                    Json::Writer writer (chunkedReply.body ());
+                    Json::Object::Root root (writer);
+                    try
+                    {
+                        {
+                            auto object = Json::addObject (root, jss::result);
+                            writeResult (object);
+                            if (usage.warn())
+                                object[jss::warning] = jss::load;
+                            object[jss::status] = jss::success;
+                        }
+
+                        if (params.isMember(jss::jsonrpc))
+                            root[jss::jsonrpc] = params[jss::jsonrpc];
+                        if (params.isMember(jss::ripplerpc))
+                            root[jss::ripplerpc] = params[jss::ripplerpc];
+                        if (params.isMember(jss::id))
+                            root[jss::id] = params[jss::id];
+                    }
+                    catch (...)
+                    {
+                        // Stop the output before the writer's destructors
+                        // close the open arrays and objects, which would
+                        // make a partial result look complete.
+                        chunkedReply.abort ();
+                        throw;
+                    }
+                }
+                catch (std::exception const& e)
+                {
+                    // The headers are already sent. Leave the reply
+                    // without its final chunk and drop the connection, so
+                    // the client sees that the body is incomplete.
+                    JLOG (m_journal.error()) <<
+                        "Exception while streaming RPC reply: " << e.what ();
+                    return false;
+                }
+                chunkedReply.write ("\n");
+                chunkedReply.finish ();
+
+                rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
+                    std::chrono::duration_cast <std::chrono::milliseconds> (
+                        std::chrono::high_resolution_clock::now () - start)));
+                ++rpc_requests_;
+                rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
+                    chunkedReply.size ()));
+
+                JLOG (m_journal.debug()) <<
+                    "Reply: " << chunkedReply.size () << " bytes streamed";
+                return true;
+            }
+        }
+        else
+        {
+            RPC::doCommand (context, result);
+        }
+
         usage.charge (loadType);
         if (usage.warn())
             result[jss::warning] = jss::load;
@@ -795,22 +889,8 @@ ServerHandlerImp::processRequest (Port const& port,
             // Always report "status".  On an error report the request as received.
             if (result.isMember (jss::error))
             {
-                auto rq = params;
-
-                if (rq.isObject())
-                { // But mask potentially sensitive information.
-                    if (rq.isMember(jss::passphrase.c_str()))
-                        rq[jss::passphrase.c_str()] = "<masked>";
-                    if (rq.isMember(jss::secret.c_str()))
-                        rq[jss::secret.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed.c_str()))
-                        rq[jss::seed.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed_hex.c_str()))
-                        rq[jss::seed_hex.c_str()] = "<masked>";
-                }
-
                 result[jss::status] = jss::error;
-                result[jss::request] = rq;
+                result[jss::request] = RPC::maskedRequest (params);
 
                 JLOG (m_journal.debug())  <<
                     "rpcError: " << result [jss::error] <<
@@ -855,6 +935,7 @@ ServerHandlerImp::processRequest (Port const& port,
     }
 
     HTTPReply (200, response, output, rpcJ);
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -28,6 +28,7 @@
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/json/Output.h>
+#include <boost/beast/core/multi_buffer.hpp>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -166,21 +167,23 @@ public:
     onStopped (Server&);
 
 private:
-    Json::Value
+    void
     processSession(
         std::shared_ptr<WSSession> const& session,
             std::shared_ptr<JobQueue::Coro> const& coro,
-                Json::Value const& jv);
+                Json::Value const& jv, boost::beast::multi_buffer& sb);
 
     void
     processSession (std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
-    void
+    // Returns `false` if the reply was cut short and the connection
+    // must be closed.
+    bool
     processRequest (Port const& port, std::string const& request,
         beast::IP::Endpoint const& remoteIPAddress, Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user);
+        std::string forwardedFor, std::string user, bool chunked);
 
     Handoff
     statusResponse(http_request_type const& request) const;
@@ -85,6 +85,15 @@ public:
                 std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(Message const& msg, bool) override
+    {
+        auto sp = ws_.lock();
+        if(! sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(msg.text()));
+    }
 };
 
 } // ripple
@@ -24,6 +24,7 @@
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/json/to_string.h>
 #include <boost/algorithm/string.hpp>
+#include <cstdio>
 
 namespace ripple {
 
@@ -47,6 +48,20 @@ std::string getHTTPHeaderTimestamp ()
     return std::string (buffer);
 }
 
+static
+void writeStatusLine (int nStatus, Json::Output const& output)
+{
+    switch (nStatus)
+    {
+    case 200: output ("HTTP/1.1 200 OK\r\n"); break;
+    case 400: output ("HTTP/1.1 400 Bad Request\r\n"); break;
+    case 403: output ("HTTP/1.1 403 Forbidden\r\n"); break;
+    case 404: output ("HTTP/1.1 404 Not Found\r\n"); break;
+    case 500: output ("HTTP/1.1 500 Internal Server Error\r\n"); break;
+    case 503: output ("HTTP/1.1 503 Server is overloaded\r\n"); break;
+    }
+}
+
 void HTTPReply (
     int nStatus, std::string const& content, Json::Output const& output, beast::Journal j)
 {
@@ -86,15 +101,7 @@ void HTTPReply (
         return;
     }
 
-    switch (nStatus)
-    {
-    case 200: output ("HTTP/1.1 200 OK\r\n"); break;
-    case 400: output ("HTTP/1.1 400 Bad Request\r\n"); break;
-    case 403: output ("HTTP/1.1 403 Forbidden\r\n"); break;
-    case 404: output ("HTTP/1.1 404 Not Found\r\n"); break;
-    case 500: output ("HTTP/1.1 500 Internal Server Error\r\n"); break;
-    case 503: output ("HTTP/1.1 503 Server is overloaded\r\n"); break;
-    }
+    writeStatusLine (nStatus, output);
 
     output (getHTTPHeaderTimestamp ());
 
@@ -117,4 +124,66 @@ void HTTPReply (
     output ("\r\n");
 }
 
+HTTPChunkedReply::HTTPChunkedReply (
+        int nStatus, Json::Output const& output, std::size_t chunkSize)
+    : output_ (output)
+    , chunkSize_ (chunkSize)
+{
+    writeStatusLine (nStatus, output_);
+
+    output_ (getHTTPHeaderTimestamp ());
+    output_ ("Connection: Keep-Alive\r\n"
+             "Transfer-Encoding: chunked\r\n"
+             "Content-Type: application/json; charset=UTF-8\r\n");
+    output_ ("Server: " + systemName () + "-json-rpc/");
+    output_ (BuildInfo::getFullVersionString ());
+    output_ ("\r\n"
+             "\r\n");
+
+    buffer_.reserve (chunkSize_);
+}
+
+void
+HTTPChunkedReply::write (boost::beast::string_view const& data)
+{
+    if (aborted_)
+        return;
+    buffer_.append (data.data (), data.size ());
+    size_ += data.size ();
+    if (buffer_.size () >= chunkSize_)
+        flush ();
+}
+
+void
+HTTPChunkedReply::flush ()
+{
+    if (buffer_.empty ())
+        return;
+
+    char size[20];
+    auto const n = std::snprintf (
+        size, sizeof (size), "%zx\r\n", buffer_.size ());
+    output_ (boost::beast::string_view (size, n));
+    buffer_ += "\r\n";
+    output_ (buffer_);
+    buffer_.clear ();
+}
+
+void
+HTTPChunkedReply::finish ()
+{
+    if (aborted_)
+        return;
+    flush ();
+    output_ ("0\r\n"
+             "\r\n");
+}
+
+void
+HTTPChunkedReply::abort ()
+{
+    aborted_ = true;
+    buffer_.clear ();
+}
+
 } // ripple
@@ -22,12 +22,64 @@
 
 #include <ripple/json/json_value.h>
 #include <ripple/json/Output.h>
+#include <string>
 
 namespace ripple {
 
 void HTTPReply (
     int nStatus, std::string const& strMsg, Json::Output const&, beast::Journal j);
 
+/** Writes an HTTP/1.1 reply whose body is produced incrementally.
+
+    The headers are written on construction. The body is sent with
+    chunked transfer encoding, buffered so that each chunk is a
+    reasonable size, and so a large reply never has to be held in
+    memory all at once. finish() must be called to end the reply.
+*/
+class HTTPChunkedReply
+{
+public:
+    HTTPChunkedReply (int nStatus, Json::Output const& output,
+        std::size_t chunkSize = 16 * 1024);
+
+    HTTPChunkedReply (HTTPChunkedReply const&) = delete;
+    HTTPChunkedReply& operator= (HTTPChunkedReply const&) = delete;
+
+    /** Append to the body. */
+    void write (boost::beast::string_view const& data);
+
+    /** Return an Output which appends to the body. */
+    Json::Output body ()
+    {
+        return [this](boost::beast::string_view const& b) { write (b); };
+    }
+
+    /** Send any buffered data and the terminating chunk. */
+    void finish ();
+
+    /** Discard any buffered data and ignore all later output.
+
+        The reply is left without its terminating chunk, so the client
+        can tell that it is incomplete once the connection is closed.
+    */
+    void abort ();
+
+    /** Return the number of body bytes written so far. */
+    std::size_t size () const
+    {
+        return size_;
+    }
+
+private:
+    void flush ();
+
+    Json::Output const& output_;
+    std::size_t const chunkSize_;
+    std::string buffer_;
+    std::size_t size_ = 0;
+    bool aborted_ = false;
+};
+
 } // ripple
 
 #endif
@@ -42,6 +42,8 @@
 
 namespace ripple {
 
+class JobQueue;
+
 enum class SHAMapState
 {
     Modifying = 0,       // Objects can be added and removed (like an open ledger)
@@ -250,6 +252,15 @@ public:
                   Delta& differences, int maxCount) const;
 
     int flushDirty (NodeObjectType t, std::uint32_t seq);
+
+    /** Flush dirty nodes, hashing and writing the top-level subtrees in
+        parallel on the job queue.
+
+        Each subtree's nodes are handed to the node store as one batch.
+        The calling thread takes part in the work, so this completes even
+        if no job queue thread is free.
+    */
+    int flushDirty (NodeObjectType t, std::uint32_t seq, JobQueue& jobQueue);
     void walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing) const;
     bool deepCompare (SHAMap & other) const;  // Intended for debug/test only
 
@@ -310,10 +321,15 @@ private:
         std::shared_ptr<Node>
         preFlushNode(std::shared_ptr<Node> node) const;
 
-    /** write and canonicalize modified node */
+    /** write and canonicalize modified node
+
+        If `batch` is not null the node is added to it instead of being
+        stored, and the caller is responsible for storing the batch.
+    */
     std::shared_ptr<SHAMapAbstractNode>
         writeNode(NodeObjectType t, std::uint32_t seq,
-                  std::shared_ptr<SHAMapAbstractNode> node) const;
+                  std::shared_ptr<SHAMapAbstractNode> node,
+                  NodeStore::Batch* batch = nullptr) const;
 
     SHAMapTreeNode* firstBelow (std::shared_ptr<SHAMapAbstractNode>,
                                 SharedPtrNodeStack& stack, int branch = 0) const;
@@ -349,7 +365,14 @@ private:
     bool walkBranch (SHAMapAbstractNode* node,
                      std::shared_ptr<SHAMapItem const> const& otherMapItem,
                      bool isFirstMap, Delta & differences, int & maxCount) const;
-    int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
+    int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq,
+                     JobQueue* jobQueue = nullptr);
+    int flushInner (std::shared_ptr<SHAMapInnerNode>& node,
+                    bool doWrite, NodeObjectType t, std::uint32_t seq,
+                    NodeStore::Batch* batch);
+    int flushSubTrees (std::shared_ptr<SHAMapInnerNode>& node,
+                       NodeObjectType t, std::uint32_t seq,
+                       JobQueue& jobQueue);
     bool isInconsistentNode(std::shared_ptr<SHAMapAbstractNode> const& node) const;
 
     // Structure to track information about call to
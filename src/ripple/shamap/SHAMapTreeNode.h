@@ -22,9 +22,12 @@
 
 #include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/SHAMapNodeID.h>
+#include <ripple/basics/spinlock.h>
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/beast/utility/Journal.h>
 
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -142,14 +145,29 @@ class SHAMapInnerNodeV2;
 class SHAMapInnerNode
     : public SHAMapAbstractNode
 {
-    std::array<SHAMapHash, 16>          mHashes;
-    std::shared_ptr<SHAMapAbstractNode> mChildren[16];
+    // The hashes, then the children, of the present branches only, in
+    // branch order. Most inner nodes have only a few branches, so the
+    // block is sized to fit and allocated from a slab for its size.
+    void*                           mBranches = nullptr;
+    std::uint8_t                    mCapacity = 0;
     int                             mIsBranch = 0;
     std::uint32_t                   mFullBelowGen = 0;
 
-    static std::mutex               childLock;
+    // Guards publication of children on shared nodes
+    mutable spinlock                childLock_;
+
+    SHAMapHash* hashes () const;
+    std::shared_ptr<SHAMapAbstractNode>* children () const;
+    int branchIndex (int m) const;
+
+    void reserve (int count);
+    std::shared_ptr<SHAMapAbstractNode>& addBranch (int m);
+    void removeBranch (int m);
+    void setHashes (std::array<SHAMapHash, 16> const& hashes);
+
 public:
     SHAMapInnerNode(std::uint32_t seq);
+    ~SHAMapInnerNode() override;
     std::shared_ptr<SHAMapAbstractNode> clone(std::uint32_t seq) const override;
 
     bool isEmpty () const;
@@ -344,12 +362,40 @@ SHAMapInnerNode::isEmptyBranch (int m) const
     return (mIsBranch & (1 << m)) == 0;
 }
 
+inline
+SHAMapHash*
+SHAMapInnerNode::hashes () const
+{
+    return static_cast<SHAMapHash*>(mBranches);
+}
+
+inline
+std::shared_ptr<SHAMapAbstractNode>*
+SHAMapInnerNode::children () const
+{
+    return reinterpret_cast<std::shared_ptr<SHAMapAbstractNode>*>(
+        static_cast<std::uint8_t*>(mBranches) +
+            mCapacity * sizeof (SHAMapHash));
+}
+
+// The position of branch m among the present branches
+inline
+int
+SHAMapInnerNode::branchIndex (int m) const
+{
+    return static_cast<int>(
+        std::bitset<16>(mIsBranch & ((1 << m) - 1)).count());
+}
+
 inline
 SHAMapHash const&
 SHAMapInnerNode::getChildHash (int m) const
 {
     assert ((m >= 0) && (m < 16) && (getType() == tnINNER));
-    return mHashes[m];
+    static SHAMapHash const zero {};
+    if (isEmptyBranch (m))
+        return zero;
+    return hashes()[branchIndex (m)];
 }
 
 inline
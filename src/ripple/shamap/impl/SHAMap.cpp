@@ -18,7 +18,14 @@
 //==============================================================================
 
 #include <ripple/basics/contract.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/shamap/SHAMap.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace ripple {
 
@@ -1105,7 +1112,8 @@ bool SHAMap::fetchRoot (SHAMapHash const& hash, SHAMapSyncFilter* filter)
 // a mutable snapshot of a mutable SHAMap.
 std::shared_ptr<SHAMapAbstractNode>
 SHAMap::writeNode (
-    NodeObjectType t, std::uint32_t seq, std::shared_ptr<SHAMapAbstractNode> node) const
+    NodeObjectType t, std::uint32_t seq, std::shared_ptr<SHAMapAbstractNode> node,
+    NodeStore::Batch* batch) const
 {
     // Node is ours, so we can just make it shareable
     assert (node->getSeq() == seq_);
@@ -1116,8 +1124,12 @@ SHAMap::writeNode (
 
     Serializer s;
     node->addRaw (s, snfPREFIX);
-    f_.db().store (t, std::move (s.modData ()),
-        node->getNodeHash ().as_uint256(), ledgerSeq_);
+    if (batch)
+        batch->push_back (NodeObject::createObject (t,
+            std::move (s.modData ()), node->getNodeHash ().as_uint256()));
+    else
+        f_.db().store (t, std::move (s.modData ()),
+            node->getNodeHash ().as_uint256(), ledgerSeq_);
     return node;
 }
 
@@ -1154,8 +1166,15 @@ int SHAMap::flushDirty (NodeObjectType t, std::uint32_t seq)
     return walkSubTree (true, t, seq);
 }
 
+int SHAMap::flushDirty (
+    NodeObjectType t, std::uint32_t seq, JobQueue& jobQueue)
+{
+    return walkSubTree (true, t, seq, &jobQueue);
+}
+
 int
-SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
+SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq,
+    JobQueue* jobQueue)
 {
     int flushed = 0;
     Serializer s;
@@ -1185,13 +1204,35 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         return 1;
     }
 
+    node = preFlushNode(std::move(node));
+
+    if (jobQueue && doWrite && backed_)
+        flushed = flushSubTrees (node, t, seq, *jobQueue);
+    else
+        flushed = flushInner (node, doWrite, t, seq, nullptr);
+
+    // The flushed inner node is the new root_
+    root_ = std::move (node);
+
+    return flushed;
+}
+
+// Flush an unshared inner node and every modified node below it.
+// On return, `node` is the shareable version of the inner node.
+int
+SHAMap::flushInner (std::shared_ptr<SHAMapInnerNode>& node,
+    bool doWrite, NodeObjectType t, std::uint32_t seq,
+    NodeStore::Batch* batch)
+{
+    assert (node->getSeq() == seq_);
+
+    int flushed = 0;
+
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair <std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-    node = preFlushNode(std::move(node));
-
     int pos = 0;
 
     // We can't flush an inner node until we flush its children
@@ -1234,7 +1275,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
                         child->updateHash();
 
                         if (doWrite && backed_)
-                            child = writeNode(t, seq, std::move(child));
+                            child = writeNode(t, seq, std::move(child), batch);
                         else
                             child->setSeq (0);
 
@@ -1250,7 +1291,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         // This inner node can now be shared
         if (doWrite && backed_)
             node = std::static_pointer_cast<SHAMapInnerNode>(writeNode(t, seq,
-                                                                       std::move(node)));
+                                                                       std::move(node), batch));
         else
             node->setSeq (0);
 
@@ -1272,12 +1313,129 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move (node);
-
     return flushed;
 }
 
+// Flush the modified subtrees below an unshared root in parallel, then
+// the root itself. Subtrees share no modified nodes, so each one can be
+// hashed and written independently; only the root is touched by more
+// than one of them, and it is only updated once all of them are done.
+int
+SHAMap::flushSubTrees (std::shared_ptr<SHAMapInnerNode>& node,
+    NodeObjectType t, std::uint32_t seq, JobQueue& jobQueue)
+{
+    assert (node->getSeq() == seq_);
+
+    int flushed = 0;
+
+    std::vector<int> branches;
+    std::vector<std::shared_ptr<SHAMapInnerNode>> subtrees;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (node->isEmptyBranch (branch))
+            continue;
+
+        auto child = node->getChild (branch);
+        if (!child || (child->getSeq() == 0))
+            continue;
+
+        child = preFlushNode (std::move (child));
+
+        if (child->isInner ())
+        {
+            branches.push_back (branch);
+            subtrees.push_back (std::static_pointer_cast<SHAMapInnerNode>(
+                std::move (child)));
+        }
+        else
+        {
+            ++flushed;
+            child->updateHash ();
+            child = writeNode (t, seq, std::move (child));
+            node->shareChild (branch, child);
+        }
+    }
+
+    // Helpers may start after all the work is done and the caller has
+    // returned, so only the shared state may be touched until a subtree
+    // has been claimed.
+    struct State
+    {
+        explicit State (std::size_t total) : total (total)
+        {
+        }
+
+        std::size_t const total;
+        std::atomic<std::size_t> next {0};
+        std::size_t done = 0;
+        int flushed = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto const state = std::make_shared<State> (subtrees.size ());
+
+    auto const work = [this, &subtrees, t, seq, state]
+    {
+        for (auto i = state->next++; i < state->total; i = state->next++)
+        {
+            int count = 0;
+            std::exception_ptr error;
+            try
+            {
+                NodeStore::Batch batch;
+                count = flushInner (subtrees[i], true, t, seq, &batch);
+                f_.db().storeBatch (batch, ledgerSeq_);
+            }
+            catch (...)
+            {
+                error = std::current_exception ();
+            }
+
+            std::lock_guard<std::mutex> lock (state->mutex);
+            state->flushed += count;
+            if (error && !state->error)
+                state->error = error;
+            if (++state->done == state->total)
+                state->cv.notify_all ();
+        }
+    };
+
+    if (!subtrees.empty ())
+    {
+        auto const helpers = std::min<std::size_t> (
+            std::max (1u, std::thread::hardware_concurrency ()) - 1,
+            subtrees.size () - 1);
+
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            jobQueue.addJob (jtACCEPT, "SHAMap::flushSubTrees",
+                [work](Job&) { work(); });
+        }
+
+        work ();
+
+        std::unique_lock<std::mutex> lock (state->mutex);
+        state->cv.wait (lock, [&] { return state->done == state->total; });
+
+        if (state->error)
+            std::rethrow_exception (state->error);
+
+        flushed += state->flushed;
+    }
+
+    // Hook the flushed subtrees to the root
+    for (std::size_t i = 0; i < subtrees.size (); ++i)
+        node->shareChild (branches[i], subtrees[i]);
+
+    node->updateHashDeep ();
+    node = std::static_pointer_cast<SHAMapInnerNode>(
+        writeNode (t, seq, std::move (node)));
+
+    return flushed + 1;
+}
+
 void SHAMap::dump (bool hash) const
 {
     int leafCount = 0;
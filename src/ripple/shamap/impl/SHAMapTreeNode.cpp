@@ -25,29 +25,214 @@
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/beast/core/LexicalCast.h>
+#include <ripple/basics/SlabAllocator.h>
 #include <mutex>
+#include <new>
 
 #include <openssl/sha.h>
 
 namespace ripple {
 
-std::mutex SHAMapInnerNode::childLock;
-
 SHAMapAbstractNode::~SHAMapAbstractNode() = default;
 
+namespace {
+
+// Inner node branch blocks come in a few sizes. Most inner nodes have
+// between two and six branches; full ones are mostly near the root.
+constexpr std::array<std::uint8_t, 5> branchCapacities {{2, 4, 6, 8, 16}};
+
+std::size_t
+branchBlockSize (int capacity)
+{
+    return capacity *
+        (sizeof (SHAMapHash) + sizeof (std::shared_ptr<SHAMapAbstractNode>));
+}
+
+int
+capacityClass (int count)
+{
+    assert (count > 0 && count <= 16);
+    int c = 0;
+    while (branchCapacities[c] < count)
+        ++c;
+    return c;
+}
+
+// The slabs are shared by every map, since nodes are shared between
+// maps, snapshots and the tree node cache of each family.
+SlabAllocator&
+branchAllocator (int capacity)
+{
+    static std::array<std::unique_ptr<SlabAllocator>,
+        branchCapacities.size()> const allocators = []
+        {
+            std::array<std::unique_ptr<SlabAllocator>,
+                branchCapacities.size()> ret;
+            for (std::size_t i = 0; i < ret.size(); ++i)
+            {
+                auto const size = branchBlockSize (branchCapacities[i]);
+                ret[i] = std::make_unique<SlabAllocator>(
+                    size, 1024 * 1024);
+            }
+            return ret;
+        }();
+    return *allocators[capacityClass (capacity)];
+}
+
+} // anonymous namespace
+
+SHAMapInnerNode::~SHAMapInnerNode()
+{
+    if (mBranches)
+    {
+        for (int i = 0, count = getBranchCount (); i < count; ++i)
+        {
+            children()[i].~shared_ptr();
+            hashes()[i].~SHAMapHash();
+        }
+        branchAllocator (mCapacity).deallocate (mBranches);
+    }
+}
+
+// Resize the branch block to hold at least `count` branches, keeping
+// the present ones.
+void
+SHAMapInnerNode::reserve (int count)
+{
+    int const present = getBranchCount ();
+    assert (count >= present);
+
+    int const capacity = (count == 0) ?
+        0 : branchCapacities[capacityClass (count)];
+    if (capacity == mCapacity)
+        return;
+
+    void* block = nullptr;
+    if (capacity != 0)
+    {
+        block = branchAllocator (capacity).allocate ();
+        auto const newHashes = static_cast<SHAMapHash*>(block);
+        auto const newChildren =
+            reinterpret_cast<std::shared_ptr<SHAMapAbstractNode>*>(
+                static_cast<std::uint8_t*>(block) +
+                    capacity * sizeof (SHAMapHash));
+        for (int i = 0; i < present; ++i)
+        {
+            new (&newHashes[i]) SHAMapHash (hashes()[i]);
+            new (&newChildren[i]) std::shared_ptr<SHAMapAbstractNode>(
+                std::move (children()[i]));
+        }
+    }
+
+    if (mBranches)
+    {
+        for (int i = 0; i < present; ++i)
+        {
+            children()[i].~shared_ptr();
+            hashes()[i].~SHAMapHash();
+        }
+        branchAllocator (mCapacity).deallocate (mBranches);
+    }
+
+    mBranches = block;
+    mCapacity = capacity;
+}
+
+// Make branch m present, if it isn't, and return its child
+std::shared_ptr<SHAMapAbstractNode>&
+SHAMapInnerNode::addBranch (int m)
+{
+    int const index = branchIndex (m);
+
+    if (isEmptyBranch (m))
+    {
+        int const count = getBranchCount ();
+        if (count == mCapacity)
+            reserve (count + 1);
+
+        auto const h = hashes();
+        auto const c = children();
+        new (&h[count]) SHAMapHash ();
+        new (&c[count]) std::shared_ptr<SHAMapAbstractNode>();
+        for (int i = count; i > index; --i)
+        {
+            h[i] = h[i - 1];
+            c[i] = std::move (c[i - 1]);
+        }
+        h[index].zero();
+        c[index].reset();
+        mIsBranch |= (1 << m);
+    }
+
+    return children()[index];
+}
+
+void
+SHAMapInnerNode::removeBranch (int m)
+{
+    if (isEmptyBranch (m))
+        return;
+
+    int const count = getBranchCount ();
+    auto const h = hashes();
+    auto const c = children();
+    for (int i = branchIndex (m); i < count - 1; ++i)
+    {
+        h[i] = h[i + 1];
+        c[i] = std::move (c[i + 1]);
+    }
+    c[count - 1].~shared_ptr();
+    h[count - 1].~SHAMapHash();
+    mIsBranch &= ~ (1 << m);
+
+    if (count == 1)
+    {
+        branchAllocator (mCapacity).deallocate (mBranches);
+        mBranches = nullptr;
+        mCapacity = 0;
+    }
+}
+
+// Set the branches of a node being built from its serialized form
+void
+SHAMapInnerNode::setHashes (std::array<SHAMapHash, 16> const& hashes)
+{
+    assert (mIsBranch == 0);
+
+    int count = 0;
+    for (auto const& h : hashes)
+        if (h.isNonZero ())
+            ++count;
+    if (count == 0)
+        return;
+
+    reserve (count);
+    for (int i = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+        {
+            addBranch (i);
+            this->hashes()[branchIndex (i)] = hashes[i];
+        }
+    }
+}
+
 std::shared_ptr<SHAMapAbstractNode>
 SHAMapInnerNode::clone(std::uint32_t seq) const
 {
     auto p = std::make_shared<SHAMapInnerNode>(seq);
     p->mHash = mHash;
-    p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
-    std::lock_guard <std::mutex> lock(childLock);
+    std::lock_guard <spinlock> lock(childLock_);
+    p->reserve (getBranchCount ());
     for (int i = 0; i < 16; ++i)
     {
-        p->mChildren[i] = mChildren[i];
-        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) == nullptr);
+        if (isEmptyBranch (i))
+            continue;
+        auto const index = branchIndex (i);
+        p->addBranch (i) = children()[index];
+        p->hashes()[index] = hashes()[index];
+        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(children()[index]) == nullptr);
     }
     return std::move(p);
 }
@@ -57,18 +242,21 @@ SHAMapInnerNodeV2::clone(std::uint32_t seq) const
 {
     auto p = std::make_shared<SHAMapInnerNodeV2>(seq);
     p->mHash = mHash;
-    p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
     p->common_ = common_;
     p->depth_ = depth_;
-    std::lock_guard <std::mutex> lock(childLock);
+    std::lock_guard <spinlock> lock(childLock_);
+    p->reserve (getBranchCount ());
     for (int i = 0; i < 16; ++i)
     {
-        p->mChildren[i] = mChildren[i];
-        if (p->mChildren[i] != nullptr)
-            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) != nullptr ||
-                   std::dynamic_pointer_cast<SHAMapTreeNode>(p->mChildren[i]) != nullptr);
+        if (isEmptyBranch (i))
+            continue;
+        auto const index = branchIndex (i);
+        p->addBranch (i) = children()[index];
+        p->hashes()[index] = hashes()[index];
+        if (children()[index] != nullptr)
+            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(children()[index]) != nullptr ||
+                   std::dynamic_pointer_cast<SHAMapTreeNode>(children()[index]) != nullptr);
     }
     return std::move(p);
 }
@@ -147,13 +335,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -164,6 +349,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
             // compressed inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -171,10 +357,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -206,13 +391,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -224,6 +406,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
             // compressed v2 inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -231,10 +414,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -304,13 +486,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
             else
                 ret = std::make_shared<SHAMapInnerNode>(seq);
 
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
 
             if (isV2)
             {
@@ -367,8 +546,8 @@ SHAMapInnerNode::updateHash()
         sha512_half_hasher h;
         using beast::hash_append;
         hash_append(h, HashPrefix::innerNode);
-        for(auto const& hh : mHashes)
-            hash_append(h, hh);
+        for (int i = 0; i < 16; ++i)
+            hash_append(h, getChildHash (i));
         nh = static_cast<typename
             sha512_half_hasher::result_type>(h);
     }
@@ -381,10 +560,10 @@ SHAMapInnerNode::updateHash()
 void
 SHAMapInnerNode::updateHashDeep()
 {
-    for (auto pos = 0; pos < 16; ++pos)
+    for (int i = 0, count = getBranchCount (); i < count; ++i)
     {
-        if (mChildren[pos] != nullptr)
-            mHashes[pos] = mChildren[pos]->getNodeHash();
+        if (children()[i] != nullptr)
+            hashes()[i] = children()[i]->getNodeHash();
     }
     updateHash();
 }
@@ -440,18 +619,18 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
         {
             s.add32 (HashPrefix::innerNode);
 
-            for (auto const& hh : mHashes)
-                s.add256 (hh.as_uint256());
+            for (int i = 0; i < 16; ++i)
+                s.add256 (getChildHash (i).as_uint256());
         }
         else  // format == snfWIRE
         {
             if (getBranchCount () < 12)
             {
                 // compressed node
-                for (int i = 0; i < mHashes.size(); ++i)
+                for (int i = 0; i < 16; ++i)
                     if (!isEmptyBranch (i))
                     {
-                        s.add256 (mHashes[i].as_uint256());
+                        s.add256 (getChildHash (i).as_uint256());
                         s.add8 (i);
                     }
 
@@ -459,8 +638,8 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
             }
             else
             {
-                for (auto const& hh : mHashes)
-                    s.add256 (hh.as_uint256());
+                for (int i = 0; i < 16; ++i)
+                    s.add256 (getChildHash (i).as_uint256());
 
                 s.add8 (2);
             }
@@ -478,7 +657,7 @@ SHAMapInnerNodeV2::addRaw(Serializer& s, SHANodeFormat format) const
         s.add32 (HashPrefix::innerNodeV2);
 
         for (int i = 0 ; i < 16; ++i)
-            s.add256 (mHashes[i].as_uint256());
+            s.add256 (getChildHash (i).as_uint256());
 
         s.add8(depth_);
 
@@ -591,13 +770,7 @@ bool SHAMapInnerNode::isEmpty () const
 int SHAMapInnerNode::getBranchCount () const
 {
     assert (isInner ());
-    int count = 0;
-
-    for (int i = 0; i < 16; ++i)
-        if (!isEmptyBranch (i))
-            ++count;
-
-    return count;
+    return static_cast<int>(std::bitset<16>(mIsBranch).count());
 }
 
 std::string
@@ -615,14 +788,14 @@ std::string
 SHAMapInnerNode::getString(const SHAMapNodeID & id) const
 {
     std::string ret = SHAMapAbstractNode::getString(id);
-    for (int i = 0; i < mHashes.size(); ++i)
+    for (int i = 0; i < 16; ++i)
     {
         if (!isEmptyBranch (i))
         {
             ret += "\nb";
             ret += beast::lexicalCastThrow <std::string> (i);
             ret += " = ";
-            ret += to_string (mHashes[i]);
+            ret += to_string (getChildHash (i));
         }
     }
     return ret;
@@ -658,13 +831,16 @@ SHAMapInnerNode::setChild(int m, std::shared_ptr<SHAMapAbstractNode> const& chil
     assert (mType == tnINNER);
     assert (mSeq != 0);
     assert (child.get() != this);
-    mHashes[m].zero();
     mHash.zero();
     if (child)
-        mIsBranch |= (1 << m);
+    {
+        addBranch (m) = child;
+        hashes()[branchIndex (m)].zero();
+    }
     else
-        mIsBranch &= ~ (1 << m);
-    mChildren[m] = child;
+    {
+        removeBranch (m);
+    }
 }
 
 // finished modifying, now make shareable
@@ -675,8 +851,9 @@ void SHAMapInnerNode::shareChild (int m, std::shared_ptr<SHAMapAbstractNode> con
     assert (mSeq != 0);
     assert (child);
     assert (child.get() != this);
+    assert (!isEmptyBranch (m));
 
-    mChildren[m] = child;
+    children()[branchIndex (m)] = child;
 }
 
 SHAMapAbstractNode*
@@ -685,8 +862,11 @@ SHAMapInnerNode::getChildPointer (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInner());
 
-    std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch].get ();
+    if (isEmptyBranch (branch))
+        return nullptr;
+
+    std::lock_guard <spinlock> lock (childLock_);
+    return children()[branchIndex (branch)].get ();
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -695,8 +875,11 @@ SHAMapInnerNode::getChild (int branch)
     assert (branch >= 0 && branch < 16);
     assert (isInner());
 
-    std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch];
+    if (isEmptyBranch (branch))
+        return {};
+
+    std::lock_guard <spinlock> lock (childLock_);
+    return children()[branchIndex (branch)];
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -705,20 +888,22 @@ SHAMapInnerNode::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractNod
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
+    assert (!isEmptyBranch (branch));
 
-    std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    std::lock_guard <spinlock> lock (childLock_);
+    auto& child = children()[branchIndex (branch)];
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
         // Hook this node up
         // node must not be a v2 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) == nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -729,13 +914,15 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
+    assert (!isEmptyBranch (branch));
 
-    std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    std::lock_guard <spinlock> lock (childLock_);
+    auto& child = children()[branchIndex (branch)];
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
@@ -743,7 +930,7 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
         // node must not be a v1 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) != nullptr ||
                std::dynamic_pointer_cast<SHAMapTreeNode>(node)    != nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -815,10 +1002,9 @@ SHAMapInnerNodeV2::setChildren(std::shared_ptr<SHAMapTreeNode> const& child1,
         b2 = *k2 >> 4;
         depth_ = 2*depth_;
     }
-    mChildren[b1] = child1;
-    mIsBranch |= 1 << b1;
-    mChildren[b2] = child2;
-    mIsBranch |= 1 << b2;
+    reserve (2);
+    addBranch (b1) = child1;
+    addBranch (b2) = child2;
 }
 
 void
@@ -856,11 +1042,11 @@ SHAMapInnerNode::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash(i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
-                mChildren[i]->invariants(is_v2);
+            if (children()[branchIndex(i)] != nullptr)
+                children()[branchIndex(i)]->invariants(is_v2);
             ++count;
         }
         else
@@ -884,21 +1070,21 @@ SHAMapInnerNodeV2::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash(i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
+            if (children()[branchIndex(i)] != nullptr)
             {
-                assert(mHashes[i] == mChildren[i]->getNodeHash());
+                assert(getChildHash(i) == children()[branchIndex(i)]->getNodeHash());
 #ifndef NDEBUG
-                auto const& childID = mChildren[i]->key();
+                auto const& childID = children()[branchIndex(i)]->key();
 
                 // Make sure this child it attached to the correct branch
                 SHAMapNodeID nodeID {depth(), common()};
                 assert (i == nodeID.selectBranch(childID));
 #endif
                 assert(has_common_prefix(childID));
-                mChildren[i]->invariants(is_v2);
+                children()[branchIndex(i)]->invariants(is_v2);
             }
             ++count;
         }
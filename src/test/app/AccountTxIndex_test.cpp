@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/beast/unit_test.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <tuple>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class AccountTxIndex_test : public beast::unit_test::suite
+{
+    using Visited = std::vector<std::tuple<
+        std::uint32_t, std::uint32_t, uint256>>;
+
+    static
+    uint256
+    txID (std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+    {
+        return uint256 ((std::uint64_t (ledgerSeq) << 32) | txnSeq);
+    }
+
+    static
+    Visited
+    walk (AccountTxIndex& index, AccountID const& account,
+        std::uint32_t minLedger, std::uint32_t maxLedger, bool forward,
+        boost::optional<AccountTxIndex::Cursor> const& start = boost::none,
+        std::size_t limit = 0)
+    {
+        Visited visited;
+        index.forEach (account, minLedger, maxLedger, start, forward,
+            [&] (std::uint32_t ledgerSeq, std::uint32_t txnSeq,
+                uint256 const& id)
+            {
+                visited.emplace_back (ledgerSeq, txnSeq, id);
+                return limit == 0 || visited.size () < limit;
+            });
+        return visited;
+    }
+
+    std::unique_ptr<AccountTxIndex>
+    makeIndex (SuiteJournal& journal)
+    {
+        Section section ("account_tx_index");
+        section.set ("type", "memory");
+        return make_AccountTxIndex (section, journal);
+    }
+
+    void
+    testOrder ()
+    {
+        testcase ("order");
+
+        SuiteJournal journal ("AccountTxIndex_test", *this);
+        auto index = makeIndex (journal);
+
+        AccountID const alice (1);
+        AccountID const bob (2);
+
+        // Ledgers are not necessarily saved in order
+        for (std::uint32_t seq : {5, 3, 4})
+        {
+            index->insert (seq, {
+                {bob, 1, txID (seq, 1)},
+                {alice, 2, txID (seq, 2)},
+                {alice, 0, txID (seq, 0)}});
+        }
+
+        auto visited = walk (*index, alice, 0, 10, true);
+        BEAST_EXPECT (visited == Visited ({
+            {3, 0, txID (3, 0)}, {3, 2, txID (3, 2)},
+            {4, 0, txID (4, 0)}, {4, 2, txID (4, 2)},
+            {5, 0, txID (5, 0)}, {5, 2, txID (5, 2)}}));
+
+        visited = walk (*index, alice, 4, 10, false);
+        BEAST_EXPECT (visited == Visited ({
+            {5, 2, txID (5, 2)}, {5, 0, txID (5, 0)},
+            {4, 2, txID (4, 2)}, {4, 0, txID (4, 0)}}));
+
+        visited = walk (*index, bob, 0, 4, true);
+        BEAST_EXPECT (visited == Visited ({
+            {3, 1, txID (3, 1)}, {4, 1, txID (4, 1)}}));
+
+        BEAST_EXPECT (walk (*index, AccountID (3), 0, 10, true).empty ());
+        BEAST_EXPECT (walk (*index, alice, 6, 10, false).empty ());
+
+        // Stopping the walk
+        BEAST_EXPECT (walk (*index, alice, 0, 10, true, boost::none, 1) ==
+            Visited ({{3, 0, txID (3, 0)}}));
+    }
+
+    void
+    testCursor ()
+    {
+        testcase ("cursor");
+
+        SuiteJournal journal ("AccountTxIndex_test", *this);
+        auto index = makeIndex (journal);
+
+        AccountID const alice (1);
+        for (std::uint32_t seq = 1; seq <= 3; ++seq)
+            index->insert (seq, {
+                {alice, 0, txID (seq, 0)},
+                {alice, 1, txID (seq, 1)}});
+
+        // The cursor is inclusive and only bounds the walk in its direction
+        auto visited = walk (*index, alice, 1, 3, true,
+            AccountTxIndex::Cursor (2, 1));
+        BEAST_EXPECT (visited == Visited ({
+            {2, 1, txID (2, 1)}, {3, 0, txID (3, 0)}, {3, 1, txID (3, 1)}}));
+
+        visited = walk (*index, alice, 1, 3, false,
+            AccountTxIndex::Cursor (2, 0));
+        BEAST_EXPECT (visited == Visited ({
+            {2, 0, txID (2, 0)}, {1, 1, txID (1, 1)}, {1, 0, txID (1, 0)}}));
+
+        // The ledger range still applies
+        visited = walk (*index, alice, 2, 3, false,
+            AccountTxIndex::Cursor (2, 1));
+        BEAST_EXPECT (visited == Visited ({
+            {2, 1, txID (2, 1)}, {2, 0, txID (2, 0)}}));
+    }
+
+    void
+    testRewrite ()
+    {
+        testcase ("rewrite and clear");
+
+        SuiteJournal journal ("AccountTxIndex_test", *this);
+        auto index = makeIndex (journal);
+
+        AccountID const alice (1);
+        AccountID const bob (2);
+        for (std::uint32_t seq = 1; seq <= 3; ++seq)
+            index->insert (seq, {{alice, 0, txID (seq, 0)}});
+
+        // Saving a ledger again replaces all of its entries
+        index->insert (2, {{bob, 4, txID (2, 4)}});
+        BEAST_EXPECT (walk (*index, alice, 0, 10, true) == Visited ({
+            {1, 0, txID (1, 0)}, {3, 0, txID (3, 0)}}));
+        BEAST_EXPECT (walk (*index, bob, 0, 10, true) == Visited ({
+            {2, 4, txID (2, 4)}}));
+
+        index->clearPrior (3);
+        BEAST_EXPECT (walk (*index, alice, 0, 10, true) == Visited ({
+            {3, 0, txID (3, 0)}}));
+        BEAST_EXPECT (walk (*index, bob, 0, 10, true).empty ());
+    }
+
+    void
+    testCoverage ()
+    {
+        testcase ("coverage");
+
+        SuiteJournal journal ("AccountTxIndex_test", *this);
+        auto index = makeIndex (journal);
+
+        BEAST_EXPECT (! index->coverage ());
+
+        // Only changed from the expected value
+        BEAST_EXPECT (! index->updateCoverage (10u, 5));
+        BEAST_EXPECT (index->updateCoverage (boost::none, 10));
+        BEAST_EXPECT (index->coverage () == 10u);
+        BEAST_EXPECT (! index->updateCoverage (boost::none, 5));
+        BEAST_EXPECT (index->updateCoverage (10u, 5));
+        BEAST_EXPECT (index->coverage () == 5u);
+
+        // Removing ledgers does not change it
+        index->clearPrior (8);
+        BEAST_EXPECT (index->coverage () == 5u);
+    }
+
+    void
+    testConfig ()
+    {
+        testcase ("config");
+
+        SuiteJournal journal ("AccountTxIndex_test", *this);
+
+        Section section ("account_tx_index");
+        section.set ("type", "unknown");
+        try
+        {
+            make_AccountTxIndex (section, journal);
+            fail ();
+        }
+        catch (std::exception const&)
+        {
+            pass ();
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testOrder ();
+        testCursor ();
+        testRewrite ();
+        testCoverage ();
+        testConfig ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxIndex,app,ripple);
+
+} // test
+} // ripple
@@ -17,10 +17,17 @@
 */
 //==============================================================================
 #include <test/jtx.h>
+#include <ripple/app/misc/AccountTxIndex.h>
+#include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/core/JobQueue.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/JsonFields.h>
+#include <algorithm>
 #include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -56,12 +63,18 @@ class AccountTxPaging_test : public beast::unit_test::suite
     }
 
     void
-    testAccountTxPaging ()
+    testAccountTxPaging (bool indexed)
     {
-        testcase("Paging for Single Account");
+        testcase(std::string ("Paging for Single Account") +
+            (indexed ? " with index" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env(*this, envconfig([indexed](std::unique_ptr<Config> cfg)
+            {
+                if (indexed)
+                    cfg->section("account_tx_index").set("type", "memory");
+                return cfg;
+            }));
         Account A1 {"A1"};
         Account A2 {"A2"};
         Account A3 {"A3"};
@@ -258,11 +271,114 @@ class AccountTxPaging_test : public beast::unit_test::suite
         }
     }
 
+    // Page through an account's whole history, returning the hashes.
+    std::vector<std::string>
+    history (
+        test::jtx::Env& env,
+        test::jtx::Account const& account,
+        bool forward)
+    {
+        std::vector<std::string> hashes;
+        Json::Value marker;
+        do
+        {
+            auto const jrr = next(env, account, -1, -1, 3, forward, marker);
+            auto const& txs = jrr[jss::transactions];
+            if (! BEAST_EXPECT(txs.isArray()))
+                break;
+            for (Json::UInt i = 0; i < txs.size(); ++i)
+                hashes.push_back(txs[i][jss::tx][jss::hash].asString());
+            marker = jrr[jss::marker];
+        }
+        while (marker);
+        return hashes;
+    }
+
+    static
+    std::size_t
+    indexed (AccountTxIndex& index, test::jtx::Account const& account)
+    {
+        std::size_t count = 0;
+        index.forEach (account.id(), 0,
+            std::numeric_limits<std::uint32_t>::max(), boost::none, true,
+            [&count] (std::uint32_t, std::uint32_t, uint256 const&)
+            {
+                ++count;
+                return true;
+            });
+        return count;
+    }
+
+    void
+    testIndexCoverage ()
+    {
+        testcase("Index coverage");
+        using namespace test::jtx;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg)
+            {
+                cfg->section("account_tx_index").set("type", "memory");
+                return cfg;
+            }));
+        Account A1 {"A1"};
+        Account A2 {"A2"};
+
+        env.fund(XRP(10000), A1, A2);
+        env.close();
+
+        for (auto i = 0; i < 6; ++i)
+        {
+            env(pay(A1, A2, XRP(1)));
+            env(pay(A2, A1, XRP(1)));
+            env.close();
+        }
+        env.app().getJobQueue().rendezvous();
+
+        auto const index = env.app().getAccountTxIndex();
+        if (! BEAST_EXPECT(index))
+            return;
+
+        // The database was empty when the index was enabled
+        BEAST_EXPECT(index->coverage() == std::uint32_t(0));
+
+        auto const forward = history(env, A1, true);
+        auto const backward = history(env, A1, false);
+        BEAST_EXPECT(forward.size() >= 12);
+        BEAST_EXPECT(indexed(*index, A1) == forward.size());
+        BEAST_EXPECT(std::equal(forward.begin(), forward.end(),
+            backward.rbegin(), backward.rend()));
+
+        // As if the index had been enabled a few ledgers ago
+        auto const enabled = env.closed()->info().seq - 2;
+        index->clearPrior(enabled);
+        BEAST_EXPECT(index->updateCoverage(index->coverage(), enabled));
+        BEAST_EXPECT(indexed(*index, A1) < forward.size());
+
+        // Ranges starting before the coverage are read from the database
+        BEAST_EXPECT(history(env, A1, true) == forward);
+        BEAST_EXPECT(history(env, A1, false) == backward);
+
+        // Backfill a couple of ledgers at a time
+        for (int i = 0; i < 100 &&
+            backfillAccountTxIndex(env.app().getTxnDB(), *index, 2); ++i)
+        {
+            auto const covered = index->coverage();
+            BEAST_EXPECT(covered && *covered < enabled);
+        }
+        BEAST_EXPECT(index->coverage() == std::uint32_t(0));
+        BEAST_EXPECT(indexed(*index, A1) == forward.size());
+
+        BEAST_EXPECT(history(env, A1, true) == forward);
+        BEAST_EXPECT(history(env, A1, false) == backward);
+    }
+
 public:
     void
     run() override
     {
-        testAccountTxPaging();
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
+        testIndexCoverage();
     }
 };
 
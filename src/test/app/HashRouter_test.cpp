@@ -20,6 +20,12 @@
 #include <ripple/app/misc/HashRouter.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/rngfill.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -280,6 +286,59 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(router.shouldProcess(key, peer, flags, 1s));
     }
 
+    void
+    testManyEntries()
+    {
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2);
+
+        // Enough keys to grow every partition several times
+        std::size_t const count = 20000;
+        std::vector<uint256> keys;
+        keys.reserve(count);
+        beast::xor_shift_engine g(1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::uint8_t buf[32];
+            beast::rngfill(buf, sizeof(buf), g);
+            keys.push_back(uint256::fromVoid(buf));
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            BEAST_EXPECT(router.addSuppressionPeer(keys[i], i % 50 + 1));
+
+        ++stopwatch;
+        // t=1
+        bool found = true;
+        for (std::size_t i = 0; i < count; i += 2)
+        {
+            found = found && !router.addSuppressionPeer(
+                keys[i], i % 50 + 2);
+        }
+        BEAST_EXPECT(found);
+
+        ++stopwatch;
+        // t=2, the odd keys were last touched at t=0 and expire
+        // with this insertion. The even keys survive.
+        router.addSuppression(uint256(1));
+        bool expired = true;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bool const created = router.addSuppressionPeer(keys[i], 3);
+            if (i % 2 == 0)
+                found = found && !created;
+            else
+                expired = expired && created;
+        }
+        BEAST_EXPECT(found);
+        BEAST_EXPECT(expired);
+
+        // Every surviving key kept the peers it was received from
+        auto const peers = router.shouldRelay(keys[0]);
+        BEAST_EXPECT(peers && peers->size() == 3 &&
+            peers->count(1) && peers->count(2) && peers->count(3));
+    }
 
 public:
 
@@ -293,10 +352,119 @@ public:
         testRelay();
         testRecover();
         testProcess();
+        testManyEntries();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(HashRouter, app, ripple);
 
+// Replays a relay workload: every hash is received from several peers,
+// each peer is served by its own thread, and the first peer to deliver
+// a hash also marks it and relays it.
+class HashRouterTiming_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr numKeys = 200000;
+    static std::size_t constexpr numPeers = 64;
+    static std::size_t constexpr copiesPerKey = 16;
+
+    std::vector<uint256> keys_;
+
+    std::chrono::milliseconds
+    replay(std::size_t threads)
+    {
+        using namespace std::chrono;
+
+        HashRouter router(stopwatch(), HashRouter::getDefaultHoldTime(),
+            HashRouter::getDefaultRecoverLimit());
+        std::atomic<std::size_t> relayed{0};
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+
+        auto const start = steady_clock::now();
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(
+                [this, &router, &relayed, threads, t]
+                {
+                    beast::xor_shift_engine g(t + 1);
+                    std::uniform_int_distribution<std::size_t>
+                        jitter(0, 63);
+                    std::size_t count = 0;
+
+                    for (auto peer = t; peer < numPeers; peer += threads)
+                    {
+                        auto const id =
+                            static_cast<HashRouter::PeerShortID>(peer + 1);
+
+                        // A peer relays a hash only if it falls in its
+                        // share, in roughly the order it was created.
+                        for (std::size_t i = 0; i < keys_.size(); ++i)
+                        {
+                            if ((i + peer) % (numPeers / copiesPerKey) != 0)
+                                continue;
+
+                            auto const& key = keys_[std::min(
+                                keys_.size() - 1, i + jitter(g))];
+                            int flags;
+                            if (router.shouldProcess(
+                                    key, id, flags, std::chrono::seconds(10)))
+                            {
+                                router.setFlags(key, SF_TRUSTED);
+                                if (router.shouldRelay(key))
+                                    ++count;
+                            }
+                        }
+                    }
+                    relayed += count;
+                });
+        }
+        for (auto& w : workers)
+            w.join();
+        auto const elapsed =
+            duration_cast<milliseconds>(steady_clock::now() - start);
+
+        BEAST_EXPECT(relayed <= keys_.size());
+        return elapsed;
+    }
+
+public:
+    HashRouterTiming_test()
+    {
+        beast::xor_shift_engine g(19207813);
+        keys_.reserve(numKeys);
+        std::uint8_t buf[32];
+
+        for (std::size_t i = 0; i < numKeys; ++i)
+        {
+            beast::rngfill(buf, sizeof(buf), g);
+            keys_.push_back(uint256::fromVoid(buf));
+        }
+    }
+
+    void
+    run() override
+    {
+        testcase("relay workload");
+
+        auto const maxThreads =
+            std::max(1u, std::thread::hardware_concurrency());
+        auto const ops = numKeys * copiesPerKey;
+
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            auto const elapsed = replay(threads);
+            log << "    " << threads << " threads: " << elapsed.count()
+                << " ms, "
+                << (ops * 1000) / std::max<std::int64_t>(1, elapsed.count())
+                << " messages/s" << std::endl;
+        }
+
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(HashRouterTiming, app, ripple);
+
 }
 }
@@ -21,13 +21,14 @@
 #include <ripple/app/ledger/BuildLedger.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerReplay.h>
+#include <iterator>
 
 namespace ripple {
 namespace test {
 
 struct LedgerReplay_test : public beast::unit_test::suite
 {
-    void run() override
+    void testReplay()
     {
         testcase("Replay ledger");
 
@@ -54,6 +55,74 @@ struct LedgerReplay_test : public beast::unit_test::suite
 
         BEAST_EXPECT(replayed->info().hash == lastClosed->info().hash);
     }
+
+    void testReplayMany()
+    {
+        // Consensus ledgers with enough transactions to check them
+        // in parallel must match a one at a time replay exactly.
+        testcase("Replay ledgers with many transactions");
+
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 24; ++i)
+            accounts.emplace_back("account" + std::to_string(i));
+
+        env.fund(XRP(1000000), gw);
+        for (auto const& a : accounts)
+            env.fund(XRP(100000), a);
+        env.close();
+
+        for (auto const& a : accounts)
+            env(trust(a, USD(100000)));
+        env.close();
+
+        for (auto const& a : accounts)
+            env(pay(gw, a, USD(1000)));
+        env.close();
+
+        LedgerMaster& ledgerMaster = env.app().getLedgerMaster();
+        for (int round = 0; round < 3; ++round)
+        {
+            auto const n = accounts.size();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto const& a = accounts[i];
+                auto const& b = accounts[(i + round + 1) % n];
+                env(pay(a, b, XRP(10 + i)));
+                env(pay(a, b, USD(5)));
+                env(offer(a, XRP(100), USD(10 + round)));
+                env(offer(b, USD(10), XRP(90 + i)));
+                // Fails with a claimed fee
+                env(pay(a, b, USD(100000)), ter(tecPATH_PARTIAL));
+            }
+            env.close();
+
+            auto const lastClosed = ledgerMaster.getClosedLedger();
+            auto const lastClosedParent =
+                ledgerMaster.getLedgerByHash(lastClosed->info().parentHash);
+
+            auto const replayed = buildLedger(
+                LedgerReplay(lastClosedParent, lastClosed),
+                tapNONE,
+                env.app(),
+                env.journal);
+
+            BEAST_EXPECT(std::distance(lastClosed->txs.begin(),
+                lastClosed->txs.end()) == n * 5);
+            BEAST_EXPECT(replayed->info().hash == lastClosed->info().hash);
+        }
+    }
+
+    void run() override
+    {
+        testReplay();
+        testReplayMany();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(LedgerReplay,app,ripple);
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/core/DatabaseCon.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class LedgerSave_test : public beast::unit_test::suite
+{
+    void testAccountTransactions()
+    {
+        testcase ("account transactions");
+        using namespace jtx;
+
+        Env env {*this};
+        Account const alice {"alice"};
+        Account const bob {"bob"};
+        Account const carol {"carol"};
+        env.fund (XRP(10000), alice, bob, carol);
+        env.close ();
+
+        env (pay (alice, bob, XRP(100)));
+        auto const aliceTx = to_string (env.tx ()->getTransactionID ());
+        env (pay (bob, carol, XRP(50)));
+        auto const bobTx = to_string (env.tx ()->getTransactionID ());
+        env.close ();
+
+        // Wait for the save to finish
+        env.app ().getJobQueue ().rendezvous ();
+
+        auto const seq =
+            env.app ().getLedgerMaster ().getClosedLedger ()->info ().seq;
+        auto db = env.app ().getTxnDB ().checkoutDb ();
+
+        // Each payment affects its source and destination
+        int rows = 0;
+        *db << "SELECT count(*) FROM AccountTransactions "
+            "WHERE LedgerSeq = :seq;",
+            soci::use (seq), soci::into (rows);
+        BEAST_EXPECT (rows == 4);
+
+        auto const txnsFor = [&] (Account const& account)
+        {
+            std::vector<std::string> txns (4);
+            *db << "SELECT TransID FROM AccountTransactions "
+                "WHERE LedgerSeq = :seq AND Account = :account "
+                "ORDER BY TxnSeq;",
+                soci::use (seq), soci::use (account.human ()),
+                soci::into (txns);
+            return txns;
+        };
+
+        BEAST_EXPECT (txnsFor (alice) == std::vector<std::string> ({aliceTx}));
+        BEAST_EXPECT (txnsFor (carol) == std::vector<std::string> ({bobTx}));
+        auto const bobTxns = txnsFor (bob);
+        BEAST_EXPECT (bobTxns.size () == 2);
+    }
+
+    void testManyRows()
+    {
+        testcase ("many rows");
+        using namespace jtx;
+
+        Env env {*this};
+        std::vector<Account> accounts;
+        for (int i = 0; i < 10; ++i)
+        {
+            accounts.emplace_back ("a" + std::to_string (i));
+            env.fund (XRP(10000), accounts.back ());
+        }
+        env.close ();
+
+        // Rows are written by INSERTs of several sizes, and the statements
+        // are kept between saves.  Save ledgers whose row counts need a mix
+        // of those sizes.
+        for (int const payments : {43, 1, 10})
+        {
+            for (int i = 0; i < payments; ++i)
+            {
+                env (pay (accounts[i % accounts.size ()],
+                    accounts[(i + 1) % accounts.size ()], XRP(1)));
+            }
+            env.close ();
+            env.app ().getJobQueue ().rendezvous ();
+
+            auto const seq =
+                env.app ().getLedgerMaster ().getClosedLedger ()->info ().seq;
+            auto db = env.app ().getTxnDB ().checkoutDb ();
+
+            int rows = 0;
+            *db << "SELECT count(*) FROM AccountTransactions "
+                "WHERE LedgerSeq = :seq;",
+                soci::use (seq), soci::into (rows);
+            BEAST_EXPECT (rows == 2 * payments);
+
+            int txns = 0;
+            *db << "SELECT count(DISTINCT TransID) FROM AccountTransactions "
+                "WHERE LedgerSeq = :seq;",
+                soci::use (seq), soci::into (txns);
+            BEAST_EXPECT (txns == payments);
+
+            int seqs = 0;
+            *db << "SELECT count(DISTINCT TxnSeq) FROM AccountTransactions "
+                "WHERE LedgerSeq = :seq;",
+                soci::use (seq), soci::into (seqs);
+            BEAST_EXPECT (seqs == payments);
+        }
+    }
+
+public:
+    void run () override
+    {
+        testAccountTransactions ();
+        testManyRows ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerSave,app,ripple);
+
+//------------------------------------------------------------------------------
+
+class LedgerSaveTiming_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr numAccounts = 100;
+    static std::size_t constexpr numLedgers = 100;
+    static std::size_t constexpr txnsPerLedger = 100;
+
+public:
+    void run () override
+    {
+        testcase ("save ledgers");
+        using namespace jtx;
+        using namespace std::chrono;
+
+        Env env {*this};
+
+        std::vector<Account> accounts;
+        accounts.reserve (numAccounts);
+        for (std::size_t i = 0; i < numAccounts; ++i)
+        {
+            accounts.emplace_back ("a" + std::to_string (i));
+            env.fund (XRP(100000), accounts.back ());
+        }
+        env.close ();
+        env.app ().getJobQueue ().rendezvous ();
+
+        auto const start = steady_clock::now ();
+        for (std::size_t l = 0; l < numLedgers; ++l)
+        {
+            for (std::size_t t = 0; t < txnsPerLedger; ++t)
+            {
+                auto const offset = 1 + l % (numAccounts - 1);
+                env (pay (accounts[t % numAccounts],
+                    accounts[(t + offset) % numAccounts], XRP(1)));
+            }
+            env.close ();
+        }
+        env.app ().getJobQueue ().rendezvous ();
+        auto const elapsed = duration_cast <milliseconds> (
+            steady_clock::now () - start);
+
+        log << "    " << numLedgers << " ledgers of " << txnsPerLedger <<
+            " transactions: " << elapsed.count () << " ms, " <<
+            (numLedgers * 1000) / std::max <std::int64_t> (1, elapsed.count ()) <<
+            " ledgers/s" << std::endl;
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerSaveTiming,app,ripple);
+
+} // test
+} // ripple
@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/core/Stoppable.h>
+#include <test/jtx.h>
+#include <future>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    void
+    testIncremental()
+    {
+        testcase("incremental");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const bob = Account("bob");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice, bob);
+        env.trust(USD(1000), alice, bob);
+        env(pay(gw, alice, USD(100)));
+        env(pay(gw, bob, USD(100)));
+        env.close();
+
+        // A private instance, so that ledgers published in the
+        // background don't interfere.
+        RootStoppable root ("OrderBookDB_test");
+        OrderBookDB db (env.app(), root);
+
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+
+        // Two qualities in the same book
+        env(offer(alice, XRP(100), USD(10)));
+        auto const second = env.seq(alice);
+        env(offer(alice, XRP(200), USD(10)));
+        env.close();
+
+        db.setup(env.closed());
+        auto const books = db.getBooksByTakerPays(xrpIssue());
+        if (BEAST_EXPECT(books.size() == 1))
+            BEAST_EXPECT(books[0]->book() == Book(xrpIssue(), USD.issue()));
+        BEAST_EXPECT(! db.isBookToXRP(USD.issue()));
+
+        // Consuming one quality leaves the book in place
+        env(offer(bob, USD(10), XRP(100)));
+        env.close();
+
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // Removing the last offer removes the book
+        env(offer_cancel(alice, second));
+        env.close();
+
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+
+        // A book to XRP
+        auto const toXRP = env.seq(alice);
+        env(offer(alice, USD(10), XRP(100)));
+        env.close();
+
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+
+        env(offer_cancel(alice, toXRP));
+        env.close();
+
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+        BEAST_EXPECT(! db.isBookToXRP(USD.issue()));
+    }
+
+    void
+    testFullUpdate()
+    {
+        testcase("full update");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.trust(USD(1000), alice);
+        env.trust(EUR(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(100), USD(10)));
+        env(offer(alice, XRP(200), USD(10)));
+        env(offer(alice, EUR(10), USD(10)));
+        env.close();
+
+        RootStoppable root ("OrderBookDB_test");
+        OrderBookDB db (env.app(), root);
+
+        // The first ledger is scanned in full
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.getBookSize(EUR.issue()) == 1);
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 0);
+
+        // Books added while applying transactions are kept
+        db.addOrderBook(Book(USD.issue(), xrpIssue()));
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 1);
+        db.addOrderBook(Book(USD.issue(), xrpIssue()));
+        BEAST_EXPECT(db.getBookSize(USD.issue()) == 1);
+    }
+
+    // A view of a ledger whose scan waits until it is released
+    class PausedView : public ReadView
+    {
+        std::shared_ptr<ReadView const> view_;
+        std::promise<void> mutable entered_;
+        std::shared_future<void> release_;
+
+    public:
+        PausedView (std::shared_ptr<ReadView const> view,
+                std::shared_future<void> release)
+            : view_ (std::move (view))
+            , release_ (std::move (release))
+        {
+        }
+
+        std::future<void>
+        entered()
+        {
+            return entered_.get_future();
+        }
+
+        LedgerInfo const& info() const override
+        {
+            return view_->info();
+        }
+
+        bool open() const override
+        {
+            return view_->open();
+        }
+
+        Fees const& fees() const override
+        {
+            return view_->fees();
+        }
+
+        Rules const& rules() const override
+        {
+            return view_->rules();
+        }
+
+        bool exists (Keylet const& k) const override
+        {
+            return view_->exists(k);
+        }
+
+        boost::optional<key_type>
+        succ (key_type const& key,
+            boost::optional<key_type> const& last) const override
+        {
+            return view_->succ(key, last);
+        }
+
+        std::shared_ptr<SLE const> read (Keylet const& k) const override
+        {
+            return view_->read(k);
+        }
+
+        std::unique_ptr<sles_type::iter_base> slesBegin() const override
+        {
+            entered_.set_value();
+            release_.wait();
+            return view_->slesBegin();
+        }
+
+        std::unique_ptr<sles_type::iter_base> slesEnd() const override
+        {
+            return view_->slesEnd();
+        }
+
+        std::unique_ptr<sles_type::iter_base>
+        slesUpperBound (key_type const& key) const override
+        {
+            return view_->slesUpperBound(key);
+        }
+
+        std::unique_ptr<txs_type::iter_base> txsBegin() const override
+        {
+            return view_->txsBegin();
+        }
+
+        std::unique_ptr<txs_type::iter_base> txsEnd() const override
+        {
+            return view_->txsEnd();
+        }
+
+        bool txExists (key_type const& key) const override
+        {
+            return view_->txExists(key);
+        }
+
+        tx_type txRead (key_type const& key) const override
+        {
+            return view_->txRead(key);
+        }
+    };
+
+    void
+    testOverlappingUpdates()
+    {
+        testcase("overlapping full updates");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env.close();
+        auto const before = env.closed();
+
+        env(offer(alice, XRP(100), USD(10)));
+        env.close();
+
+        RootStoppable root ("OrderBookDB_test");
+        OrderBookDB db (env.app(), root);
+
+        // Start a full update of the ledger without the book, and
+        // hold it until a second full update has been requested.
+        std::promise<void> release;
+        auto const paused = std::make_shared<PausedView> (
+            before, release.get_future().share());
+        auto entered = paused->entered();
+        std::thread first ([&db, paused] { db.setup(paused); });
+        entered.wait();
+
+        db.invalidate();
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+
+        // The second update runs after the first, so its books win
+        release.set_value();
+        first.join();
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // And the ledger stream is followed from it
+        env(offer(alice, XRP(200), USD(10)));
+        env(offer(alice, USD(10), XRP(50)));
+        env.close();
+        db.setup(env.closed());
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+    }
+
+    void
+    testPeriodicUpdate()
+    {
+        testcase("periodic full update");
+        using namespace jtx;
+
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const alice = Account("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund(XRP(10000), gw, alice);
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(100), USD(10)));
+        env.close();
+
+        RootStoppable root ("OrderBookDB_test");
+        OrderBookDB db (env.app(), root);
+        db.setup(env.closed());
+
+        // A book added for an offer which never makes it into a ledger
+        db.addOrderBook(Book(EUR.issue(), xrpIssue()));
+        BEAST_EXPECT(db.isBookToXRP(EUR.issue()));
+
+        // Is dropped by the next full scan
+        for (std::uint32_t i = 1; i < OrderBookDB::fullUpdateInterval; ++i)
+        {
+            env.close();
+            db.setup(env.closed());
+        }
+        BEAST_EXPECT(db.isBookToXRP(EUR.issue()));
+
+        env.close();
+        db.setup(env.closed());
+        BEAST_EXPECT(! db.isBookToXRP(EUR.issue()));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testFullUpdate();
+        testOverlappingUpdates();
+        testPeriodicUpdate();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB,app,ripple);
+
+} // test
+} // ripple
@@ -17,7 +17,11 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/paths/AccountCurrencies.h>
+#include <ripple/app/paths/PathRequests.h>
+#include <ripple/app/paths/Pathfinder.h>
+#include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/basics/contract.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/json_reader.h>
@@ -30,9 +34,12 @@
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/RPCHandler.h>
 #include <test/jtx.h>
+#include <ripple/beast/insight/Collector.h>
 #include <ripple/beast/unit_test.h>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -457,6 +464,232 @@ public:
         BEAST_EXPECT(equal(sa, Account("alice")["USD"](5)));
     }
 
+    void
+    path_find_continue_callback()
+    {
+        testcase("path find continue callback");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(600), "alice");
+        env.trust(USD(700), "bob");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw, "bob", USD(50)));
+        env.close();
+
+        auto const bestPaths = [&](std::function<bool(void)> const& cb)
+        {
+            auto const cache = std::make_shared<RippleLineCache>(
+                env.closed());
+            Pathfinder pf (cache, Account("alice"), Account("bob"),
+                USD.currency, boost::none, Account("bob")["USD"](5),
+                    boost::none, env.app());
+            STPath fullLiquidityPath;
+            if (! BEAST_EXPECT(pf.findPaths(
+                    env.app().config().PATH_SEARCH, cb)))
+                return STPathSet{};
+            pf.computePathRanks(4, cb);
+            return pf.getBestPaths(4, fullLiquidityPath, {},
+                Account("alice").id());
+        };
+
+        // Searching to completion finds the path through the gateway
+        BEAST_EXPECT(same(bestPaths({}), stpath("gateway")));
+        BEAST_EXPECT(same(bestPaths([]{ return true; }), stpath("gateway")));
+
+        // Stopping right away finds nothing, but is not an error
+        BEAST_EXPECT(bestPaths([]{ return false; }).empty());
+    }
+
+    void
+    line_cache_inherit()
+    {
+        testcase("line cache inherit");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", "carol", gw);
+        env.trust(USD(600), "alice", "bob");
+        env.trust(Account("carol")["EUR"](100), "bob");
+        env(pay(gw, "alice", USD(70)));
+        env.close();
+
+        std::vector<Account> const accounts {
+            "alice", "bob", "carol", gw};
+        auto parent = std::make_shared<RippleLineCache>(env.closed());
+        for (auto const& a : accounts)
+            parent->getRippleLines(a);
+        auto const bobLines = &parent->getRippleLines(Account("bob"));
+
+        // Only the lines of alice and the gateway change
+        env(pay("alice", "carol", XRP(10)));
+        env(pay(gw, "alice", USD(5)));
+        env.close();
+
+        RippleLineCache cache (env.closed(), *parent);
+        RippleLineCache fresh (env.closed());
+        BEAST_EXPECT(cache.inherited() == 2);
+        BEAST_EXPECT(&cache.getRippleLines(Account("bob")) == bobLines);
+
+        for (auto const& a : accounts)
+        {
+            auto const& lines = cache.getRippleLines(a);
+            auto const& expected = fresh.getRippleLines(a);
+            if (! BEAST_EXPECT(lines.size() == expected.size()))
+                continue;
+            for (std::size_t i = 0; i < lines.size(); ++i)
+            {
+                BEAST_EXPECT(lines[i]->key() == expected[i]->key());
+                BEAST_EXPECT(lines[i]->getBalance() ==
+                    expected[i]->getBalance());
+            }
+        }
+        BEAST_EXPECT(cache.getRippleLines(Account("alice"))[0]->
+            getBalance() == Account("alice")["USD"](75));
+
+        // Paths out of the gateway: one line each to alice and bob, but
+        // only alice holds USD that can move back out to the gateway.
+        auto const out = cache.getPathsOut(gw, USD.currency);
+        BEAST_EXPECT(out.any == 2);
+        BEAST_EXPECT(out.authorized == 0);
+        BEAST_EXPECT(cache.getPathsOut(
+            Account("alice"), USD.currency).any == 1);
+        BEAST_EXPECT(cache.getPathsOut(
+            Account("carol"), USD.currency).any == 0);
+
+        // Every account was looked up in cache, so a ledger that
+        // changes no lines carries all of them over.
+        env.close();
+        RippleLineCache child (env.closed(), cache);
+        BEAST_EXPECT(child.inherited() == accounts.size());
+
+        // Only bob is looked up in child, so only bob is carried on.
+        BEAST_EXPECT(&child.getRippleLines(Account("bob")) == bobLines);
+        env.close();
+        RippleLineCache grandchild (env.closed(), child);
+        BEAST_EXPECT(grandchild.inherited() == 1);
+        BEAST_EXPECT(&grandchild.getRippleLines(Account("bob")) == bobLines);
+    }
+
+    // Records the values set on gauges; other metrics are null.
+    class GaugeCollector : public beast::insight::Collector
+    {
+    public:
+        struct RecordingGauge : beast::insight::GaugeImpl
+        {
+            std::atomic<value_type> value {0};
+            std::atomic<int> sets {0};
+
+            void
+            set (value_type v) override
+            {
+                value = v;
+                ++sets;
+            }
+
+            void
+            increment (difference_type amount) override
+            {
+                value += amount;
+            }
+        };
+
+        std::map<std::string, std::shared_ptr<RecordingGauge>> gauges;
+
+        beast::insight::Hook
+        make_hook (beast::insight::HookImpl::HandlerType const&) override
+        {
+            return {};
+        }
+
+        beast::insight::Counter
+        make_counter (std::string const&) override
+        {
+            return {};
+        }
+
+        beast::insight::Event
+        make_event (std::string const&) override
+        {
+            return {};
+        }
+
+        beast::insight::Gauge
+        make_gauge (std::string const& name) override
+        {
+            auto const gauge = std::make_shared<RecordingGauge>();
+            gauges[name] = gauge;
+            return beast::insight::Gauge (gauge);
+        }
+
+        beast::insight::Meter
+        make_meter (std::string const&) override
+        {
+            return {};
+        }
+    };
+
+    void
+    path_find_update_all()
+    {
+        testcase("path find update all");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", gw);
+        env.trust(USD(600), "alice");
+        env.trust(USD(700), "bob");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw, "bob", USD(50)));
+        env.close();
+
+        // Path find in a ledger that validation has since moved past
+        auto const ledger = env.closed();
+        env.close();
+        env.close();
+        auto const valid =
+            env.app().getLedgerMaster().getValidLedgerIndex();
+        auto const lag = valid > ledger->info().seq ?
+            valid - ledger->info().seq : 0;
+
+        auto const collector = std::make_shared<GaugeCollector>();
+        PathRequests pathRequests (env.app(),
+            env.app().journal("PathRequest"), collector);
+        auto const gauge = collector->gauges["pathfind_update_lag"];
+        if (! BEAST_EXPECT(gauge))
+            return;
+
+        // Enough requests for several threads to share the pass
+        std::size_t const count = 8 * std::max (1u,
+            std::thread::hardware_concurrency());
+        std::atomic<std::size_t> completed {0};
+        Resource::Consumer consumer;
+        std::vector<PathRequest::pointer> requests (count);
+        for (auto& request : requests)
+        {
+            Json::Value params = Json::objectValue;
+            params[jss::command] = "ripple_path_find";
+            params[jss::source_account] = Account("alice").human();
+            params[jss::destination_account] = Account("bob").human();
+            params[jss::destination_amount] =
+                Account("bob")["USD"](5).value().getJson(0);
+            pathRequests.makeLegacyPathRequest (request,
+                [&completed]{ ++completed; }, consumer, ledger, params);
+            BEAST_EXPECT(request);
+        }
+
+        pathRequests.updateAll (ledger, []{ return false; });
+
+        BEAST_EXPECT(completed == count);
+        BEAST_EXPECT(gauge->sets > 0);
+        BEAST_EXPECT(gauge->value == lag);
+        BEAST_EXPECT(lag >= 2);
+    }
+
     void
     xrp_to_xrp()
     {
@@ -1360,6 +1593,9 @@ public:
         direct_path_no_intermediary();
         payment_auto_path_find();
         path_find();
+        path_find_continue_callback();
+        path_find_update_all();
+        line_cache_inherit();
         path_find_consume_all();
         alternative_path_consume_both();
         alternative_paths_consume_best_transfer();
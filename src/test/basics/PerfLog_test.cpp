@@ -1044,6 +1044,30 @@ public:
         }
     }
 
+    void testOpenLedger (WithFile withFile)
+    {
+        using namespace std::chrono;
+
+        PerfLogParent parent {j_};
+        auto perfLog {getPerfLog (parent, withFile)};
+        parent.doStart();
+
+        // Nothing is reported until the open ledger has been rebuilt.
+        BEAST_EXPECT(
+            perfLog->countersJson()[jss::open_ledger].size() == 0);
+
+        perfLog->openLedgerAccept (microseconds (300), microseconds (20));
+        perfLog->openLedgerAccept (microseconds (500), microseconds (40));
+
+        Json::Value const openLedger {
+            perfLog->countersJson()[jss::open_ledger]};
+        BEAST_EXPECT(openLedger[jss::accepted] == "2");
+        BEAST_EXPECT(openLedger[jss::duration_us] == "800");
+        BEAST_EXPECT(openLedger[jss::locked_duration_us] == "60");
+
+        parent.doStop();
+    }
+
     void testRotate (WithFile withFile)
     {
         // We can't fully test rotate because unit tests must run on Windows,
@@ -1111,6 +1135,7 @@ public:
         testJobs (WithFile::yes);
         testInvalidID (WithFile::no);
         testInvalidID (WithFile::yes);
+        testOpenLedger (WithFile::no);
         testRotate (WithFile::no);
         testRotate (WithFile::yes);
     }
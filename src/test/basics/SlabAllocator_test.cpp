@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SlabAllocator.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+
+class SlabAllocator_test : public beast::unit_test::suite
+{
+    void testBlocks ()
+    {
+        testcase ("blocks");
+
+        SlabAllocator slab (40, 1024);
+        auto const perSlab = slab.blocksPerSlab ();
+        auto const n = 2 * perSlab + perSlab / 2;
+
+        // Sizes are rounded up to keep blocks aligned
+        BEAST_EXPECT(slab.blockSize () >= 40);
+        BEAST_EXPECT(slab.blockSize () % alignof (std::max_align_t) == 0);
+        BEAST_EXPECT(perSlab != 0 && perSlab * slab.blockSize () < 1024);
+        BEAST_EXPECT(slab.reserved () == 0);
+
+        // Blocks are distinct, aligned and usable, across several slabs
+        std::vector<void*> blocks;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const p = slab.allocate ();
+            BEAST_EXPECT(reinterpret_cast<std::uintptr_t> (p) %
+                alignof (std::max_align_t) == 0);
+            std::memset (p, static_cast<int> (i), 40);
+            blocks.push_back (p);
+        }
+        BEAST_EXPECT(slab.used () == n);
+        BEAST_EXPECT(slab.reserved () == 3 * 1024);
+        BEAST_EXPECT(std::set<void*> (blocks.begin (), blocks.end ()).size () ==
+            blocks.size ());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const p = static_cast<unsigned char*> (blocks[i]);
+            BEAST_EXPECT(std::all_of (p, p + 40,
+                [i](unsigned char c)
+                {
+                    return c == static_cast<unsigned char> (i);
+                }));
+        }
+
+        // Freed blocks are reused before the allocator grows
+        for (std::size_t i = 0; i < 10; ++i)
+            slab.deallocate (blocks[i]);
+        BEAST_EXPECT(slab.used () == n - 10);
+
+        std::set<void*> const freed (blocks.begin (), blocks.begin () + 10);
+        for (std::size_t i = 0; i < 10; ++i)
+            BEAST_EXPECT(freed.count (slab.allocate ()) == 1);
+        BEAST_EXPECT(slab.used () == n);
+        BEAST_EXPECT(slab.reserved () == 3 * 1024);
+
+        for (auto p : blocks)
+            slab.deallocate (p);
+        BEAST_EXPECT(slab.used () == 0);
+    }
+
+    void testRelease ()
+    {
+        testcase ("release");
+
+        SlabAllocator slab (40, 1024);
+        auto const perSlab = slab.blocksPerSlab ();
+
+        std::vector<void*> blocks;
+        for (std::size_t i = 0; i < 4 * perSlab; ++i)
+            blocks.push_back (slab.allocate ());
+        BEAST_EXPECT(slab.reserved () == 4 * 1024);
+
+        // Emptied slabs are released, except for one spare
+        for (auto p : blocks)
+            slab.deallocate (p);
+        BEAST_EXPECT(slab.used () == 0);
+        BEAST_EXPECT(slab.reserved () == 1024);
+
+        // The spare is reused
+        auto const p = slab.allocate ();
+        BEAST_EXPECT(slab.reserved () == 1024);
+        slab.deallocate (p);
+    }
+
+    void testThreads ()
+    {
+        testcase ("threads");
+
+        SlabAllocator slab (40, 4096);
+        std::size_t constexpr perThread = 1000;
+
+        // Each thread frees half of its blocks and hands the rest
+        // to be freed by another thread.
+        std::vector<std::vector<void*>> handed (4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < handed.size (); ++t)
+        {
+            threads.emplace_back ([&slab, &handed, t]
+            {
+                std::vector<void*> mine;
+                for (std::size_t i = 0; i < perThread; ++i)
+                {
+                    auto const p = slab.allocate ();
+                    std::memset (p, static_cast<int> (t), 40);
+                    mine.push_back (p);
+                }
+                for (std::size_t i = 0; i < perThread; i += 2)
+                    slab.deallocate (mine[i]);
+                for (std::size_t i = 1; i < perThread; i += 2)
+                    handed[t].push_back (mine[i]);
+            });
+        }
+        for (auto& t : threads)
+            t.join ();
+        BEAST_EXPECT(slab.used () == handed.size () * perThread / 2);
+
+        threads.clear ();
+        for (std::size_t t = 0; t < handed.size (); ++t)
+        {
+            threads.emplace_back ([&slab, &handed, t]
+            {
+                for (auto p : handed[(t + 1) % handed.size ()])
+                    slab.deallocate (p);
+            });
+        }
+        for (auto& t : threads)
+            t.join ();
+        BEAST_EXPECT(slab.used () == 0);
+        BEAST_EXPECT(slab.reserved () <= 4 * 4096);
+    }
+
+public:
+    void run () override
+    {
+        testBlocks ();
+        testRelease ();
+        testThreads ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SlabAllocator,basics,ripple);
+
+} // ripple
@@ -17,11 +17,21 @@
 */
 //==============================================================================
 
+#include <ripple/basics/base_uint.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/basics/PartitionedTaggedCache.h>
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/clock/manual_clock.h>
+#include <ripple/beast/utility/rngfill.h>
+#include <ripple/beast/xor_shift_engine.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 
@@ -38,7 +48,8 @@ original object.
 class TaggedCache_test : public beast::unit_test::suite
 {
 public:
-    void run () override
+    template <class Cache>
+    void testCache ()
     {
         using namespace std::chrono_literals;
         using namespace beast::severities;
@@ -47,9 +58,7 @@ public:
         TestStopwatch clock;
         clock.set (0);
 
-        using Key = int;
-        using Value = std::string;
-        using Cache = TaggedCache <Key, Value>;
+        using Value = typename Cache::mapped_type;
 
         Cache c ("test", 1, 1s, clock, journal);
 
@@ -81,7 +90,7 @@ public:
             BEAST_EXPECT(c.getTrackSize() == 1);
 
             {
-                Cache::mapped_ptr p (c.fetch (2));
+                typename Cache::mapped_ptr p (c.fetch (2));
                 BEAST_EXPECT(p != nullptr);
                 ++clock;
                 c.sweep ();
@@ -101,8 +110,8 @@ public:
             BEAST_EXPECT(! c.insert (3, "three"));
 
             {
-                Cache::mapped_ptr const p1 (c.fetch (3));
-                Cache::mapped_ptr p2 (std::make_shared <Value> ("three"));
+                typename Cache::mapped_ptr const p1 (c.fetch (3));
+                typename Cache::mapped_ptr p2 (std::make_shared <Value> ("three"));
                 c.canonicalize (3, p2);
                 BEAST_EXPECT(p1.get() == p2.get());
             }
@@ -123,7 +132,7 @@ public:
 
             {
                 // Keep a strong pointer to it
-                Cache::mapped_ptr p1 (c.fetch (4));
+                typename Cache::mapped_ptr p1 (c.fetch (4));
                 BEAST_EXPECT(p1 != nullptr);
                 BEAST_EXPECT(c.getCacheSize() == 1);
                 BEAST_EXPECT(c.getTrackSize() == 1);
@@ -133,7 +142,7 @@ public:
                 BEAST_EXPECT(c.getCacheSize() == 0);
                 BEAST_EXPECT(c.getTrackSize() == 1);
                 // Canonicalize a new object with the same key
-                Cache::mapped_ptr p2 (std::make_shared <std::string> ("four"));
+                typename Cache::mapped_ptr p2 (std::make_shared <std::string> ("four"));
                 BEAST_EXPECT(c.canonicalize (4, p2, false));
                 BEAST_EXPECT(c.getCacheSize() == 1);
                 BEAST_EXPECT(c.getTrackSize() == 1);
@@ -147,8 +156,134 @@ public:
             BEAST_EXPECT(c.getTrackSize() == 0);
         }
     }
+
+    void run () override
+    {
+        testcase ("TaggedCache");
+        testCache <TaggedCache <int, std::string>> ();
+
+        testcase ("PartitionedTaggedCache");
+        testCache <PartitionedTaggedCache <int, std::string>> ();
+    }
 };
 
 BEAST_DEFINE_TESTSUITE(TaggedCache,common,ripple);
 
+//------------------------------------------------------------------------------
+
+/*
+Measure the throughput of concurrent fetch and canonicalize calls against
+a single-mutex TaggedCache and a PartitionedTaggedCache, for an increasing
+number of threads. Each thread performs a mix of lookups and insertions
+over a shared set of random keys, mirroring the access pattern of the
+TreeNodeCache and the NodeStore positive cache during ledger acquisition.
+*/
+
+class TaggedCacheTiming_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr numKeys = 100000;
+    static std::size_t constexpr opsPerThread = 1000000;
+
+    // One out of this many operations is a canonicalize
+    static std::size_t constexpr canonicalizeRatio = 10;
+
+    std::vector <uint256> keys_;
+
+    template <class Cache>
+    std::chrono::milliseconds
+    timeCache (Cache& c, std::size_t threads)
+    {
+        using namespace std::chrono;
+
+        std::atomic <std::size_t> found {0};
+        std::vector <std::thread> workers;
+        workers.reserve (threads);
+
+        auto const start = steady_clock::now ();
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back (
+                [this, &c, &found, t]
+                {
+                    beast::xor_shift_engine g (t + 1);
+                    std::uniform_int_distribution <std::size_t>
+                        dist (0, keys_.size () - 1);
+                    std::size_t hits = 0;
+
+                    for (std::size_t i = 0; i < opsPerThread; ++i)
+                    {
+                        auto const& key = keys_[dist (g)];
+                        if (i % canonicalizeRatio == 0)
+                        {
+                            auto p = std::make_shared <int> (0);
+                            c.canonicalize (key, p);
+                        }
+                        else if (c.fetch (key))
+                        {
+                            ++hits;
+                        }
+                    }
+                    found += hits;
+                });
+        }
+        for (auto& w : workers)
+            w.join ();
+        auto const elapsed = duration_cast <milliseconds> (
+            steady_clock::now () - start);
+
+        BEAST_EXPECT(found <= threads * opsPerThread);
+        return elapsed;
+    }
+
+    template <class Cache>
+    void timeCacheType (char const* name, std::size_t threads)
+    {
+        using namespace std::chrono_literals;
+        test::SuiteJournal journal ("TaggedCacheTiming_test", *this);
+
+        Cache c ("bench", numKeys, 1min, stopwatch (), journal);
+        auto const elapsed = timeCache (c, threads);
+        auto const ops = threads * opsPerThread;
+
+        log << "    " << name << ", " << threads << " threads: " <<
+            elapsed.count () << " ms, " <<
+            (ops * 1000) / std::max <std::int64_t> (1, elapsed.count ()) <<
+            " ops/s" << std::endl;
+    }
+
+public:
+    TaggedCacheTiming_test ()
+    {
+        beast::xor_shift_engine g (19207813);
+        keys_.reserve (numKeys);
+        std::uint8_t buf[32];
+
+        for (std::size_t i = 0; i < numKeys; ++i)
+        {
+            beast::rngfill (buf, sizeof (buf), g);
+            keys_.push_back (uint256::fromVoid (buf));
+        }
+    }
+
+    void run () override
+    {
+        testcase ("concurrent fetch/canonicalize");
+
+        auto const maxThreads = std::max (
+            1u, std::thread::hardware_concurrency ());
+
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            timeCacheType <TaggedCache <uint256, int>> (
+                "TaggedCache", threads);
+            timeCacheType <PartitionedTaggedCache <uint256, int>> (
+                "PartitionedTaggedCache", threads);
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(TaggedCacheTiming,common,ripple);
+
 }
@@ -20,6 +20,12 @@
 #include <ripple/core/JobQueue.h>
 #include <ripple/beast/unit_test.h>
 #include <test/jtx/Env.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace test {
@@ -139,15 +145,174 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void testPriority()
+    {
+        testcase ("priority");
+
+        // A standalone Env runs the JobQueue with a single thread.
+        jtx::Env env {*this};
+        JobQueue& jQueue = env.app().getJobQueue();
+
+        std::mutex m;
+        std::vector<std::string> order;
+        auto record = [&m, &order] (std::string const& name)
+        {
+            return [&m, &order, name] (Job&)
+            {
+                std::lock_guard<std::mutex> lock (m);
+                order.push_back (name);
+            };
+        };
+
+        // Hold the only worker thread while the other jobs are queued.
+        std::atomic<bool> started {false};
+        std::atomic<bool> release {false};
+        BEAST_EXPECT (jQueue.addJob (jtCLIENT, "JobPriorityHold",
+            [&started, &release] (Job&)
+            {
+                started = true;
+                while (release == false)
+                    std::this_thread::yield();
+            }));
+        while (started == false);
+
+        BEAST_EXPECT (jQueue.addJob (jtCLIENT, "A", record ("A")));
+        BEAST_EXPECT (jQueue.addJob (jtCLIENT, "B", record ("B")));
+        BEAST_EXPECT (jQueue.addJob (jtTRANSACTION, "C", record ("C")));
+        release = true;
+        jQueue.rendezvous();
+
+        // Higher priority types run first, equal types in FIFO order.
+        std::lock_guard<std::mutex> lock (m);
+        BEAST_EXPECT (order == std::vector<std::string>({"C", "A", "B"}));
+    }
+
+    void testLimits()
+    {
+        testcase ("limits");
+
+        jtx::Env env {*this};
+        JobQueue& jQueue = env.app().getJobQueue();
+        jQueue.setThreadCount (4, false);
+
+        // jtPACK may only run one job at a time. Post it alongside an
+        // unlimited type from several threads and check that the limit
+        // holds while every job still runs.
+        std::size_t constexpr jobsPerThread = 500;
+        std::size_t constexpr threads = 4;
+
+        std::atomic<int> packRunning {0};
+        std::atomic<int> packPeak {0};
+        std::atomic<std::size_t> done {0};
+
+        std::vector<std::thread> posters;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            posters.emplace_back ([&]
+            {
+                for (std::size_t i = 0; i < jobsPerThread; ++i)
+                {
+                    jQueue.addJob (jtPACK, "JobLimitPack",
+                        [&] (Job&)
+                        {
+                            auto const n = ++packRunning;
+                            int peak = packPeak;
+                            while (n > peak &&
+                                    ! packPeak.compare_exchange_weak (peak, n));
+                            std::this_thread::yield ();
+                            --packRunning;
+                            ++done;
+                        });
+                    jQueue.addJob (jtCLIENT, "JobLimitClient",
+                        [&done] (Job&) { ++done; });
+                }
+            });
+        }
+        for (auto& p : posters)
+            p.join ();
+        jQueue.rendezvous();
+
+        BEAST_EXPECT (done == 2 * threads * jobsPerThread);
+        BEAST_EXPECT (packPeak == 1);
+        BEAST_EXPECT (jQueue.getJobCountTotal (jtPACK) == 0);
+        BEAST_EXPECT (jQueue.getJobCountGE (jtPACK) == 0);
+    }
+
 public:
     void run() override
     {
         testAddJob();
         testPostCoro();
+        testPriority();
+        testLimits();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(JobQueue, core, ripple);
 
+//------------------------------------------------------------------------------
+
+class JobQueueThroughput_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr jobsPerThread = 100000;
+
+    // Post many tiny jobs from several threads at once and
+    // measure how long the queue takes to run them all.
+    std::chrono::milliseconds
+    timeJobs (JobQueue& jQueue, std::size_t threads)
+    {
+        using namespace std::chrono;
+
+        std::atomic<std::size_t> done {0};
+        auto const total = threads * jobsPerThread;
+
+        auto const start = steady_clock::now ();
+        std::vector<std::thread> posters;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            posters.emplace_back ([&jQueue, &done]
+            {
+                for (std::size_t i = 0; i < jobsPerThread; ++i)
+                    jQueue.addJob (jtCLIENT, "JobThroughput",
+                        [&done] (Job&) { ++done; });
+            });
+        }
+        for (auto& p : posters)
+            p.join ();
+        while (done != total)
+            std::this_thread::yield ();
+
+        return duration_cast <milliseconds> (steady_clock::now () - start);
+    }
+
+public:
+    void run () override
+    {
+        testcase ("throughput");
+
+        jtx::Env env {*this};
+        JobQueue& jQueue = env.app().getJobQueue();
+
+        auto const maxThreads = std::max (
+            1u, std::thread::hardware_concurrency ());
+
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            jQueue.setThreadCount (static_cast<int> (threads), false);
+            auto const elapsed = timeJobs (jQueue, threads);
+            auto const jobs = threads * jobsPerThread;
+
+            log << "    " << threads << " threads: " <<
+                elapsed.count () << " ms, " <<
+                (jobs * 1000) / std::max <std::int64_t> (1, elapsed.count ()) <<
+                " jobs/s" << std::endl;
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JobQueueThroughput, core, ripple);
+
 } // test
 } // ripple
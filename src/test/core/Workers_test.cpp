@@ -62,6 +62,10 @@ class PerfLogTest
         int instance) override
     {}
 
+    void openLedgerAccept(std::chrono::microseconds dur,
+        std::chrono::microseconds locked) override
+    {}
+
     Json::Value countersJson() const override
     {
         return Json::Value();
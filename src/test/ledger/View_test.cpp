@@ -26,6 +26,8 @@
 #include <ripple/core/ConfigSections.h>
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/Protocol.h>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 
 namespace ripple {
@@ -181,6 +183,105 @@ class View_test
         BEAST_EXPECT(v.exists(k(3)));
     }
 
+    // Exercise CachedView's succ on top of a ledger
+    void
+    testCachedSucc()
+    {
+        using namespace jtx;
+        Env env(*this);
+        Config config;
+        std::shared_ptr<Ledger const> const genesis =
+            std::make_shared<Ledger>(
+                create_genesis, config,
+                std::vector<uint256>{}, env.app().family());
+        auto const ledger =
+            std::make_shared<Ledger>(
+                *genesis,
+                env.app().timeKeeper().closeTime());
+        wipe(*ledger);
+        ledger->rawInsert(sle(1));
+        ledger->rawInsert(sle(3));
+        ledger->rawInsert(sle(5));
+        ledger->setImmutable(config);
+
+        CachedLedger const v (ledger, env.app().cachedSLEs());
+
+        // Twice, so the second round comes from the cache
+        for (int i = 0; i < 2; ++i)
+        {
+            succ(v, 0, 1);
+            succ(v, 1, 3);
+            succ(v, 2, 3);
+            succ(v, 5, boost::none);
+            BEAST_EXPECT(! v.succ(k(1).key, k(3).key));
+            BEAST_EXPECT(v.succ(k(1).key, k(4).key) == k(3).key);
+            BEAST_EXPECT(! v.succ(k(5).key, k(6).key));
+        }
+
+        // Changes in a view on top are still seen
+        OpenView ov (&v);
+        ov.rawErase(copy(v.read(k(3))));
+        ov.rawInsert(sle(4));
+        succ(ov, 1, 4);
+        succ(ov, 4, 5);
+        succ(v, 1, 3);
+    }
+
+    // Exercise CachedView's read from several threads at once
+    void
+    testCachedRead()
+    {
+        using namespace jtx;
+        Env env(*this);
+        Config config;
+        std::shared_ptr<Ledger const> const genesis =
+            std::make_shared<Ledger>(
+                create_genesis, config,
+                std::vector<uint256>{}, env.app().family());
+        auto const ledger =
+            std::make_shared<Ledger>(
+                *genesis,
+                env.app().timeKeeper().closeTime());
+        wipe(*ledger);
+        std::uint64_t const count = 64;
+        for (std::uint64_t id = 1; id <= count; ++id)
+            ledger->rawInsert(sle(id, id));
+        ledger->setImmutable(config);
+
+        auto& cache = env.app().cachedSLEs();
+        CachedLedger const v (ledger, cache);
+
+        std::atomic<int> errors {0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    for (std::uint64_t id = 1; id <= count; ++id)
+                    {
+                        if (seq(v.read(k(id))) != id)
+                            ++errors;
+                    }
+                    if (v.exists(k(count + 1)))
+                        ++errors;
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        BEAST_EXPECT(errors == 0);
+        BEAST_EXPECT(cache.size() >= count);
+
+        // Later reads are served by the view without deserializing
+        auto const misses = cache.misses();
+        for (std::uint64_t id = 1; id <= count; ++id)
+            BEAST_EXPECT(seq(v.read(k(id))) == id);
+        BEAST_EXPECT(cache.misses() == misses);
+    }
+
     void
     testMeta()
     {
@@ -769,6 +870,8 @@ class View_test
         BEAST_EXPECT(k(0).key < k(1).key);
 
         testLedger();
+        testCachedSucc();
+        testCachedRead();
         testMeta();
         testMetaSucc();
         testStacked();
@@ -23,6 +23,7 @@
 #include <ripple/beast/utility/temp_dir.h>
 #include <test/nodestore/TestBase.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <boost/filesystem.hpp>
 #include <algorithm>
 
 namespace ripple {
@@ -36,16 +37,20 @@ public:
     void testBackend (
         std::string const& type,
         std::uint64_t const seedValue,
-        int numObjectsToTest = 2000)
+        int numObjectsToTest = 2000,
+        int ioDepth = 0)
     {
         DummyScheduler scheduler;
 
-        testcase ("Backend type=" + type);
+        testcase ("Backend type=" + type +
+            (ioDepth ? " io_depth=" + std::to_string (ioDepth) : ""));
 
         Section params;
         beast::temp_dir tempDir;
         params.set ("type", type);
         params.set ("path", tempDir.path());
+        if (ioDepth)
+            params.set ("io_depth", std::to_string (ioDepth));
 
         beast::xor_shift_engine rng (seedValue);
 
@@ -73,6 +78,20 @@ public:
                 BEAST_EXPECT(areBatchesEqual (batch, copy));
             }
 
+            {
+                // Read it back in with a single batch fetch
+                std::vector<uint256 const*> hashes;
+                hashes.reserve (batch.size ());
+                for (auto const& object : batch)
+                    hashes.push_back (&object->getHash ());
+                auto const result = backend->fetchBatch (hashes);
+                BEAST_EXPECT(result.second == ok);
+                Batch const copy (result.first.begin (), result.first.end ());
+                if (BEAST_EXPECT(std::find (copy.begin (), copy.end (),
+                        nullptr) == copy.end ()))
+                    BEAST_EXPECT(areBatchesEqual (batch, copy));
+            }
+
             {
                 // Reorder and read the copy again
                 std::shuffle (
@@ -101,6 +120,74 @@ public:
         }
     }
 
+    void testNuDBZstd (std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase ("Backend type=nudb codec=zstd");
+
+        Section params;
+        beast::temp_dir tempDir;
+        params.set ("type", "nudb");
+        params.set ("path", tempDir.path());
+        params.set ("codec", "zstd");
+
+        // Enough leaves to train a dictionary and then use it
+        auto const batch = createPredictableLeafBatch (
+            3 * numObjectsToTest, seedValue);
+
+        test::SuiteJournal journal ("Backend_test", *this);
+
+        {
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (
+                    params, scheduler, journal);
+            backend->open();
+            storeBatch (*backend, batch);
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        BEAST_EXPECT(boost::filesystem::exists (
+            boost::filesystem::path (tempDir.path()) / "nudb.dict"));
+
+        {
+            // Re-open the backend, which must load the dictionary
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (
+                    params, scheduler, journal);
+            backend->open();
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+        }
+
+        BEAST_EXPECT(! boost::filesystem::exists (
+            boost::filesystem::path (tempDir.path()) / "nudb.dict.tmp"));
+
+        {
+            // Switching back to lz4 must still read the zstd objects
+            params.set ("codec", "lz4");
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (
+                    params, scheduler, journal);
+            backend->open();
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual (batch, copy));
+
+            auto const more = createPredictableLeafBatch (
+                numObjectsToTest, seedValue + 1);
+            storeBatch (*backend, more);
+            fetchCopyOfBatch (*backend, &copy, more);
+            BEAST_EXPECT(areBatchesEqual (more, copy));
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void run () override
@@ -108,6 +195,8 @@ public:
         std::uint64_t const seedValue = 50;
 
         testBackend ("nudb", seedValue);
+        testBackend ("nudb", seedValue, 2000, 8);
+        testNuDBZstd (seedValue);
 
     #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend ("rocksdb", seedValue);
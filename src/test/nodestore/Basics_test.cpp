@@ -22,6 +22,8 @@
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <nudb/detail/buffer.hpp>
 
 namespace ripple {
 namespace NodeStore {
@@ -76,6 +78,79 @@ public:
         }
     }
 
+    // Checks the zstd dictionary codec against lz4
+    void testCodec (std::uint64_t const seedValue)
+    {
+        testcase ("codec");
+
+        auto const batch = createPredictableLeafBatch (
+            4 * numObjectsToTest, seedValue);
+
+        std::vector<Blob> samples;
+        for (int i = 0; i < numObjectsToTest; ++i)
+        {
+            EncodedBlob encoded;
+            encoded.prepare (batch[i]);
+            auto const p = static_cast<std::uint8_t const*>(
+                encoded.getData ());
+            samples.emplace_back (p, p + encoded.getSize ());
+        }
+
+        auto const dict = ZstdDictionary::train (samples, kilobytes(16));
+        if (! BEAST_EXPECT(dict))
+            return;
+
+        {
+            // A dictionary round trips through its raw form
+            ZstdDictionary const copy (
+                dict->data().data(), dict->data().size());
+            BEAST_EXPECT(copy.id() == dict->id());
+        }
+
+        std::size_t lz4Bytes = 0;
+        std::size_t zstdBytes = 0;
+        for (auto const& object : batch)
+        {
+            EncodedBlob encoded;
+            encoded.prepare (object);
+
+            nudb::detail::buffer lbf;
+            auto const lz4 = nodeobject_compress (
+                encoded.getData (), encoded.getSize (), lbf);
+            lz4Bytes += lz4.second;
+
+            nudb::detail::buffer zbf;
+            auto const zstd = nodeobject_compress (
+                encoded.getData (), encoded.getSize (), zbf, dict.get ());
+            zstdBytes += zstd.second;
+
+            nudb::detail::buffer dbf;
+            auto const out = nodeobject_decompress (
+                zstd.first, zstd.second, dbf, dict.get ());
+            DecodedBlob decoded (
+                encoded.getKey (), out.first, out.second);
+            if (! BEAST_EXPECT(decoded.wasOk ()))
+                break;
+            BEAST_EXPECT(isSame (object, decoded.createObject ()));
+
+            // zstd objects can't be read without the dictionary
+            bool threw = false;
+            try
+            {
+                nudb::detail::buffer bf;
+                nodeobject_decompress (zstd.first, zstd.second, bf);
+            }
+            catch (std::runtime_error const&)
+            {
+                threw = true;
+            }
+            if (! BEAST_EXPECT(threw))
+                break;
+        }
+
+        BEAST_EXPECT(zstdBytes < lz4Bytes);
+    }
+
     void run () override
     {
         std::uint64_t const seedValue = 50;
@@ -83,6 +158,8 @@ public:
         testBatches (seedValue);
 
         testBlobs (seedValue);
+
+        testCodec (seedValue);
     }
 };
 
@@ -28,6 +28,9 @@
 #include <ripple/beast/xor_shift_engine.h>
 #include <ripple/nodestore/Backend.h>
 #include <ripple/nodestore/Types.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntry.h>
 #include <boost/algorithm/string.hpp>
 #include <iomanip>
 
@@ -113,6 +116,52 @@ public:
         return batch;
     }
 
+    // Create a predictable batch of account root leaves, serialized the
+    // way SHAMap stores them. Unlike random payloads these compress the
+    // way real ledger state does.
+    static
+    Batch createPredictableLeafBatch(
+        int numObjects, std::uint64_t seed)
+    {
+        Batch batch;
+        batch.reserve (numObjects);
+
+        beast::xor_shift_engine rng (seed);
+
+        for (int i = 0; i < numObjects; ++i)
+        {
+            AccountID id;
+            beast::rngfill (id.begin(), id.size(), rng);
+            uint256 txID;
+            beast::rngfill (txID.begin(), txID.size(), rng);
+
+            STLedgerEntry sle (keylet::account (id));
+            sle.setAccountID (sfAccount, id);
+            sle.setFieldAmount (sfBalance, STAmount (
+                rand_int (rng, std::uint64_t{20000000},
+                    std::uint64_t{100000000000})));
+            sle.setFieldU32 (sfSequence,
+                rand_int (rng, 1u, 100000u));
+            sle.setFieldU32 (sfOwnerCount,
+                rand_int (rng, 0u, 20u));
+            sle.setFieldH256 (sfPreviousTxnID, txID);
+            sle.setFieldU32 (sfPreviousTxnLgrSeq,
+                rand_int (rng, 32570u, 50000000u));
+
+            Serializer s;
+            s.add32 (HashPrefix::leafNode);
+            sle.add (s);
+            s.add256 (sle.key());
+            auto const hash = s.getSHA512Half();
+
+            batch.push_back (
+                NodeObject::createObject(
+                    hotACCOUNT_NODE, std::move (s.modData()), hash));
+        }
+
+        return batch;
+    }
+
     // Compare two batches for equality
     static bool areBatchesEqual (Batch const& lhs, Batch const& rhs)
     {
@@ -28,6 +28,7 @@
 #include <test/unit_test/SuiteJournal.h>
 #include <beast/unit_test/thread.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <atomic>
 #include <chrono>
 #include <iterator>
@@ -145,6 +146,9 @@ public:
     {
         // percent of fetches for missing nodes
         missingNodePercent = 20
+
+        // number of keys per batch in batched fetches
+        ,fetchBatchSize = 64
     };
 
     std::size_t const default_repeat = 3;
@@ -387,6 +391,80 @@ public:
         backend->close();
     }
 
+    // Fetch existing keys in batches
+    void
+    do_fetch_batch (Section const& config,
+        Params const& params, beast::Journal journal)
+    {
+        DummyScheduler scheduler;
+        auto backend = make_Backend (config, scheduler, journal);
+        BEAST_EXPECT(backend != nullptr);
+        backend->open();
+
+        class Body
+        {
+        private:
+            suite& suite_;
+            Backend& backend_;
+            Sequence seq1_;
+            beast::xor_shift_engine gen_;
+            std::uniform_int_distribution<std::size_t> dist_;
+
+        public:
+            Body (std::size_t id, suite& s,
+                    Params const& params, Backend& backend)
+                : suite_(s)
+                , backend_ (backend)
+                , seq1_ (1)
+                , gen_ (id + 1)
+                , dist_ (0, params.items - 1)
+            {
+            }
+
+            void
+            operator()(std::size_t i)
+            {
+                try
+                {
+                    std::vector<std::shared_ptr<NodeObject>> objs;
+                    std::vector<uint256 const*> hashes;
+                    objs.reserve(fetchBatchSize);
+                    hashes.reserve(fetchBatchSize);
+                    for (std::size_t n = 0; n < fetchBatchSize; ++n)
+                    {
+                        objs.push_back(seq1_.obj(dist_(gen_)));
+                        hashes.push_back(&objs.back()->getHash());
+                    }
+                    auto const result = backend_.fetchBatch(hashes);
+                    suite_.expect(result.second == ok);
+                    suite_.expect(result.first.size() == objs.size());
+                    for (std::size_t n = 0; n < result.first.size(); ++n)
+                        suite_.expect(result.first[n] &&
+                            isSame(result.first[n], objs[n]));
+                }
+                catch(std::exception const& e)
+                {
+                    suite_.fail(e.what());
+                }
+            }
+        };
+        try
+        {
+            // Fetch the same number of objects as do_fetch
+            parallel_for_id<Body>(params.items / fetchBatchSize,
+                params.threads, std::ref(*this), std::ref(params),
+                    std::ref(*backend));
+        }
+        catch (std::exception const&)
+        {
+        #if NODESTORE_TIMING_DO_VERIFY
+            backend->verify();
+        #endif
+            Rethrow();
+        }
+        backend->close();
+    }
+
     // Perform lookups of non-existent keys
     void
     do_missing (Section const& config,
@@ -702,6 +780,84 @@ public:
         }
     }
 
+    //--------------------------------------------------------------------------
+
+    // Total size of the files in a directory
+    static
+    std::uintmax_t
+    disk_usage (std::string const& path)
+    {
+        using namespace boost::filesystem;
+        std::uintmax_t bytes = 0;
+        for (auto const& entry : recursive_directory_iterator (path))
+            if (is_regular_file (entry.status()))
+                bytes += file_size (entry.path());
+        return bytes;
+    }
+
+    /*  Compare codecs on data that compresses like ledger state.
+
+        For each configuration, store account root leaves, then report the
+        space used on disk and the rate at which they are read back and
+        decoded.
+    */
+    void
+    do_codec_tests (std::vector<std::string> const& config_strings)
+    {
+        using std::setw;
+        log << default_items << " Leaves" << std::endl;
+        log << std::left << setw(10) << "Backend" << std::right <<
+            " " << setw(12) << "Disk" <<
+            " " << setw(12) << "Fetch" <<
+            " " << setw(12) << "Decoded/s" << std::endl;
+
+        test::SuiteJournal journal ("Timing_test", *this);
+        auto const batch = TestBase::createPredictableLeafBatch (
+            default_items, 1);
+        std::uintmax_t rawBytes = 0;
+        for (auto const& object : batch)
+            rawBytes += object->getData().size();
+
+        for (auto const& config_string : config_strings)
+        {
+            beast::temp_dir tempDir;
+            Section config = parse(config_string);
+            config.set ("path", tempDir.path());
+            DummyScheduler scheduler;
+
+            {
+                auto backend = make_Backend (config, scheduler, journal);
+                backend->open();
+                for (auto const& object : batch)
+                    backend->store (object);
+            }
+            auto const disk = disk_usage (tempDir.path());
+
+            auto backend = make_Backend (config, scheduler, journal);
+            backend->open();
+            auto const start = clock_type::now();
+            for (auto const& object : batch)
+            {
+                std::shared_ptr<NodeObject> result;
+                backend->fetch (object->getHash().data(), &result);
+                expect (result && isSame (result, object));
+            }
+            auto const elapsed = std::chrono::duration_cast<duration_type> (
+                clock_type::now() - start);
+
+            std::stringstream ss;
+            ss << std::left << setw(10) <<
+                get(config, "type", std::string()) << std::right <<
+                " " << setw(12) << (std::to_string (disk / 1024) + "K") <<
+                " " << setw(12) << to_string (elapsed) <<
+                " " << setw(12) << (std::to_string (rawBytes * 1000 /
+                    std::max<std::int64_t>(1, elapsed.count()) / 1024) +
+                        "K") <<
+                "   " << to_string(config);
+            log << ss.str() << std::endl;
+        }
+    }
+
     void
     run() override
     {
@@ -728,6 +884,7 @@ public:
             {
                  { "Insert",    &Timing_test::do_insert }
                 ,{ "Fetch",     &Timing_test::do_fetch }
+                ,{ "FetchBatch", &Timing_test::do_fetch_batch }
                 ,{ "Missing",   &Timing_test::do_missing }
                 ,{ "Mixed",     &Timing_test::do_mixed }
                 ,{ "Work",      &Timing_test::do_work }
@@ -748,6 +905,9 @@ public:
         do_tests ( 4, tests, config_strings);
         do_tests ( 8, tests, config_strings);
         //do_tests (16, tests, config_strings);
+
+        // Random payloads don't compress, so codecs get their own data
+        do_codec_tests ({ "type=nudb", "type=nudb,codec=zstd" });
     }
 };
 
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <ripple/overlay/Message.h>
+#include <ripple/overlay/impl/ProtocolMessage.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/asio/buffer.hpp>
+#include <memory>
+#include <string>
+
+namespace ripple {
+
+class compression_test : public beast::unit_test::suite
+{
+    // Records what invokeProtocolMessage delivers
+    struct Handler
+    {
+        int type = 0;
+        std::size_t size = 0;
+        std::size_t uncompressedSize = 0;
+        std::shared_ptr<::google::protobuf::Message> message;
+
+        boost::system::error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        }
+
+        boost::system::error_code
+        onMessageBegin (std::uint16_t t,
+            std::shared_ptr<::google::protobuf::Message> const& m,
+            std::size_t s, std::size_t u)
+        {
+            type = t;
+            message = m;
+            size = s;
+            uncompressedSize = u;
+            return {};
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr<::google::protobuf::Message> const&)
+        {
+        }
+    };
+
+    static
+    protocol::TMLedgerData
+    makeLedgerData (int nodes)
+    {
+        protocol::TMLedgerData ld;
+        ld.set_ledgerhash (std::string (32, '\x11'));
+        ld.set_ledgerseq (1000);
+        ld.set_type (protocol::liAS_NODE);
+        for (int i = 0; i < nodes; ++i)
+        {
+            auto node = ld.add_nodes();
+            node->set_nodeid (std::string (33, static_cast<char>(i)));
+            node->set_nodedata (std::string (200, 'x') + std::to_string(i));
+        }
+        return ld;
+    }
+
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        auto const ld = makeLedgerData (50);
+        Message m (ld, protocol::mtLEDGER_DATA);
+
+        auto const& plain = m.getBuffer (false);
+        auto const& packed = m.getBuffer (true);
+        BEAST_EXPECT(&plain == &m.getBuffer ());
+        BEAST_EXPECT(packed.size () < plain.size ());
+
+        // The compressed form is only built once
+        BEAST_EXPECT(&packed == &m.getBuffer (true));
+
+        auto const buffers = boost::asio::buffer (packed);
+        BEAST_EXPECT(Message::compression (buffers) ==
+            Message::Compression::lz4);
+        BEAST_EXPECT(Message::type (buffers) == protocol::mtLEDGER_DATA);
+        BEAST_EXPECT(Message::size (buffers) +
+            Message::kCompressedHeaderBytes == packed.size ());
+
+        Handler h;
+        auto const result = invokeProtocolMessage (buffers, h, true);
+        BEAST_EXPECT(! result.second);
+        BEAST_EXPECT(result.first == packed.size ());
+        BEAST_EXPECT(h.type == protocol::mtLEDGER_DATA);
+        BEAST_EXPECT(h.size == packed.size ());
+        BEAST_EXPECT(h.uncompressedSize == plain.size ());
+        if (BEAST_EXPECT(h.message))
+        {
+            BEAST_EXPECT(h.message->SerializeAsString () ==
+                ld.SerializeAsString ());
+        }
+
+        // A truncated message waits for more data
+        Handler partial;
+        auto const r = invokeProtocolMessage (
+            boost::asio::buffer (packed.data (), packed.size () - 1),
+                partial, true);
+        BEAST_EXPECT(r.first == 0 && ! r.second);
+        BEAST_EXPECT(! partial.message);
+    }
+
+    void
+    testNotNegotiated ()
+    {
+        testcase ("not negotiated");
+
+        Message m (makeLedgerData (50), protocol::mtLEDGER_DATA);
+
+        Handler h;
+        auto const result = invokeProtocolMessage (
+            boost::asio::buffer (m.getBuffer (true)), h, false);
+        BEAST_EXPECT(result.second);
+        BEAST_EXPECT(! h.message);
+    }
+
+    void
+    testCorrupt ()
+    {
+        testcase ("corrupt");
+
+        Message m (makeLedgerData (50), protocol::mtLEDGER_DATA);
+        auto packed = m.getBuffer (true);
+
+        // Claim a larger uncompressed size than the payload holds
+        packed[6] = 0;
+        packed[7] = 0x10;
+        Handler h;
+        auto const result = invokeProtocolMessage (
+            boost::asio::buffer (packed), h, true);
+        BEAST_EXPECT(result.second);
+        BEAST_EXPECT(! h.message);
+    }
+
+    void
+    testUncompressed ()
+    {
+        testcase ("uncompressed");
+
+        {
+            // Too small to be worth compressing
+            Message m (makeLedgerData (0), protocol::mtLEDGER_DATA);
+            BEAST_EXPECT(&m.getBuffer (true) == &m.getBuffer ());
+        }
+
+        {
+            // Not a compressible type
+            protocol::TMPing ping;
+            ping.set_type (protocol::TMPing::ptPING);
+            ping.set_seq (1);
+            Message m (ping, protocol::mtPING);
+            BEAST_EXPECT(&m.getBuffer (true) == &m.getBuffer ());
+
+            auto const& buffer = m.getBuffer ();
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (buffer), h, true);
+            BEAST_EXPECT(! result.second);
+            BEAST_EXPECT(result.first == buffer.size ());
+            BEAST_EXPECT(h.size == buffer.size ());
+            BEAST_EXPECT(h.uncompressedSize == buffer.size ());
+        }
+    }
+
+public:
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testNotNegotiated ();
+        testCorrupt ();
+        testUncompressed ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(compression,overlay,ripple);
+
+}
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/basics/Log.h>
+#include <ripple/protocol/Indexes.h>
 #include <ripple/protocol/JsonFields.h>
 #include <ripple/protocol/SecretKey.h>
 #include <ripple/protocol/st.h>
@@ -26,6 +27,7 @@
 #include <ripple/beast/unit_test.h>
 #include <test/jtx.h>
 
+#include <chrono>
 #include <memory>
 #include <type_traits>
 
@@ -647,4 +649,74 @@ public:
 
 BEAST_DEFINE_TESTSUITE(STObject,protocol,ripple);
 
+// Measures the typed field accessors used by transactors and the
+// invariant checkers, on a ledger entry with a template and on a free
+// object holding the same fields.
+class STObjectTiming_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr iterations = 10000000;
+
+    template <class Object>
+    std::chrono::milliseconds
+    timeAccess (Object const& obj)
+    {
+        using namespace std::chrono;
+
+        std::uint64_t sum = 0;
+        auto const start = steady_clock::now ();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            sum += obj.getFieldU32 (sfSequence);
+            sum += obj.getFieldU32 (sfOwnerCount);
+            sum += obj.getFieldAmount (sfBalance).mantissa ();
+            sum += *obj.getAccountID (sfAccount).begin ();
+            sum += obj[sfFlags];
+        }
+        auto const elapsed = duration_cast<milliseconds> (
+            steady_clock::now () - start);
+
+        BEAST_EXPECT(sum != 0);
+        return elapsed;
+    }
+
+    template <class Object>
+    void
+    fill (Object& obj, AccountID const& id)
+    {
+        obj.setAccountID (sfAccount, id);
+        obj.setFieldAmount (sfBalance, STAmount (XRPAmount (1000000)));
+        obj.setFieldU32 (sfSequence, 7);
+        obj.setFieldU32 (sfOwnerCount, 3);
+        obj.setFieldU32 (sfFlags, 0);
+    }
+
+    void
+    report (char const* name, std::chrono::milliseconds elapsed)
+    {
+        auto const ops = iterations * 5;
+        log << "    " << name << ": " << elapsed.count () << " ms, " <<
+            (ops * 1000) / std::max<std::int64_t> (1, elapsed.count ()) <<
+            " accesses/s" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase ("field access");
+
+        AccountID const id (0x123456789);
+
+        SLE sle (keylet::account (id));
+        fill (sle, id);
+        report ("templated", timeAccess (sle));
+
+        STObject obj (sfLedgerEntry);
+        fill (obj, id);
+        report ("free", timeAccess (obj));
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectTiming,protocol,ripple);
+
 } // ripple
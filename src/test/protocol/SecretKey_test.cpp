@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/crypto/csprng.h>
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SecretKey.h>
@@ -24,6 +25,7 @@
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/rngfill.h>
 #include <algorithm>
+#include <array>
 #include <string>
 #include <vector>
 
@@ -445,6 +447,113 @@ public:
         BEAST_EXPECT(sk3 == sk2);
     }
 
+    void testBatchVerify ()
+    {
+        testcase ("batch verification");
+
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        std::vector<std::vector<std::uint8_t>> data;
+        std::vector<Buffer> sigs;
+
+        for (std::size_t i = 0; i < 48; i++)
+        {
+            keys.push_back (randomKeyPair (
+                (i % 3 == 0) ? KeyType::secp256k1 : KeyType::ed25519));
+
+            data.emplace_back (32 + i);
+            beast::rngfill (
+                data.back().data(),
+                data.back().size(),
+                crypto_prng());
+
+            sigs.push_back (sign (
+                keys.back().first, keys.back().second,
+                makeSlice (data.back())));
+        }
+
+        // Corrupt a few ed25519 and secp256k1 signatures
+        std::vector<bool> expected (keys.size(), true);
+        for (std::size_t i : { 1, 6, 17, 30 })
+        {
+            sigs[i].data()[i % sigs[i].size()]++;
+            expected[i] = false;
+        }
+
+        std::vector<SignatureCheck> checks;
+        for (std::size_t i = 0; i < keys.size(); i++)
+            checks.push_back ({ keys[i].first, makeSlice (data[i]),
+                Slice{ sigs[i].data(), sigs[i].size() }, true });
+
+        auto const result = verifyBatch (checks);
+        BEAST_EXPECT(result == expected);
+
+        // A batch that verifies entirely
+        checks.erase (checks.begin() + 30);
+        checks.erase (checks.begin() + 17);
+        checks.erase (checks.begin() + 6);
+        checks.erase (checks.begin() + 1);
+        auto const good = verifyBatch (checks);
+        BEAST_EXPECT(good.size() == checks.size());
+        BEAST_EXPECT(std::all_of (good.begin(), good.end(),
+            [](bool b) { return b; }));
+
+        BEAST_EXPECT(verifyBatch ({}).empty());
+    }
+
+    void testBatchVerifyTorsion ()
+    {
+        testcase ("batch verification with small order points");
+
+        // A public key which is a point of order 8, and a signature with
+        // R the identity and S zero. SB - hA is the identity only when
+        // 8 divides h, so verify rejects it for most messages, while the
+        // randomly weighted batch equation holds about one time in eight.
+        auto const pkHex = strUnHex (
+            "EDC7176A703D4DD84FBA3C0B760D10670F2A2053FA2C39CCC64EC7FD7792AC037A");
+        BEAST_EXPECT(pkHex.second);
+        PublicKey const torsionKey (makeSlice (pkHex.first));
+
+        std::array<std::uint8_t, 64> torsionSig {};
+        torsionSig[0] = 1;
+
+        // Find a message which the single check rejects
+        std::vector<std::uint8_t> torsionData (32, 0);
+        while (verify (torsionKey, makeSlice (torsionData),
+            makeSlice (torsionSig), true))
+        {
+            ++torsionData[0];
+        }
+
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        std::vector<std::vector<std::uint8_t>> data;
+        std::vector<Buffer> sigs;
+        for (std::size_t i = 0; i < 7; i++)
+        {
+            keys.push_back (randomKeyPair (KeyType::ed25519));
+            data.emplace_back (32, static_cast<std::uint8_t> (i));
+            sigs.push_back (sign (keys.back().first, keys.back().second,
+                makeSlice (data.back())));
+        }
+
+        std::vector<SignatureCheck> checks;
+        for (std::size_t i = 0; i < keys.size(); i++)
+            checks.push_back ({ keys[i].first, makeSlice (data[i]),
+                Slice{ sigs[i].data(), sigs[i].size() }, true });
+        checks.push_back ({ torsionKey, makeSlice (torsionData),
+            makeSlice (torsionSig), true });
+
+        // The batch weights are random, so try many times
+        bool consistent = true;
+        for (int i = 0; i < 64; ++i)
+        {
+            auto const result = verifyBatch (checks);
+            consistent = consistent && ! result.back() &&
+                std::all_of (result.begin(), result.end() - 1,
+                    [](bool b) { return b; });
+        }
+        BEAST_EXPECT(consistent);
+    }
+
     void run() override
     {
         testBase58();
@@ -457,6 +566,9 @@ public:
 
         testcase ("ed25519");
         testSigning(KeyType::ed25519);
+
+        testBatchVerify();
+        testBatchVerifyTorsion();
     }
 };
 
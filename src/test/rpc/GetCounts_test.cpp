@@ -46,6 +46,9 @@ class GetCounts_test : public beast::unit_test::suite
             BEAST_EXPECT(
                 result.isMember(jss::dbKBTotal) &&
                 result[jss::dbKBTotal].asInt() > 0);
+            BEAST_EXPECT(result.isMember(jss::SLE_hits));
+            BEAST_EXPECT(result.isMember(jss::SLE_misses));
+            BEAST_EXPECT(result.isMember(jss::SLE_cache_size));
         }
 
         // create some transactions
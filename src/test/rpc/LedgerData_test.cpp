@@ -21,6 +21,7 @@
 #include <ripple/protocol/Feature.h>
 #include <ripple/protocol/JsonFields.h>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
 
 namespace ripple {
 
@@ -436,6 +437,60 @@ public:
         }
     }
 
+    void testStreamed()
+    {
+        // ledger_data writes its result as it goes, for the JSON-RPC client
+        // (chunked HTTP/1.1) and for websockets. Both must match the
+        // buffered reply given to the command line client.
+        testcase("Streamed");
+        using namespace test::jtx;
+        Env env {*this};
+        Account const gw {"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+        for (auto i = 0; i < 10; i++)
+        {
+            Account const bob {std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+            env.trust(USD(1000), bob);
+        }
+        env.close();
+
+        auto wsc = test::makeWSClient(env.app().config());
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = "closed";
+        jvParams[jss::limit] = 5;
+        while (true)
+        {
+            auto const buffered = env.rpc ("json", "ledger_data",
+                to_string(jvParams))[jss::result];
+            auto const streamed =
+                env.client().invoke("ledger_data", jvParams)[jss::result];
+            auto const ws = wsc->invoke("ledger_data", jvParams)[jss::result];
+
+            BEAST_EXPECT(buffered[jss::status] == "success");
+            BEAST_EXPECT(checkArraySize(buffered[jss::state], 5) ||
+                ! buffered.isMember(jss::marker));
+            BEAST_EXPECT(streamed == buffered);
+            BEAST_EXPECT(ws[jss::state] == buffered[jss::state]);
+            BEAST_EXPECT(ws[jss::marker] == buffered[jss::marker]);
+
+            if (! checkMarker(buffered))
+                break;
+            jvParams[jss::marker] = buffered[jss::marker];
+        }
+
+        // Errors are reported as before.
+        jvParams[jss::marker] = "NOT_A_MARKER";
+        auto const streamed =
+            env.client().invoke("ledger_data", jvParams)[jss::result];
+        BEAST_EXPECT(streamed[jss::status] == "error");
+        BEAST_EXPECT(streamed[jss::error_message] ==
+            "Invalid field 'marker', not valid.");
+        BEAST_EXPECT(streamed[jss::request][jss::marker] == "NOT_A_MARKER");
+    }
+
     void run() override
     {
         testCurrentLedgerToLimits(true);
@@ -445,6 +500,7 @@ public:
         testMarkerFollow();
         testLedgerHeader();
         testLedgerType();
+        testStreamed();
     }
 };
 
@@ -198,6 +198,32 @@ class LedgerRPC_test : public beast::unit_test::suite
         BEAST_EXPECT(jrr[jss::ledger][jss::accountState].size() == 2u);
     }
 
+    void testLedgerStreamed()
+    {
+        testcase("Ledger Request, Streamed");
+        using namespace test::jtx;
+
+        Env env {*this};
+        Account const alice {"alice"};
+        env.fund(XRP(10000), alice);
+        env.close();
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = env.closed()->info().seq;
+        jvParams[jss::full] = true;
+
+        // The JSON-RPC client speaks HTTP/1.1, so the reply is written
+        // as it is produced using chunked transfer encoding. The command
+        // line client speaks HTTP/1.0 and gets the buffered reply.
+        auto const streamed =
+            env.client().invoke("ledger", jvParams)[jss::result];
+        auto const buffered =
+            env.rpc("json", "ledger", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(streamed[jss::status] == "success");
+        BEAST_EXPECT(streamed[jss::ledger][jss::transactions].size() != 0);
+        BEAST_EXPECT(streamed == buffered);
+    }
+
     void testLedgerFullNonAdmin()
     {
         testcase("Ledger Request, Full Option Without Admin");
@@ -1509,6 +1535,7 @@ public:
         testLedgerCurrent();
         testMissingLedgerEntryLedgerHash();
         testLedgerFull();
+        testLedgerStreamed();
         testLedgerFullNonAdmin();
         testLedgerAccounts();
         testLedgerEntryAccountRoot();
@@ -18,6 +18,7 @@
 #include <ripple/app/main/LoadManager.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/StringUtilities.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/protocol/JsonFields.h>
 #include <test/jtx/WSClient.h>
@@ -288,6 +289,106 @@ public:
         BEAST_EXPECT(jv[jss::status] == "success");
     }
 
+    void testStateDiffs()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        auto wsc = makeWSClient(env.app().config());
+        Json::Value stream;
+
+        {
+            // RPC subscribe to state diffs stream
+            stream[jss::streams] = Json::arrayValue;
+            stream[jss::streams].append("state_diffs");
+            auto jv = wsc->invoke("subscribe", stream);
+            if (wsc->version() == 2)
+            {
+                BEAST_EXPECT(jv.isMember(jss::jsonrpc) && jv[jss::jsonrpc] == "2.0");
+                BEAST_EXPECT(jv.isMember(jss::ripplerpc) && jv[jss::ripplerpc] == "2.0");
+                BEAST_EXPECT(jv.isMember(jss::id) && jv[jss::id] == 5);
+            }
+            BEAST_EXPECT(jv[jss::status] == "success");
+        }
+
+        Account const alice {"alice"};
+        auto const aliceIndex = to_string (keylet::account (alice).key);
+
+        auto hasIndex = [](Json::Value const& entries,
+            std::string const& index)
+        {
+            for (auto const& entry : entries)
+            {
+                if ((entry.isObject() ? entry[jss::index] : entry) == index)
+                    return true;
+            }
+            return false;
+        };
+
+        {
+            // Created and modified entries carry their new contents
+            env.fund(XRP(10000), alice);
+            env.close();
+
+            BEAST_EXPECT(wsc->findMsg(5s,
+                [&](auto const& jv)
+                {
+                    if (jv[jss::type] != "ledgerStateDiff" ||
+                            jv[jss::ledger_index] != 3)
+                        return false;
+                    for (auto const& entry : jv[jss::state])
+                    {
+                        if (entry[jss::index] != aliceIndex)
+                            continue;
+                        auto const data = strUnHex (entry[jss::data].asString());
+                        if (! data.second)
+                            return false;
+                        SerialIter sit (makeSlice (data.first));
+                        STLedgerEntry const sle (sit, keylet::account (alice).key);
+                        return sle.getAccountID (sfAccount) == alice.id();
+                    }
+                    return false;
+                }));
+        }
+
+        {
+            // Deleted entries are listed by index
+            auto const offerIndex = to_string (
+                keylet::offer (alice, env.seq (alice)).key);
+            env(offer(alice, XRP(10), alice["USD"](1)));
+            env.close();
+
+            BEAST_EXPECT(wsc->findMsg(5s,
+                [&](auto const& jv)
+                {
+                    return jv[jss::type] == "ledgerStateDiff" &&
+                        hasIndex (jv[jss::state], offerIndex) &&
+                        hasIndex (jv[jss::state], aliceIndex);
+                }));
+
+            env(offer_cancel(alice, env.seq (alice) - 1));
+            env.close();
+
+            BEAST_EXPECT(wsc->findMsg(5s,
+                [&](auto const& jv)
+                {
+                    return jv[jss::type] == "ledgerStateDiff" &&
+                        hasIndex (jv[jss::deleted], offerIndex) &&
+                        ! hasIndex (jv[jss::state], offerIndex);
+                }));
+        }
+
+        // RPC unsubscribe
+        auto jv = wsc->invoke("unsubscribe", stream);
+        if (wsc->version() == 2)
+        {
+            BEAST_EXPECT(jv.isMember(jss::jsonrpc) && jv[jss::jsonrpc] == "2.0");
+            BEAST_EXPECT(jv.isMember(jss::ripplerpc) && jv[jss::ripplerpc] == "2.0");
+            BEAST_EXPECT(jv.isMember(jss::id) && jv[jss::id] == 5);
+        }
+        BEAST_EXPECT(jv[jss::status] == "success");
+    }
+
     void testManifests()
     {
         using namespace jtx;
@@ -656,6 +757,7 @@ public:
         testServer();
         testLedger();
         testTransactions();
+        testStateDiffs();
         testManifests();
         testValidations();
         testSubErrors(true);
@@ -21,6 +21,7 @@
 #include <ripple/beast/rfc2616.h>
 #include <ripple/server/Server.h>
 #include <ripple/server/Session.h>
+#include <ripple/server/impl/JSONRPCUtil.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/ConfigSections.h>
 #include <test/jtx.h>
@@ -539,12 +540,59 @@ public:
             != std::string::npos);
     }
 
+    void
+    testChunkedReply()
+    {
+        testcase ("Chunked reply");
+
+        auto const endsWith = [](std::string const& s, std::string const& e)
+        {
+            return s.size() >= e.size() &&
+                s.compare (s.size() - e.size(), e.size(), e) == 0;
+        };
+
+        {
+            std::string sent;
+            Json::Output const output =
+                [&sent](boost::beast::string_view const& b)
+                {
+                    sent.append (b.data(), b.size());
+                };
+            HTTPChunkedReply reply (200, output, 4);
+            reply.write ("{\"a\":1}");
+            reply.finish ();
+            BEAST_EXPECT (reply.size() == 7);
+            BEAST_EXPECT (endsWith (sent, "\r\n\r\n7\r\n{\"a\":1}\r\n0\r\n\r\n"));
+        }
+
+        {
+            // An aborted reply sends nothing more, not even what was
+            // buffered, and has no terminating chunk.
+            std::string sent;
+            Json::Output const output =
+                [&sent](boost::beast::string_view const& b)
+                {
+                    sent.append (b.data(), b.size());
+                };
+            HTTPChunkedReply reply (200, output, 8);
+            reply.write ("{\"a\":[1,2,");
+            auto const before = sent;
+            reply.write ("3");
+            reply.abort ();
+            reply.write ("]}");
+            reply.finish ();
+            BEAST_EXPECT (endsWith (before, "\r\na\r\n{\"a\":[1,2,\r\n"));
+            BEAST_EXPECT (sent == before);
+        }
+    }
+
     void
     run() override
     {
         basicTests();
         stressTest();
         testBadConfig();
+        testChunkedReply();
     }
 };
 
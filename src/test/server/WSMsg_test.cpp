@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/net/InfoSub.h>
+#include <ripple/rpc/impl/WSInfoSub.h>
+#include <ripple/server/WSSession.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class WSMsg_test : public beast::unit_test::suite
+{
+    // A session which keeps the messages sent to it.
+    class TestSession : public WSSession
+    {
+        Port port_;
+        http_request_type request_;
+        boost::asio::ip::tcp::endpoint endpoint_;
+
+    public:
+        std::vector<std::shared_ptr<WSMsg>> sent;
+
+        void
+        run() override
+        {
+        }
+
+        Port const&
+        port() const override
+        {
+            return port_;
+        }
+
+        http_request_type const&
+        request() const override
+        {
+            return request_;
+        }
+
+        boost::asio::ip::tcp::endpoint const&
+        remote_endpoint() const override
+        {
+            return endpoint_;
+        }
+
+        void
+        send(std::shared_ptr<WSMsg> w) override
+        {
+            sent.push_back(std::move(w));
+        }
+
+        void
+        close() override
+        {
+        }
+
+        void
+        complete() override
+        {
+        }
+    };
+
+    // Reads a message the way a session does, at most `bytes` at a time.
+    // Checks that every buffer points into `text` rather than a copy.
+    std::string
+    drain(WSMsg& m, std::size_t bytes, std::string const& text)
+    {
+        std::string result;
+        for (;;)
+        {
+            auto const p = m.prepare(bytes, []{});
+            std::size_t n = 0;
+            for (auto const& b : p.second)
+            {
+                auto const data = boost::asio::buffer_cast<char const*>(b);
+                auto const size = boost::asio::buffer_size(b);
+                BEAST_EXPECT(data == text.data() + result.size());
+                result.append(data, size);
+                n += size;
+            }
+            BEAST_EXPECT(n <= bytes);
+            if (p.first)
+                break;
+            if (! BEAST_EXPECT(n != 0 && ! boost::indeterminate(p.first)))
+                break;
+        }
+        return result;
+    }
+
+    void
+    testSharedWSMsg()
+    {
+        testcase("SharedWSMsg");
+
+        auto const text = std::make_shared<std::string const>(
+            "{\"type\":\"ledgerClosed\",\"ledger_index\":123456,"
+            "\"ledger_hash\":\"0123456789ABCDEF0123456789ABCDEF\"}");
+        auto const size = text->size();
+
+        // Chunks smaller than, equal to and larger than the text, and
+        // sizes which do and do not divide it.
+        for (std::size_t bytes : {std::size_t{1}, std::size_t{7},
+            size / 2, size - 1, size, size + 1, 4 * size})
+        {
+            SharedWSMsg m(text);
+            BEAST_EXPECT(drain(m, bytes, *text) == *text);
+        }
+
+        // Two messages over the same text keep their own positions.
+        {
+            SharedWSMsg a(text);
+            SharedWSMsg b(text);
+
+            auto const pa = a.prepare(10, []{});
+            auto const pb = b.prepare(3, []{});
+            BEAST_EXPECT(! pa.first && ! pb.first);
+            BEAST_EXPECT(boost::asio::buffer_size(pa.second) == 10);
+            BEAST_EXPECT(boost::asio::buffer_size(pb.second) == 3);
+
+            auto const pb2 = b.prepare(3, []{});
+            BEAST_EXPECT(boost::asio::buffer_cast<char const*>(
+                pb2.second[0]) == text->data() + 3);
+
+            auto const pa2 = a.prepare(size, []{});
+            BEAST_EXPECT(pa2.first);
+            BEAST_EXPECT(boost::asio::buffer_size(pa2.second) == size - 10);
+            BEAST_EXPECT(boost::asio::buffer_cast<char const*>(
+                pa2.second[0]) == text->data() + 10);
+        }
+
+        // An empty text is complete at once.
+        {
+            auto const empty = std::make_shared<std::string const>();
+            SharedWSMsg m(empty);
+            auto const p = m.prepare(16, []{});
+            BEAST_EXPECT(p.first);
+            BEAST_EXPECT(p.second.empty());
+        }
+    }
+
+    void
+    testMessage()
+    {
+        testcase("InfoSub::Message");
+
+        Json::Value jv(Json::objectValue);
+        jv[jss::type] = "ledgerClosed";
+        jv[jss::ledger_index] = 123456;
+        jv[jss::validated_ledgers] = "32570-123456";
+
+        InfoSub::Message const msg(jv);
+        BEAST_EXPECT(msg.json() == jv);
+
+        // The text is rendered once and then shared.
+        auto const text = msg.text();
+        BEAST_EXPECT(text);
+        BEAST_EXPECT(msg.text() == text);
+
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(*text, parsed));
+        BEAST_EXPECT(parsed == jv);
+        BEAST_EXPECT(text->find('\n') == std::string::npos);
+    }
+
+    void
+    testSharedAcrossSessions()
+    {
+        testcase("Shared across sessions");
+
+        using namespace jtx;
+        Env env(*this);
+
+        std::vector<std::shared_ptr<TestSession>> sessions;
+        std::vector<std::shared_ptr<WSInfoSub>> subs;
+        for (int i = 0; i < 3; ++i)
+        {
+            sessions.push_back(std::make_shared<TestSession>());
+            subs.push_back(std::make_shared<WSInfoSub>(
+                env.app().getOPs(), sessions.back()));
+        }
+
+        Json::Value jv(Json::objectValue);
+        jv[jss::type] = "ledgerClosed";
+        jv[jss::ledger_index] = 123456;
+
+        InfoSub::Message const msg(jv);
+        for (auto const& sub : subs)
+            sub->send(msg, true);
+
+        // Every session writes from the one rendering.
+        auto const& text = *msg.text();
+        for (auto const& session : sessions)
+        {
+            if (! BEAST_EXPECT(session->sent.size() == 1))
+                continue;
+            BEAST_EXPECT(drain(*session->sent[0], 5, text) == text);
+        }
+        BEAST_EXPECT(msg.text().use_count() ==
+            static_cast<long>(1 + sessions.size()));
+
+        // A Json::Value is still rendered for each session.
+        subs[0]->send(jv, true);
+        if (BEAST_EXPECT(sessions[0]->sent.size() == 2))
+        {
+            auto const p = sessions[0]->sent[1]->prepare(4096, []{});
+            std::string s;
+            for (auto const& b : p.second)
+            {
+                s.append(boost::asio::buffer_cast<char const*>(b),
+                    boost::asio::buffer_size(b));
+            }
+            BEAST_EXPECT(s == text);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testSharedWSMsg();
+        testMessage();
+        testSharedAcrossSessions();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(WSMsg, server, ripple);
+
+} // test
+} // ripple
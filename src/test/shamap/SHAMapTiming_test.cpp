@@ -0,0 +1,247 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2019 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/shamap/SHAMap.h>
+#include <ripple/shamap/SHAMapItem.h>
+#include <ripple/basics/random.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/core/JobQueue.h>
+#include <test/jtx.h>
+#include <test/shamap/common.h>
+#include <test/unit_test/SuiteJournal.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace tests {
+
+/*
+Measure read throughput of a shared, immutable SHAMap as the number of
+reader threads increases. Every descent through an inner node publishes
+or reads a child pointer, so this exercises the child locking that parallel
+tree walks (getMissingNodes, visitNodes, fetch packs, ledger_data) rely on.
+
+Also measure how long flushing a state map with N modified leaves takes at
+ledger close, hashing and writing on one thread or across the job queue.
+*/
+
+class SHAMapTiming_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr numItems = 100000;
+    static std::size_t constexpr lookupsPerThread = 500000;
+
+    std::vector<uint256> keys_;
+
+    std::shared_ptr<SHAMap>
+    buildMap (Family& f, SHAMap::version v)
+    {
+        beast::xor_shift_engine eng (19207813);
+        SHAMap map (SHAMapType::FREE, f, v);
+        map.setUnbacked ();
+
+        keys_.clear ();
+        keys_.reserve (numItems);
+        for (std::size_t i = 0; i < numItems; ++i)
+        {
+            Serializer s;
+            for (int d = 0; d < 3; ++d)
+                s.add32 (rand_int<std::uint32_t>(eng));
+            keys_.push_back (s.getSHA512Half ());
+            map.addItem (SHAMapItem{keys_.back (), s.peekData ()},
+                false, false);
+        }
+
+        return map.snapShot (false);
+    }
+
+    template <class Body>
+    std::chrono::milliseconds
+    timeThreads (std::size_t threads, Body&& body)
+    {
+        using namespace std::chrono;
+
+        std::vector<std::thread> workers;
+        workers.reserve (threads);
+
+        auto const start = steady_clock::now ();
+        for (std::size_t t = 0; t < threads; ++t)
+            workers.emplace_back (body, t);
+        for (auto& w : workers)
+            w.join ();
+        return duration_cast<milliseconds> (steady_clock::now () - start);
+    }
+
+    void
+    testLookups (SHAMap const& map, std::size_t threads)
+    {
+        std::atomic<std::size_t> found {0};
+
+        auto const elapsed = timeThreads (threads,
+            [this, &map, &found](std::size_t t)
+            {
+                beast::xor_shift_engine eng (t + 1);
+                std::size_t hits = 0;
+                for (std::size_t i = 0; i < lookupsPerThread; ++i)
+                {
+                    auto const& key = keys_[rand_int (eng, keys_.size () - 1)];
+                    if (map.hasItem (key))
+                        ++hits;
+                }
+                found += hits;
+            });
+
+        BEAST_EXPECT(found == threads * lookupsPerThread);
+
+        auto const ops = threads * lookupsPerThread;
+        log << "    lookups, " << threads << " threads: " <<
+            elapsed.count () << " ms, " <<
+            (ops * 1000) / std::max<std::int64_t> (1, elapsed.count ()) <<
+            " lookups/s" << std::endl;
+    }
+
+    void
+    testWalks (SHAMap const& map, std::size_t threads)
+    {
+        std::atomic<std::size_t> visited {0};
+
+        auto const elapsed = timeThreads (threads,
+            [&map, &visited](std::size_t)
+            {
+                std::size_t leaves = 0;
+                map.visitLeaves (
+                    [&leaves](std::shared_ptr<SHAMapItem const> const&)
+                    {
+                        ++leaves;
+                    });
+                visited += leaves;
+            });
+
+        BEAST_EXPECT(visited == threads * numItems);
+
+        log << "    full walks, " << threads << " threads: " <<
+            elapsed.count () << " ms, " <<
+            (visited * 1000) / std::max<std::int64_t> (1, elapsed.count ()) <<
+            " leaves/s" << std::endl;
+    }
+
+    void
+    testFlush (test::jtx::Env& env, Family& f, SHAMap::version v,
+        std::size_t modified)
+    {
+        using namespace std::chrono;
+
+        // A closed ledger holding numItems entries
+        beast::xor_shift_engine eng (40961);
+        auto base = std::make_shared<SHAMap> (SHAMapType::STATE, f, v);
+        std::vector<uint256> keys;
+        keys.reserve (numItems);
+        for (std::size_t i = 0; i < numItems; ++i)
+        {
+            Serializer s;
+            for (int d = 0; d < 3; ++d)
+                s.add32 (rand_int<std::uint32_t>(eng));
+            keys.push_back (s.getSHA512Half ());
+            base->addItem (SHAMapItem{keys.back (), s.peekData ()},
+                false, false);
+        }
+        base->flushDirty (hotACCOUNT_NODE, 1);
+        base = base->snapShot (false);
+
+        for (bool const parallel : {false, true})
+        {
+            // The next ledger modifies some of its entries and adds others
+            auto map = base->snapShot (true);
+            beast::xor_shift_engine meng (modified);
+            for (std::size_t i = 0; i < modified; ++i)
+            {
+                Serializer s;
+                for (int d = 0; d < 3; ++d)
+                    s.add32 (rand_int<std::uint32_t>(meng));
+                if (i % 2 == 0)
+                {
+                    auto const& key = keys[rand_int (meng, keys.size () - 1)];
+                    map->updateGiveItem (std::make_shared<SHAMapItem const> (
+                        key, s.peekData ()), false, false);
+                }
+                else
+                {
+                    map->addItem (SHAMapItem{s.getSHA512Half (),
+                        s.peekData ()}, false, false);
+                }
+            }
+
+            auto const start = steady_clock::now ();
+            int const flushed = parallel ?
+                map->flushDirty (hotACCOUNT_NODE, 2, env.app().getJobQueue()) :
+                map->flushDirty (hotACCOUNT_NODE, 2);
+            auto const elapsed = duration_cast<milliseconds> (
+                steady_clock::now () - start);
+
+            BEAST_EXPECT(flushed > 0);
+            log << "    flush " << modified << " modified leaves, " <<
+                (parallel ? "parallel: " : "serial: ") <<
+                elapsed.count () << " ms, " <<
+                flushed << " nodes" << std::endl;
+        }
+    }
+
+public:
+    void run () override
+    {
+        test::SuiteJournal journal ("SHAMapTiming_test", *this);
+
+        auto const maxThreads = std::max (
+            1u, std::thread::hardware_concurrency ());
+
+        for (auto const v : {SHAMap::version{1}, SHAMap::version{2}})
+        {
+            testcase (v == SHAMap::version{1} ?
+                "concurrent reads v1" : "concurrent reads v2");
+
+            tests::TestFamily f (journal);
+            auto const map = buildMap (f, v);
+
+            for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+            {
+                testLookups (*map, threads);
+                testWalks (*map, threads);
+            }
+        }
+
+        test::jtx::Env env {*this};
+        for (auto const v : {SHAMap::version{1}, SHAMap::version{2}})
+        {
+            testcase (v == SHAMap::version{1} ?
+                "close-time flush v1" : "close-time flush v2");
+
+            tests::TestFamily f (journal);
+            for (std::size_t modified : {1000, 10000, 50000})
+                testFlush (env, f, v, modified);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SHAMapTiming,ripple_app,ripple);
+
+} // tests
+} // ripple
@@ -20,8 +20,12 @@
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/basics/Blob.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/random.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/core/JobQueue.h>
+#include <test/jtx.h>
 #include <test/shamap/common.h>
 #include <test/unit_test/SuiteJournal.h>
 
@@ -127,6 +131,174 @@ public:
         run (false, SHAMap::version{1}, journal);
         run (true,  SHAMap::version{2}, journal);
         run (false, SHAMap::version{2}, journal);
+
+        testParallelFlush (SHAMap::version{1}, journal);
+        testParallelFlush (SHAMap::version{2}, journal);
+
+        testInnerNode (journal);
+    }
+
+    void testInnerNode (beast::Journal const& journal)
+    {
+        testcase ("inner node branches");
+
+        beast::xor_shift_engine eng (31337);
+        auto makeLeaf = [&eng]()
+        {
+            Serializer s;
+            for (int d = 0; d < 3; ++d)
+                s.add32 (rand_int<std::uint32_t>(eng));
+            return std::make_shared<SHAMapTreeNode>(
+                std::make_shared<SHAMapItem const>(
+                    s.getSHA512Half (), s.peekData ()),
+                SHAMapTreeNode::tnACCOUNT_STATE, 1);
+        };
+
+        auto const node = std::make_shared<SHAMapInnerNode>(1);
+        std::array<std::shared_ptr<SHAMapAbstractNode>, 16> expected;
+
+        auto check = [&]()
+        {
+            int count = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                BEAST_EXPECT(node->isEmptyBranch (i) == !expected[i]);
+                BEAST_EXPECT(node->getChild (i) == expected[i]);
+                if (expected[i])
+                    ++count;
+            }
+            BEAST_EXPECT(node->getBranchCount () == count);
+        };
+
+        // Add and remove branches in every order the storage
+        // must grow, shift and shrink for
+        for (int round = 0; round < 500; ++round)
+        {
+            int const branch = rand_int (eng, 15);
+            if (expected[branch] && (rand_int (eng, 1) == 0))
+            {
+                node->setChild (branch, nullptr);
+                expected[branch].reset ();
+            }
+            else
+            {
+                expected[branch] = makeLeaf ();
+                node->setChild (branch, expected[branch]);
+            }
+            check ();
+        }
+
+        // A node round trips through both formats, sparse and full
+        auto roundTrip = [&]()
+        {
+            node->updateHashDeep ();
+            for (int i = 0; i < 16; ++i)
+            {
+                if (expected[i])
+                    BEAST_EXPECT(node->getChildHash (i) ==
+                        expected[i]->getNodeHash ());
+                else
+                    BEAST_EXPECT(node->getChildHash (i).isZero ());
+            }
+
+            for (auto const format : {snfPREFIX, snfWIRE})
+            {
+                Serializer s;
+                node->addRaw (s, format);
+                auto const made = std::static_pointer_cast<SHAMapInnerNode>(
+                    SHAMapAbstractNode::make (s.slice (), 0, format,
+                        SHAMapHash{}, false, journal));
+                BEAST_EXPECT(made->getNodeHash () == node->getNodeHash ());
+                BEAST_EXPECT(made->getBranchCount () ==
+                    node->getBranchCount ());
+                for (int i = 0; i < 16; ++i)
+                    BEAST_EXPECT(made->getChildHash (i) ==
+                        node->getChildHash (i));
+            }
+
+            auto const copy = std::static_pointer_cast<SHAMapInnerNode>(
+                node->clone (2));
+            for (int i = 0; i < 16; ++i)
+            {
+                BEAST_EXPECT(copy->getChild (i) == expected[i]);
+                BEAST_EXPECT(copy->getChildHash (i) ==
+                    node->getChildHash (i));
+            }
+        };
+
+        for (int i : {3, 9})
+        {
+            if (! expected[i])
+            {
+                expected[i] = makeLeaf ();
+                node->setChild (i, expected[i]);
+            }
+        }
+        roundTrip ();
+
+        for (int i = 0; i < 16; ++i)
+        {
+            expected[i] = makeLeaf ();
+            node->setChild (i, expected[i]);
+        }
+        check ();
+        roundTrip ();
+    }
+
+    void testParallelFlush (SHAMap::version v, beast::Journal const& journal)
+    {
+        testcase (v == SHAMap::version{1} ?
+            "parallel flush v1" : "parallel flush v2");
+
+        test::jtx::Env env {*this};
+        auto& jobQueue = env.app().getJobQueue();
+
+        tests::TestFamily serialFamily {journal};
+        tests::TestFamily parallelFamily {journal};
+        SHAMap serial {SHAMapType::FREE, serialFamily, v};
+        SHAMap parallel {SHAMapType::FREE, parallelFamily, v};
+
+        beast::xor_shift_engine eng (8675309);
+        auto addItems = [&](std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Serializer s;
+                for (int d = 0; d < 3; ++d)
+                    s.add32 (rand_int<std::uint32_t>(eng));
+                auto const key = s.getSHA512Half ();
+                serial.addItem (SHAMapItem{key, s.peekData ()}, false, false);
+                parallel.addItem (SHAMapItem{key, s.peekData ()}, false, false);
+            }
+        };
+
+        // A fresh map, where every node is dirty, then a modified one,
+        // where only the paths to the new leaves are
+        for (auto const count : {5000, 300})
+        {
+            addItems (count);
+
+            int const serialFlushed =
+                serial.flushDirty (hotACCOUNT_NODE, 1);
+            int const parallelFlushed =
+                parallel.flushDirty (hotACCOUNT_NODE, 1, jobQueue);
+
+            BEAST_EXPECT(serialFlushed == parallelFlushed);
+            BEAST_EXPECT(serial.getHash () == parallel.getHash ());
+            parallel.invariants ();
+
+            // Every node of the flushed map reached the node store
+            std::size_t missing = 0;
+            parallel.visitNodes (
+                [&](SHAMapAbstractNode& node)
+                {
+                    if (! parallelFamily.db().fetch (
+                            node.getNodeHash ().as_uint256 (), 0))
+                        ++missing;
+                    return true;
+                });
+            BEAST_EXPECT(missing == 0);
+        }
     }
 
     void run (bool backed, SHAMap::version v, beast::Journal const& journal)
@@ -18,6 +18,7 @@
 */
 //==============================================================================
 
+#include <test/app/AccountTxIndex_test.cpp>
 #include <test/app/AccountTxPaging_test.cpp>
 #include <test/app/AmendmentTable_test.cpp>
 #include <test/app/Check_test.cpp>
@@ -32,11 +33,13 @@
 #include <test/app/LedgerHistory_test.cpp>
 #include <test/app/LedgerLoad_test.cpp>
 #include <test/app/LedgerReplay_test.cpp>
+#include <test/app/LedgerSave_test.cpp>
 #include <test/app/LoadFeeTrack_test.cpp>
 #include <test/app/Manifest_test.cpp>
 #include <test/app/MultiSign_test.cpp>
 #include <test/app/OfferStream_test.cpp>
 #include <test/app/Offer_test.cpp>
+#include <test/app/OrderBookDB_test.cpp>
 #include <test/app/OversizeMeta_test.cpp>
 
 #include <test/unit_test/multi_runner.cpp>
@@ -19,5 +19,6 @@
 //==============================================================================
 
 #include <test/overlay/cluster_test.cpp>
+#include <test/overlay/compression_test.cpp>
 #include <test/overlay/short_read_test.cpp>
 #include <test/overlay/TMHello_test.cpp>
\ No newline at end of file
@@ -20,4 +20,5 @@
 
 #include <test/shamap/FetchPack_test.cpp>
 #include <test/shamap/SHAMapSync_test.cpp>
-#include <test/shamap/SHAMap_test.cpp>
\ No newline at end of file
+#include <test/shamap/SHAMap_test.cpp>
+#include <test/shamap/SHAMapTiming_test.cpp>
\ No newline at end of file